@@ -18,4 +18,9 @@ void app_shutdown(void);
 bool app_should_quit(void);
 // Returns true after the user has requested exit via input.
 
+int app_run_headless(const Params *params);
+// Runs params->headless.ticks fixed-step ticks without platform/render/UI,
+// honouring event stream and snapshot options, then logs a run summary
+// (throughput and memory budget). Returns a process exit code.
+
 #endif  // APP_H
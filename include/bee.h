@@ -100,6 +100,9 @@ typedef struct BeeDecisionOutput {
 } BeeDecisionOutput;
 
 BeeRole bee_pick_role(float age_days, uint64_t *rng_state);
+BeeRole bee_role_for_roll(float age_days, float roll);
+// Same age bands as bee_pick_role with a pre-drawn roll in [0, 1), for
+// callers that batch their random numbers.
 
 void bee_decide_next_action(const BeeDecisionContext *ctx, BeeDecisionOutput *out);
 
@@ -0,0 +1,52 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sim.h"
+
+// Pause-free checkpoints. On POSIX the sim thread forks at a tick boundary and
+// the child writes the copy-on-write image of SimState as a .beesnap file while
+// the parent keeps ticking; the sim only pays for fork() itself. Without fork
+// (Windows) the snapshot is written synchronously instead.
+
+#define CHECKPOINT_MAX_CONCURRENT 8
+#define CHECKPOINT_PATH_CAP 1024
+
+typedef struct CheckpointSlot {
+    bool active;
+    long pid;
+    uint64_t tick;
+    uint64_t start_ns;
+    char path[CHECKPOINT_PATH_CAP];
+} CheckpointSlot;
+
+typedef struct CheckpointManager {
+    CheckpointSlot slots[CHECKPOINT_MAX_CONCURRENT];
+    int max_concurrent;
+    uint64_t started;
+    uint64_t completed;
+    uint64_t failed;
+    uint64_t skipped;
+} CheckpointManager;
+
+void checkpoint_manager_init(CheckpointManager *manager, int max_concurrent);
+// Clears all slots; max_concurrent is clamped to [1, CHECKPOINT_MAX_CONCURRENT].
+
+bool checkpoint_request(CheckpointManager *manager, const SimState *state, const char *path_prefix);
+// Starts a checkpoint of the current tick to "<path_prefix>_<tick>.beesnap".
+// When max_concurrent children are still writing, the request is skipped
+// (counted and logged) rather than blocking the simulation; returns false.
+
+void checkpoint_poll(CheckpointManager *manager);
+// Reaps finished children without blocking and logs their outcome. Call once
+// per frame or tick.
+
+int checkpoint_active_count(const CheckpointManager *manager);
+// Returns the number of children still writing.
+
+void checkpoint_manager_shutdown(CheckpointManager *manager);
+// Blocks until every outstanding child has exited, then logs totals.
+
+#endif  // CHECKPOINT_H
@@ -0,0 +1,104 @@
+#ifndef EVENT_STREAM_H
+#define EVENT_STREAM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Binary colony event stream. A file is one BeeEventFileHeader followed by
+// fixed-size BeeEventRecord entries, written as the host's native structs;
+// event_stream_open refuses big-endian hosts so files are always
+// little-endian. Records from different producers are written in chunk
+// order, so ticks are not globally sorted; sort by (tick, bee) when exact
+// ordering matters.
+
+#define BEE_EVENT_MAGIC "BEEEVT1"
+#define BEE_EVENT_VERSION 1u
+
+typedef enum BeeEventType {
+    BEE_EVENT_MODE = 0,     // prev/next = BeeMode, value = seconds spent in prev mode.
+    BEE_EVENT_TARGET = 1,   // patch_id = new target, value = previous target id.
+    BEE_EVENT_HARVEST = 2,  // value = uL harvested this tick from patch_id.
+    BEE_EVENT_UNLOAD = 3,   // value = uL unloaded this tick.
+    BEE_EVENT_ROLE = 4,     // prev/next = BeeRole.
+    BEE_EVENT_TYPE_COUNT
+} BeeEventType;
+
+#define BEE_EVENT_BIT(type) (1u << (uint32_t)(type))
+#define BEE_EVENT_MASK_ALL ((1u << (uint32_t)BEE_EVENT_TYPE_COUNT) - 1u)
+
+typedef struct BeeEventFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t mask;
+    uint32_t reserved;
+    double tick_dt_sec;
+    uint64_t seed;
+} BeeEventFileHeader;
+
+typedef struct BeeEventRecord {
+    uint64_t tick;
+    uint32_t bee;
+    uint8_t type;
+    uint8_t prev;
+    uint8_t next;
+    uint8_t role;
+    int32_t patch_id;
+    float value;
+    float x;
+    float y;
+} BeeEventRecord;
+
+typedef struct EventStream EventStream;
+
+typedef struct EventProducer {
+    BeeEventRecord *cursor;
+    BeeEventRecord *end;
+    EventStream *stream;
+    size_t index;
+} EventProducer;  // Single-threaded append handle; one per worker thread.
+
+static inline const char *bee_event_type_name(uint32_t type) {
+    switch (type) {
+        case BEE_EVENT_MODE: return "mode";
+        case BEE_EVENT_TARGET: return "target";
+        case BEE_EVENT_HARVEST: return "harvest";
+        case BEE_EVENT_UNLOAD: return "unload";
+        case BEE_EVENT_ROLE: return "role";
+        default: return "unknown";
+    }
+}
+
+EventStream *event_stream_open(const char *path,
+                               uint32_t mask,
+                               size_t producer_count,
+                               double tick_dt_sec,
+                               uint64_t seed);
+// Creates the file, writes the header and starts the background writer thread.
+// seed goes into the header; pass sim_seed() so it reproduces the run even
+// when the params seed was 0. Returns NULL on failure. All buffers are
+// allocated here; appends never allocate.
+
+void event_stream_close(EventStream *stream);
+// Flushes every producer, joins the writer and closes the file; safe on null.
+// No producer may be appending concurrently.
+
+uint32_t event_stream_mask(const EventStream *stream);
+// Returns the enabled event type mask, or 0 for a null stream.
+
+EventProducer *event_stream_producer(EventStream *stream, size_t index);
+// Returns the append handle for a producer slot, or NULL when out of range.
+
+void event_producer_submit(EventProducer *producer);
+// Hands the current chunk to the writer thread and acquires an empty one.
+// Blocks only while every spare chunk is still queued for writing.
+
+static inline void event_producer_push(EventProducer *producer, const BeeEventRecord *record) {
+    if (producer->cursor == producer->end) {
+        event_producer_submit(producer);
+    }
+    *producer->cursor++ = *record;
+}
+
+#endif  // EVENT_STREAM_H
@@ -0,0 +1,39 @@
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "params.h"
+#include "util/mem_report.h"
+
+// Background writer for windowed frame capture (videos and timelapses).
+// Frames are copied into a fixed set of preallocated slots on the render
+// thread and written by worker threads, either as numbered files
+// PREFIX_<frame>.png|ppm|rgba or as a raw RGBA8 stream into an external
+// encoder's stdin, e.g.
+//   ffmpeg -f rawvideo -pix_fmt rgba -s WxH -r 60 -i - out.mp4
+// When every slot is busy a frame is dropped and counted rather than
+// stalling the frame loop. Writers never allocate: slot buffers and image
+// scratch are sized on the render thread.
+
+typedef struct FrameCapture FrameCapture;
+
+FrameCapture *frame_capture_open(const Params *params, int width, int height);
+// Starts the writers for params->capture (files or pipe) with buffers sized
+// for width x height frames. Returns NULL (logged) on failure.
+
+bool frame_capture_push(FrameCapture *capture, const uint8_t *rgba_bottom_up, int width, int height,
+                        uint64_t frame_id);
+// Copies one frame (rows bottom to top, as GL reads them) into a free slot
+// and queues it; false when it was dropped. A larger frame first waits for
+// queued frames and regrows the buffers; a pipe keeps the first frame's size
+// and drops others. Safe on null.
+
+void frame_capture_memory_report(const FrameCapture *capture, MemReport *report);
+
+void frame_capture_close(FrameCapture *capture);
+// Writes every queued frame, joins the writers, closes the pipe and logs the
+// written/dropped counts; safe on null.
+
+#endif  // FRAME_CAPTURE_H
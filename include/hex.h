@@ -0,0 +1,160 @@
+#ifndef HEX_H
+#define HEX_H
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Hex world substrate. Pointy-top hexes in axial coordinates (q, r) with the
+// center of tile (0, 0) at the world origin:
+//   x = size * sqrt(3) * (q + r / 2),  y = size * 1.5 * r
+// A HexGrid covers the world rectangle with rows r = 0..rows-1 and, per row,
+// offset columns col = q + floor(r / 2) = 0..cols-1, stored row-major in one
+// flat array, so axial -> index and world -> index are a few flops with no
+// search. Each tile carries occupancy aggregates the sim keeps current
+// incrementally (see hex_grid_move_bee).
+
+#define HEX_MODE_SLOTS 6               // BEE_MODE_IDLE..BEE_MODE_UNLOADING
+#define HEX_NECTAR_UNITS_PER_UL 256    // fixed-point scale of HexTile.nectar_fx
+#define HEX_SQRT3 1.7320508075688772f
+
+typedef struct HexAxial {
+    int32_t q;
+    int32_t r;
+} HexAxial;
+
+typedef struct HexLayout {
+    float size;      // center-to-corner distance in world units
+    float inv_size;
+} HexLayout;
+
+typedef struct HexTile {
+    uint32_t bees_by_mode[HEX_MODE_SLOTS];  // bees on the tile, by BeeMode
+    uint32_t visits;                        // bee entries since reset (wraps at 2^32)
+    int64_t nectar_fx;                      // nectar carried by bees on the tile
+} HexTile;
+
+typedef struct HexGrid {
+    HexLayout layout;
+    int32_t cols;
+    int32_t rows;
+    size_t tile_count;
+    HexTile *tiles;  // rows * cols, row-major
+} HexGrid;
+
+extern const HexAxial g_hex_directions[6];
+// Neighbor offsets, counter-clockwise starting east.
+
+void hex_layout_init(HexLayout *layout, float size);
+
+static inline HexAxial hex_round(float q, float r) {
+    float s = -q - r;
+    float rq = roundf(q);
+    float rr = roundf(r);
+    float rs = roundf(s);
+    float dq = fabsf(rq - q);
+    float dr = fabsf(rr - r);
+    float ds = fabsf(rs - s);
+    if (dq > dr && dq > ds) {
+        rq = -rr - rs;
+    } else if (dr > ds) {
+        rr = -rq - rs;
+    }
+    HexAxial hex = {(int32_t)rq, (int32_t)rr};
+    return hex;
+}
+// Rounds fractional axial coordinates to the containing hex (cube rounding).
+
+static inline HexAxial hex_world_to_axial(const HexLayout *layout, float x, float y) {
+    float q = (HEX_SQRT3 / 3.0f * x - 1.0f / 3.0f * y) * layout->inv_size;
+    float r = (2.0f / 3.0f * y) * layout->inv_size;
+    return hex_round(q, r);
+}
+
+void hex_axial_to_world(const HexLayout *layout, HexAxial hex, float *out_x, float *out_y);
+
+void hex_corners(const HexLayout *layout, HexAxial hex, float out_xy[12]);
+// Six corner points, counter-clockwise starting at the east-north-east corner.
+
+int32_t hex_distance(HexAxial a, HexAxial b);
+HexAxial hex_neighbor(HexAxial hex, int direction);
+
+bool hex_grid_init(HexGrid *grid, float size, float world_w, float world_h);
+// Sizes the grid to cover [0, world_w] x [0, world_h] and allocates zeroed
+// tiles (ALLOC_TAG_SIM). Returns false on invalid arguments or allocation
+// failure, leaving grid empty.
+
+void hex_grid_shutdown(HexGrid *grid);
+// Frees the tiles; safe on an empty or zeroed grid.
+
+void hex_grid_clear(HexGrid *grid);
+// Zeroes every aggregate, visits included.
+
+void hex_grid_tally(HexGrid *grid,
+                    const int32_t *tile,
+                    const uint8_t *mode,
+                    const float *load_uL,
+                    size_t count);
+// Recomputes bee counts and nectar from scratch for count bees whose tile
+// indices are already assigned; visits are left as they are.
+
+static inline int32_t hex_grid_index(const HexGrid *grid, HexAxial hex) {
+    int32_t col = hex.q + (hex.r >> 1);
+    if (hex.r < 0 || hex.r >= grid->rows || col < 0 || col >= grid->cols) {
+        return -1;
+    }
+    return hex.r * grid->cols + col;
+}
+// Flat tile index for an axial coordinate, or -1 outside the grid.
+
+static inline HexAxial hex_grid_axial(const HexGrid *grid, int32_t index) {
+    HexAxial hex;
+    hex.r = index / grid->cols;
+    hex.q = index % grid->cols - (hex.r >> 1);
+    return hex;
+}
+// Inverse of hex_grid_index for a valid index.
+
+static inline int32_t hex_grid_tile_at(const HexGrid *grid, float x, float y) {
+    HexAxial hex = hex_world_to_axial(&grid->layout, x, y);
+    int32_t row = hex.r;
+    int32_t col = hex.q + (row >> 1);
+    // Only rounding ties exactly on the world border can land outside.
+    row = row < 0 ? 0 : (row >= grid->rows ? grid->rows - 1 : row);
+    col = col < 0 ? 0 : (col >= grid->cols ? grid->cols - 1 : col);
+    return row * grid->cols + col;
+}
+// Tile index containing a world point; points outside the world clamp to the
+// nearest border tile. Requires a non-empty grid.
+
+static inline int64_t hex_nectar_fixed(float load_uL) {
+    return load_uL > 0.0f ? (int64_t)(load_uL * (float)HEX_NECTAR_UNITS_PER_UL + 0.5f) : 0;
+}
+
+static inline void hex_grid_move_bee(HexGrid *grid,
+                                     int32_t from_tile,
+                                     int32_t to_tile,
+                                     uint8_t from_mode,
+                                     uint8_t to_mode,
+                                     int64_t from_nectar_fx,
+                                     int64_t to_nectar_fx) {
+    HexTile *from = &grid->tiles[from_tile];
+    HexTile *to = &grid->tiles[to_tile];
+    if (from_mode < HEX_MODE_SLOTS) {
+        from->bees_by_mode[from_mode] -= 1u;
+    }
+    if (to_mode < HEX_MODE_SLOTS) {
+        to->bees_by_mode[to_mode] += 1u;
+    }
+    from->nectar_fx -= from_nectar_fx;
+    to->nectar_fx += to_nectar_fx;
+    to->visits += (from_tile != to_tile) ? 1u : 0u;
+}
+// Moves one bee's contribution between tiles (which may be the same tile).
+// Nectar uses hex_nectar_fixed so repeated updates never drift.
+
+uint32_t hex_tile_bee_count(const HexTile *tile);
+float hex_tile_nectar_uL(const HexTile *tile);
+
+#endif  // HEX_H
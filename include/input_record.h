@@ -0,0 +1,72 @@
+#ifndef INPUT_RECORD_H
+#define INPUT_RECORD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "params.h"
+#include "platform.h"
+
+// Per-frame Input/Timing recording and replay for repeatable whole-app
+// benchmarks. A recording is one InputRecordHeader followed by one
+// InputFrameRecord per app_frame, little-endian, written as-is:
+//   InputRecordHeader | InputFrameRecord[frame_count]
+// Input bools are packed into key_bits in Input declaration order (bit 0 =
+// quit_requested), except that keys added later take the next free bit.
+// The header keeps the seed, colony size, window size and fixed dt so a
+// replay can warn when it runs against different settings.
+
+#define INPUT_RECORD_MAGIC "BEEINPUT"
+#define INPUT_RECORD_VERSION 1u
+
+typedef struct InputRecordHeader {
+    char magic[8];          // INPUT_RECORD_MAGIC, not NUL-terminated
+    uint32_t version;       // INPUT_RECORD_VERSION
+    uint32_t frame_size;    // sizeof(InputFrameRecord)
+    uint64_t rng_seed;
+    uint64_t bee_count;
+    int32_t window_width_px;
+    int32_t window_height_px;
+    float sim_fixed_dt;
+    uint32_t reserved;
+} InputRecordHeader;
+
+typedef struct InputFrameRecord {
+    uint32_t key_bits;
+    int32_t wheel_y;
+    float mouse_x_px;
+    float mouse_y_px;
+    float mouse_dx_px;
+    float mouse_dy_px;
+    float dt_sec;
+    uint32_t reserved;
+    double now_sec;
+} InputFrameRecord;
+
+typedef struct InputRecorder InputRecorder;
+typedef struct InputReplay InputReplay;
+
+InputRecorder *input_recorder_open(const char *path, const Params *params);
+// Creates path and writes the header. Returns NULL (logged) on failure.
+
+void input_recorder_write(InputRecorder *recorder, const Input *input, const Timing *timing);
+// Appends one frame through a stdio buffer; no allocation. Safe on null.
+
+void input_recorder_close(InputRecorder *recorder);
+// Flushes, logs the frame count and frees; safe on null.
+
+InputReplay *input_replay_open(const char *path, const Params *params, float fixed_dt);
+// Loads the whole recording (ALLOC_TAG_IO). fixed_dt > 0 replaces every
+// recorded dt (now_sec then advances by fixed_dt per frame). Warns when the
+// header's seed, colony or window differ from params. NULL on failure.
+
+bool input_replay_next(InputReplay *replay, Input *out_input, Timing *out_timing);
+// Fills the next recorded frame; false once every frame has been returned.
+
+size_t input_replay_frame_count(const InputReplay *replay);
+
+void input_replay_close(InputReplay *replay);
+// Safe on null.
+
+#endif  // INPUT_RECORD_H
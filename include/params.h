@@ -10,17 +10,29 @@
 // window title non-empty, sensible render/sim defaults. No runtime state or
 // pointers live here; keep it pure configuration data.
 #define PARAMS_MAX_TITLE_CHARS 128
+#define PARAMS_MAX_PATH_CHARS 260
+#define PARAMS_MAX_COMMAND_CHARS 512
+// Largest accepted colony; the traffic fold cadence (SIM_TRAFFIC_FOLD_TICKS)
+// is sized so per-cell uint32 counts cannot overflow below it.
+#define PARAMS_MAX_BEE_COUNT 16000000u
 
 typedef enum SpawnVelocityMode {
     SPAWN_VELOCITY_UNIFORM_DIR = 0,
     SPAWN_VELOCITY_GAUSSIAN_DIR = 1,
 } SpawnVelocityMode;
 
+typedef enum CaptureFormat {
+    CAPTURE_FORMAT_PNG = 0,
+    CAPTURE_FORMAT_PPM = 1,
+    CAPTURE_FORMAT_RAW = 2,  // bare RGBA8 rows, top to bottom
+} CaptureFormat;
+
 typedef struct Params {
     int window_width_px;
     int window_height_px;
     char window_title[PARAMS_MAX_TITLE_CHARS];
     bool vsync_on;
+    int frame_limit_fps;  // 0 = uncapped; otherwise sleep until each frame deadline
     float clear_color_rgba[4];
     float bee_radius_px;
     float bee_color_rgba[4];
@@ -60,6 +72,71 @@ typedef struct Params {
         float seek_accel;
         float arrive_tol_world;
     } bee;
+
+    struct {
+        float tile_size_px;  // hex center-to-corner distance in world units
+    } hex;
+
+    struct {
+        char path[PARAMS_MAX_PATH_CHARS];  // empty disables the event stream
+        uint32_t mask;                     // BEE_EVENT_BIT() set of enabled types
+    } events;
+
+    struct {
+        char path_prefix[PARAMS_MAX_PATH_CHARS];  // empty disables snapshots
+        uint32_t every_ticks;                     // 0 = single snapshot at exit
+    } snapshot;
+
+    struct {
+        char path_prefix[PARAMS_MAX_PATH_CHARS];  // empty disables checkpoints
+        uint32_t every_ticks;
+        int max_concurrent;                       // forked writers in flight
+    } checkpoint;
+
+    struct {
+        char path[PARAMS_MAX_PATH_CHARS];  // non-empty records a trace from startup
+    } trace;
+
+    struct {
+        int threads;       // job pool size including the main thread; 0 = all CPUs
+        bool pin_threads;  // pin worker i to logical CPU i
+    } jobs;
+
+    struct {
+        uint64_t ticks;  // > 0 runs the sim without a window for this many ticks
+    } headless;
+
+    struct {
+        char path_prefix[PARAMS_MAX_PATH_CHARS];  // empty disables headless frame output
+        uint32_t every_ticks;                     // 0 = single frame at exit
+        int width;                                // 0 = window size
+        int height;
+        bool ppm;                                 // PPM instead of PNG
+    } frames;
+
+    struct {
+        char record_path[PARAMS_MAX_PATH_CHARS];  // non-empty records per-frame Input/Timing
+        char replay_path[PARAMS_MAX_PATH_CHARS];  // non-empty replays a recording instead of live input
+        float replay_dt;                          // > 0 replaces the recorded frame dt
+    } input;
+
+    struct {
+        char path_prefix[PARAMS_MAX_PATH_CHARS];      // non-empty writes window frames as numbered files
+        char pipe_command[PARAMS_MAX_COMMAND_CHARS];  // non-empty streams raw RGBA frames to its stdin
+        uint32_t every_frames;                        // capture one frame in N (timelapse); 1 = all
+        int format;                                   // CaptureFormat of path_prefix files
+    } capture;
+
+    struct {
+        char dir[PARAMS_MAX_PATH_CHARS];  // non-empty keeps linked shader program binaries here
+    } shader_cache;
+
+    struct {
+        float cell_world;                          // heatmap cell edge in world units; 0 disables it
+        float decay_sec;                           // sim seconds for the live map to fall to 1/e; 0 = never
+        char export_prefix[PARAMS_MAX_PATH_CHARS];  // non-empty writes cumulative counts and a PNG
+        uint32_t export_every_ticks;               // 0 = single export at exit
+    } traffic;
 } Params;
 
 void params_init_defaults(Params *params);
@@ -69,6 +146,19 @@ bool params_validate(const Params *params, char *err_buf, size_t err_cap);
 // Returns true when Params obey invariants; err_buf receives a short
 // human-readable message on failure.
 
+bool params_apply_cli(Params *params, int argc, char **argv,
+                      char *err_buf, size_t err_cap);
+// Applies command-line overrides (--bees N, --seed N, --headless TICKS,
+// --events PATH, --events-mask LIST, --snapshot PREFIX, --snapshot-every TICKS,
+// --checkpoint PREFIX, --checkpoint-every TICKS, --checkpoint-max N,
+// --trace PATH, --jobs N, --pin-threads, --frames PREFIX, --frames-every TICKS,
+// --frames-size WxH, --frames-ppm, --record-input PATH, --replay-input PATH,
+// --replay-dt SEC, --capture PREFIX, --capture-pipe CMD, --capture-every N,
+// --capture-format png|ppm|raw, --shader-cache DIR, --traffic-cell WORLD,
+// --traffic-decay SEC, --traffic-export PREFIX, --traffic-export-every TICKS,
+// --no-vsync, --fps N).
+// Returns false on unknown options or malformed values; err_buf says which.
+
 bool params_load_from_json(const char *path, Params *out_params,
                            char *err_buf, size_t err_cap);
 // Placeholder for future JSON loader. Returns false while unimplemented.
@@ -27,6 +27,11 @@ typedef struct Input {
     bool key_s_down;
     bool key_d_down;
     bool key_reset_pressed;
+    bool key_m_pressed;  // memory overlay toggle
+    bool key_f9_pressed;  // trace capture start/stop
+    bool key_c_pressed;  // chart overlay toggle
+    bool key_p_pressed;  // bee path overlay toggle
+    bool key_h_pressed;  // traffic heatmap toggle
     float mouse_x_px;
     float mouse_y_px;
     float mouse_dx_px;
@@ -59,6 +64,13 @@ void plat_swap(Platform *plat);
 void plat_shutdown(Platform *plat);
 // Tears down the GL context and window; idempotent.
 
+void plat_wait_events(Platform *plat, int timeout_ms);
+// Blocks until an OS event is queued or timeout_ms elapses, leaving the event
+// for the next plat_pump. Used to idle without rendering.
+
+bool plat_window_minimized(const Platform *plat);
+// True while the window is minimized or hidden.
+
 bool plat_poll_resize(Platform *plat, int *out_fb_w, int *out_fb_h);
 // Returns true when the drawable framebuffer size changed since last check.
 
@@ -6,6 +6,8 @@
 #include <stdint.h>
 
 #include "params.h"
+#include "util/jobs.h"
+#include "util/mem_report.h"
 
 typedef struct Render {
     void *state;
@@ -27,14 +29,37 @@ typedef struct RenderView {
     const float *patch_ring_radii_px;
     const uint32_t *patch_ring_rgba;
     size_t patch_count;
+    const float *hive_walls_xy;          // (start,end) world points, 4 floats per wall.
+    const uint32_t *hive_wall_rgba;      // One color per wall (0xRRGGBBAA).
+    size_t hive_wall_count;
+    const float *path_waypoint_x;        // Per-bee next waypoint (world), path_count entries.
+    const float *path_waypoint_y;
+    const float *path_target_x;          // Per-bee final target (world).
+    const float *path_target_y;
+    const uint8_t *path_valid;           // Nonzero when the bee has a planned route.
+    const uint8_t *path_has_waypoint;    // Nonzero when the route detours via the waypoint.
+    size_t path_count;                   // 0 hides the path overlay; otherwise equals count.
+    const uint8_t *traffic_intensity;    // Heatmap cells 0-255, row-major from world (0, 0); null hides it.
+    int traffic_cols;
+    int traffic_rows;
+    float traffic_cell_world;            // Cell edge in world units.
+    uint64_t traffic_version;            // Changes whenever traffic_intensity does.
     const float *debug_lines_xy;         // Sequence of (start,end) points, 4 floats per line.
     const uint32_t *debug_line_rgba;     // One color per line (0xRRGGBBAA).
     size_t debug_line_count;
 } RenderView;
 
+typedef void (*RenderCaptureFn)(void *user, const uint8_t *rgba, int width, int height, uint64_t frame_id);
+// rgba is RGBA8, rows bottom to top (GL order), tightly packed; it is only
+// valid during the call.
+
 bool render_init(Render *out, const Params *params);
 // Prepares render subsystem for drawing; Params already applied to platform.
 
+bool render_init_with_jobs(Render *out, const Params *params, JobPool *jobs);
+// As render_init, but bee instances are packed across jobs in disjoint
+// ranges. jobs may be null; it must outlive the renderer.
+
 void render_resize(Render *render, int fb_w, int fb_h);
 // Notifies render subsystem that the framebuffer size changed.
 
@@ -46,7 +71,38 @@ void render_set_clear_color(Render *render, const float rgba[4]);
 
 void render_frame(Render *render, const RenderView *view);
 // Issues draw commands for the current frame using the provided view; must not
-// swap buffers.
+// swap buffers. Bee instances persist on the GPU between frames and only
+// blocks holding a bee that moved (by a tenth of a pixel or more), resized
+// or changed color are re-sent. Patches and hive walls form a static layer
+// cached in an offscreen texture; it is redrawn only when the camera,
+// framebuffer size, clear color, patch or wall geometry change, or a
+// patch's stock ring moves noticeably. Other frames copy the layer and draw
+// only bees and debug lines. With path_count set, every bee's route is
+// drawn under the bees as instanced segments (bee to waypoint, waypoint to
+// target, or bee straight to target), culled to the view and rebuilt each
+// frame on the job pool. The traffic heatmap is a single-channel texture
+// stretched over the world under paths and bees, re-uploaded only when
+// traffic_version changes.
+
+bool render_capture_read(Render *render, uint64_t frame_id);
+// Starts an asynchronous readback of the framebuffer into the next pixel
+// buffer of a small ring, fenced; call after the last draw of a frame and
+// before the swap. Never waits on the GPU: returns false (frame skipped)
+// while every buffer is still in flight.
+
+size_t render_capture_collect(Render *render, RenderCaptureFn fn, void *user, bool wait);
+// Maps finished readbacks oldest first and hands each to fn. Without wait it
+// stops at the first readback whose fence has not signalled, so a frame is
+// typically delivered one or two frames after it was read; with wait it
+// drains the ring (for shutdown). Returns the frames delivered.
+
+void render_memory_report(const Render *render, MemReport *report);
+// Appends CPU staging and GPU buffer sizes for instances, debug lines, the
+// path overlay, the static layer, the traffic texture and capture readback
+// buffers.
+
+uint64_t render_instance_upload_bytes(const Render *render);
+// Bee instance bytes sent to the GPU since render_init.
 
 void render_shutdown(Render *render);
 // Releases GPU resources; safe to call once after render_init succeeds.
@@ -0,0 +1,38 @@
+#ifndef SHADER_CACHE_H
+#define SHADER_CACHE_H
+
+#include <stdint.h>
+
+// Builds the GL programs used by the renderer and the UI. With a cache
+// directory set, linked programs are saved with glGetProgramBinary and
+// later launches load them with glProgramBinary instead of compiling and
+// linking. There is one file per program name, DIR/<name>.bin:
+//   ShaderCacheHeader | driver binary[binary_size]
+// The header keys the entry by a hash of both sources and the GL vendor,
+// renderer and version strings. If the key does not match, the file is
+// short, or the driver rejects the binary, the program is compiled from
+// source and the entry is rewritten. Call only from the thread that owns
+// the GL context.
+
+#define SHADER_CACHE_MAGIC "BEESHADR"
+#define SHADER_CACHE_VERSION 1u
+
+typedef struct ShaderCacheHeader {
+    char magic[8];           // SHADER_CACHE_MAGIC, not NUL-terminated
+    uint32_t version;        // SHADER_CACHE_VERSION
+    uint32_t binary_format;  // GLenum from glGetProgramBinary
+    uint64_t key;            // FNV-1a of the sources and GL strings
+    uint32_t binary_size;
+    uint32_t reserved;
+} ShaderCacheHeader;
+
+void shader_cache_set_dir(const char *dir);
+// NULL or "" disables the cache (the default). The directory is created
+// when the first entry is stored.
+
+unsigned int shader_program_build(const char *name, const char *vs_src, const char *fs_src);
+// Returns a linked program, or 0 after logging the compile or link error.
+// name labels log lines and is the cache file name, so it must be unique per
+// program and safe in a path.
+
+#endif  // SHADER_CACHE_H
@@ -6,11 +6,56 @@
 #include <stdint.h>
 
 #include "bee.h"
+#include "event_stream.h"
+#include "hex.h"
 #include "params.h"
 #include "render.h"
+#include "util/jobs.h"
+#include "util/mem_report.h"
+#include "util/series.h"
 
 typedef struct SimState SimState;
 
+typedef struct SimStats {
+    uint64_t tick;                // sim_tick_index() after the tick described (0 before any tick)
+    uint64_t path_plans;          // bee_path_plan calls past the arrival early-out
+    uint64_t path_los_hits;       // plans satisfied by the direct line-of-sight fast path
+    uint64_t path_probe_rays;     // fan-out probe directions tested when line of sight failed
+    uint64_t hive_segment_tests;  // disc-vs-wall segment tests in hive_resolve_disc
+    uint64_t hive_collisions;     // segment contacts actually resolved
+    uint64_t hive_resolve_iters;  // resolve passes run (at most hive_max_iters per bee)
+    uint64_t patch_choices;       // plants_choose_patch calls
+    uint64_t mode_transitions;    // bees whose BeeMode changed this tick
+    uint64_t wall_bounces;        // world-edge reflections (also summed into the 1 s log)
+} SimStats;
+
+typedef struct SimQuantiles {
+    float p50;
+    float p90;
+    float p99;
+    float mean;
+    float max;
+} SimQuantiles;
+
+typedef struct SimTripSummary {
+    uint64_t trips;           // completed trips attributed to the patch
+    uint64_t abandoned;       // trips that went idle before heading home
+    SimQuantiles duration_sec;
+    SimQuantiles distance_world;
+    SimQuantiles nectar_uL;   // load carried home
+    SimQuantiles energy;      // energy on arrival home (0-1)
+} SimTripSummary;
+
+typedef enum SimMetric {
+    SIM_METRIC_FORAGERS_OUT = 0,  // bees outbound, foraging or returning
+    SIM_METRIC_HIVE_NECTAR,       // nectar unloaded in the hive since reset, uL
+    SIM_METRIC_PATCH_STOCK,       // nectar left on all patches, uL
+    SIM_METRIC_TICK_MS,           // wall time of sim_tick, ms
+    SIM_METRIC_COUNT
+} SimMetric;
+
+#define SIM_METRIC_PERIOD_SEC 1.0  // sim seconds per level-0 series point
+
 typedef struct SimInit {
     const Params *params;      // Optional external params pointer.
     size_t capacity_override;  // Future: allow manual capacity specification.
@@ -20,13 +65,24 @@ bool sim_init(SimState **out_state, const Params *params);
 // Allocates and initializes the simulation buffers using Params. Returns false
 // on allocation failure or invalid arguments, leaving *out_state untouched.
 
+bool sim_init_with_jobs(SimState **out_state, const Params *params, JobPool *jobs);
+// As sim_init, but colony setup (and later sim_reset) is spread across jobs
+// in fixed chunks; the result is identical for any thread count. jobs may be
+// null; it must outlive the state.
+
 void sim_tick(SimState *state, float dt_sec);
 // Advances the simulation by dt_sec seconds. No allocations occur here.
 
 RenderView sim_build_view(SimState *state);
 // Builds a renderable view over the simulation buffers. Updates cached
 // patch visualization data; pointers remain valid until the next call to
-// sim_tick or sim_reset.
+// sim_tick or sim_reset. The traffic heatmap is left out (null).
+
+void sim_traffic_view(SimState *state, RenderView *view);
+// Adds the traffic heatmap to view, folding and log-normalizing the grid
+// first when the tick advanced since the last call. That pass covers every
+// cell, so call it only while the layer is shown. No-op when the heatmap is
+// disabled.
 
 void sim_reset(SimState *state, uint64_t seed);
 // Reinitializes the simulation deterministically from the given seed.
@@ -44,4 +100,57 @@ size_t sim_find_bee_near(const SimState *state, float world_x, float world_y, fl
 bool sim_get_bee_info(const SimState *state, size_t index, BeeDebugInfo *out_info);
 // Populates BeeDebugInfo for the given index; returns false if out of range.
 
+uint64_t sim_tick_index(const SimState *state);
+// Returns the number of ticks advanced since init/reset (0 for null).
+
+uint64_t sim_seed(const SimState *state);
+// Returns the seed the colony was built from, after a zero --seed has been
+// replaced by the default (0 for null).
+
+bool sim_get_stats(const SimState *state, SimStats *out_stats);
+// Copies the work counters gathered during the most recent sim_tick.
+// Returns false for null arguments.
+
+size_t sim_patch_count(const SimState *state);
+// Returns the number of flower patches (0 for null).
+
+bool sim_get_trip_summary(const SimState *state, size_t patch_index, SimTripSummary *out_summary);
+// Summarizes every foraging trip closed so far for one patch from its
+// streaming quantile sketches (about 2% relative error). Cheap enough to call
+// every frame; returns false for null arguments or an out-of-range patch.
+
+const HexGrid *sim_hex_grid(const SimState *state);
+// Hex tile substrate covering the world (null for null). Tile aggregates
+// reflect the most recent sim_tick, sim_reset or sim_apply_runtime_params;
+// the pointer stays valid until sim_shutdown.
+
+const char *sim_metric_name(SimMetric metric);
+// Upper-case display name, e.g. "FORAGERS OUT".
+
+const TimeSeries *sim_metric_series(const SimState *state, SimMetric metric);
+// Per-tick history of one colony metric (null for null or out of range).
+// Series are cleared by sim_reset and hold a fixed number of points however
+// long the sim runs (see util/series.h).
+
+bool sim_write_snapshot(const SimState *state, const char *path);
+// Writes every per-bee SoA array as a columnar .beesnap file (layout in
+// snapshot.h). Arrays are written straight from memory; no per-row formatting.
+
+bool sim_write_tick_snapshot(const SimState *state, const char *path_prefix);
+// Convenience wrapper writing "<path_prefix>_<tick>.beesnap".
+
+bool sim_write_traffic(SimState *state, const char *path_prefix);
+// Writes the cumulative traffic counts as "<path_prefix>_<tick>.beetraffic"
+// (layout in traffic.h) plus a log-scaled grayscale "<path_prefix>_<tick>.png".
+// Folds pending visits first. False (logged) when the heatmap is disabled or
+// a write fails.
+
+void sim_memory_report(const SimState *state, MemReport *report);
+// Appends one entry per SoA array (per-bee), the patch tables and the fixed
+// SimState block. Sets report->bee_count to the simulation capacity.
+
+void sim_set_event_stream(SimState *state, EventStream *stream);
+// Attaches (or detaches with NULL) the colony event stream. The stream is not
+// owned by the simulation and must outlive the attachment.
+
 #endif  // SIM_H
@@ -0,0 +1,38 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdint.h>
+
+// Columnar per-bee snapshot file (".beesnap"), written by sim_write_snapshot.
+//
+//   [0, 64)               BeeSnapshotPreamble (little-endian)
+//   [64, 64+schema_bytes) UTF-8 JSON schema, space padded to a 64-byte multiple
+//   ...                   one raw column per SoA array, each 64-byte aligned
+//
+// The schema lists every column as {"name", "dtype", "offset", "bytes"} where
+// dtype is a numpy type string ("<f4", "<u4", "<i4", "<i2", "|u1", "|i1") and
+// offset is absolute in the file. Every column holds bee_count elements, so a
+// reader can np.frombuffer(buf, dtype, bee_count, offset) each one without
+// parsing rows.
+// The schema also carries the scalar state needed to resume a run: tick,
+// sim_time_sec, seed, rng_state and the per-patch nectar stock.
+
+#define BEE_SNAPSHOT_MAGIC "BEESNAP"
+#define BEE_SNAPSHOT_VERSION 1u
+#define BEE_SNAPSHOT_ALIGN 64u
+
+typedef struct BeeSnapshotPreamble {
+    char magic[8];
+    uint32_t version;
+    uint32_t schema_bytes;
+    uint64_t bee_count;
+    uint64_t tick;
+    uint64_t seed;
+    double sim_time_sec;
+    float world_w;
+    float world_h;
+    uint32_t column_count;
+    uint32_t reserved;
+} BeeSnapshotPreamble;
+
+#endif  // SNAPSHOT_H
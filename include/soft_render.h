@@ -0,0 +1,51 @@
+#ifndef SOFT_RENDER_H
+#define SOFT_RENDER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "params.h"
+#include "render.h"
+#include "util/jobs.h"
+#include "util/mem_report.h"
+
+// CPU rasterizer for GPU-less batch runs. Consumes the same RenderView as the
+// GL backend (patch fill discs, patch rings, bees, then debug lines; hive
+// walls, the path overlay and the traffic heatmap are GL-only) and matches its camera transform,
+// 1.5 px smoothstep disc edge and alpha blending. Discs are binned into 64x64 px tiles with a
+// parallel counting sort that keeps draw order, then tiles are shaded
+// independently on the job pool in planar float accumulators
+// (auto-vectorized coverage loops).
+
+typedef struct SoftRender SoftRender;
+
+SoftRender *soft_render_create(const Params *params, int width, int height, JobPool *jobs);
+// Allocates a width x height target (<= 0 uses the window size in Params).
+// jobs may be null; it must outlive the renderer. Returns NULL on failure.
+
+void soft_render_destroy(SoftRender *render);
+// Safe on null.
+
+void soft_render_set_camera(SoftRender *render, const RenderCamera *camera);
+// Same camera as render_set_camera; null resets to the origin at zoom 1.
+
+void soft_render_fit_camera(SoftRender *render, float world_w, float world_h);
+// Centers the world and zooms so it fits the target, like the window's
+// default camera.
+
+void soft_render_set_clear_color(SoftRender *render, const float rgba[4]);
+
+bool soft_render_frame(SoftRender *render, const RenderView *view);
+// Rasterizes view into the target. May grow the tile bin storage (call from
+// the thread that created the pool). Returns false on allocation failure.
+
+const uint8_t *soft_render_pixels(const SoftRender *render, int *out_width, int *out_height);
+// RGBA8, rows top to bottom; valid until the next frame or destroy.
+
+bool soft_render_write(const SoftRender *render, const char *path);
+// Writes the last frame as PNG, or PPM when path ends in ".ppm".
+
+void soft_render_memory_report(const SoftRender *render, MemReport *report);
+
+#endif  // SOFT_RENDER_H
@@ -0,0 +1,37 @@
+#ifndef TRAFFIC_H
+#define TRAFFIC_H
+
+#include <stdint.h>
+
+// Cumulative traffic heatmap file (".beetraffic"), written by
+// sim_write_traffic next to a log-scaled grayscale PNG of the same grid.
+//
+//   [0, 64)   BeeTrafficPreamble (little-endian)
+//   [64, ...) uint64 visit counts, cols * rows, row-major from world (0, 0)
+//
+// A visit is one bee ending one tick inside a cell, so count / tick is the
+// cell's mean occupancy and count * dt the bee-seconds spent there. Cell
+// (c, r) covers world x in [c, c + 1) * cell_world and y in
+// [r, r + 1) * cell_world; the last row and column may reach past the world.
+// Counts never decay and are cleared only by sim_reset, so exports from a
+// long run add up every tick since the start. Read with
+//   np.fromfile(path, "<u8", cols * rows, offset=64).reshape(rows, cols)
+
+#define BEE_TRAFFIC_MAGIC "BEETRAF"
+#define BEE_TRAFFIC_VERSION 1u
+
+typedef struct BeeTrafficPreamble {
+    char magic[8];
+    uint32_t version;
+    uint32_t cols;
+    uint32_t rows;
+    float cell_world;
+    uint64_t tick;
+    uint64_t seed;
+    double sim_time_sec;
+    uint64_t bee_count;
+    float world_w;
+    float world_h;
+} BeeTrafficPreamble;
+
+#endif  // TRAFFIC_H
@@ -7,6 +7,11 @@
 #include "platform.h"
 #include "render.h"
 #include "sim.h"
+#include "util/mem_report.h"
+#include "util/series.h"
+
+#define UI_CHART_BUCKETS 160  // bars per chart; wider windows are min/max-decimated
+#define UI_MAX_CHARTS 4
 
 typedef struct UiActions {
     bool toggle_pause;
@@ -17,6 +22,14 @@ typedef struct UiActions {
     bool focus_queen;
 } UiActions;
 
+typedef struct UiChartData {
+    const char *label;
+    const SeriesPoint *buckets;  // oldest first, as from series_decimate
+    size_t bucket_count;         // buckets holding data
+    size_t slot_count;           // buckets the whole window maps to
+    float latest;
+} UiChartData;
+
 void ui_init(void);
 void ui_shutdown(void);
 void ui_sync_to_params(const Params *baseline, Params *runtime);
@@ -25,7 +38,20 @@ void ui_render(int framebuffer_width, int framebuffer_height);
 bool ui_wants_mouse(void);
 bool ui_wants_keyboard(void);
 void ui_set_viewport(const RenderCamera *camera, int framebuffer_width, int framebuffer_height);
-void ui_enable_hive_overlay(bool enabled);
 void ui_set_selected_bee(const BeeDebugInfo *info, bool valid);
+void ui_toggle_memory_panel(void);
+bool ui_memory_panel_open(void);
+void ui_set_memory_report(const MemReport *report);
+// Copies the report shown by the memory overlay; NULL clears it.
+void ui_memory_report(MemReport *report);
+// Appends the UI command buffers, the retained vertex mirror, its VBO and
+// the glyph atlas.
+void ui_toggle_charts_panel(void);
+bool ui_charts_panel_open(void);
+double ui_chart_window_sec(void);
+// History span the charts overlay shows; clicking the overlay cycles it.
+void ui_set_charts(const UiChartData *charts, size_t count);
+// Copies up to UI_MAX_CHARTS charts (labels and buckets included) for the
+// overlay; count 0 clears it.
 
 #endif  // UI_H
@@ -0,0 +1,148 @@
+#ifndef UTIL_ALLOC_H
+#define UTIL_ALLOC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+// Subsystem allocators. Every heap allocation in the app goes through these so
+// the opt-in tracker (configure with -DBEE_ALLOC_TRACKING=ON) can attribute
+// bytes per subsystem and flag allocations inside a frame or sim tick. With
+// tracking off they compile down to the plain CRT calls.
+
+typedef enum AllocTag {
+    ALLOC_TAG_SIM = 0,
+    ALLOC_TAG_RENDER,
+    ALLOC_TAG_UI,
+    ALLOC_TAG_PLATFORM,
+    ALLOC_TAG_IO,
+    ALLOC_TAG_COUNT
+} AllocTag;
+
+typedef struct AllocTagStats {
+    uint64_t live_bytes;
+    uint64_t peak_bytes;   // high-water mark of live_bytes
+    uint64_t alloc_count;  // lifetime allocations (realloc counts as one)
+} AllocTagStats;
+
+typedef struct AllocStats {
+    AllocTagStats tags[ALLOC_TAG_COUNT];
+    uint64_t frame_allocs;        // last completed frame
+    uint64_t frame_bytes;
+    uint64_t peak_frame_allocs;   // worst single frame so far
+    uint64_t peak_frame_bytes;
+    uint64_t frames_with_allocs;
+    uint64_t tick_allocs;         // lifetime allocations made inside sim_tick
+    uint64_t tick_bytes;
+} AllocStats;
+
+static inline const char *alloc_tag_name(AllocTag tag) {
+    switch (tag) {
+        case ALLOC_TAG_SIM: return "sim";
+        case ALLOC_TAG_RENDER: return "render";
+        case ALLOC_TAG_UI: return "ui";
+        case ALLOC_TAG_PLATFORM: return "platform";
+        case ALLOC_TAG_IO: return "io";
+        default: return "unknown";
+    }
+}
+
+#ifdef BEE_ALLOC_TRACKING
+
+void *mem_alloc(AllocTag tag, size_t bytes);
+void *mem_calloc(AllocTag tag, size_t count, size_t size);
+void *mem_realloc(AllocTag tag, void *ptr, size_t bytes);
+void mem_free(AllocTag tag, void *ptr);
+void *mem_alloc_aligned(AllocTag tag, size_t bytes, size_t align);
+void mem_free_aligned(AllocTag tag, void *ptr);
+// Tracked variants prefix each block with its size/tag. Not thread-safe: only
+// the main thread may allocate through them (worker threads never allocate).
+
+void alloc_frame_begin(void);
+void alloc_frame_end(void);
+// Bracket one app frame; allocations in between count toward frame stats and
+// the first few offending frames are logged.
+
+void alloc_tick_begin(void);
+void alloc_tick_end(void);
+// Bracket sim_tick. Any allocation in between is logged and, in debug builds
+// (NDEBUG unset), trips an assert.
+
+bool alloc_get_stats(AllocStats *out_stats);
+// Copies the current counters; returns false when tracking is compiled out.
+
+void alloc_report(void);
+// Logs per-subsystem live/peak bytes and per-frame high-water marks.
+
+#else
+
+static inline void *mem_alloc(AllocTag tag, size_t bytes) {
+    (void)tag;
+    return malloc(bytes);
+}
+
+static inline void *mem_calloc(AllocTag tag, size_t count, size_t size) {
+    (void)tag;
+    return calloc(count, size);
+}
+
+static inline void *mem_realloc(AllocTag tag, void *ptr, size_t bytes) {
+    (void)tag;
+    return realloc(ptr, bytes);
+}
+
+static inline void mem_free(AllocTag tag, void *ptr) {
+    (void)tag;
+    free(ptr);
+}
+
+static inline void *mem_alloc_aligned(AllocTag tag, size_t bytes, size_t align) {
+    (void)tag;
+    if (bytes == 0) {
+        return NULL;
+    }
+#if defined(_MSC_VER)
+    return _aligned_malloc(bytes, align);
+#else
+    void *ptr = NULL;
+    if (posix_memalign(&ptr, align, bytes) != 0) {
+        return NULL;
+    }
+    return ptr;
+#endif
+}
+
+static inline void mem_free_aligned(AllocTag tag, void *ptr) {
+    (void)tag;
+#if defined(_MSC_VER)
+    if (ptr) {
+        _aligned_free(ptr);
+    }
+#else
+    free(ptr);
+#endif
+}
+
+static inline void alloc_frame_begin(void) {}
+static inline void alloc_frame_end(void) {}
+static inline void alloc_tick_begin(void) {}
+static inline void alloc_tick_end(void) {}
+
+static inline bool alloc_get_stats(AllocStats *out_stats) {
+    if (out_stats) {
+        memset(out_stats, 0, sizeof(*out_stats));
+    }
+    return false;
+}
+
+static inline void alloc_report(void) {}
+
+#endif  // BEE_ALLOC_TRACKING
+
+#endif  // UTIL_ALLOC_H
@@ -0,0 +1,104 @@
+#ifndef UTIL_ATOMIC_H
+#define UTIL_ATOMIC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Minimal 64-bit atomics (GCC/Clang __atomic builtins / MSVC Interlocked
+// intrinsics) so lock-free code does not depend on <stdatomic.h>, which MSVC
+// only ships behind an experimental switch. Operate on plain int64_t fields
+// that are only ever touched through these helpers.
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+
+static inline int64_t atomic_load_i64(const volatile int64_t *p) {
+    return _InterlockedOr64((volatile __int64 *)p, 0);
+}
+
+static inline int64_t atomic_load_relaxed_i64(const volatile int64_t *p) {
+    return *p;
+}
+
+static inline void atomic_store_i64(volatile int64_t *p, int64_t v) {
+    _InterlockedExchange64((volatile __int64 *)p, v);
+}
+
+static inline void atomic_store_relaxed_i64(volatile int64_t *p, int64_t v) {
+    *p = v;
+}
+
+static inline int64_t atomic_fetch_add_i64(volatile int64_t *p, int64_t v) {
+    return _InterlockedExchangeAdd64((volatile __int64 *)p, v);
+}
+
+static inline bool atomic_cas_i64(volatile int64_t *p, int64_t expected, int64_t desired) {
+    return _InterlockedCompareExchange64((volatile __int64 *)p, desired, expected) == expected;
+}
+
+static inline void atomic_fence_seq_cst(void) {
+#if defined(_M_ARM64)
+    __dmb(_ARM64_BARRIER_ISH);
+#else
+    __faststorefence();
+#endif
+}
+
+static inline void atomic_fence_release(void) {
+    _ReadWriteBarrier();
+}
+
+static inline void atomic_cpu_relax(void) {
+#if defined(_M_ARM64)
+    __yield();
+#else
+    _mm_pause();
+#endif
+}
+
+#else
+
+static inline int64_t atomic_load_i64(const volatile int64_t *p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline int64_t atomic_load_relaxed_i64(const volatile int64_t *p) {
+    return __atomic_load_n(p, __ATOMIC_RELAXED);
+}
+
+static inline void atomic_store_i64(volatile int64_t *p, int64_t v) {
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+static inline void atomic_store_relaxed_i64(volatile int64_t *p, int64_t v) {
+    __atomic_store_n(p, v, __ATOMIC_RELAXED);
+}
+
+static inline int64_t atomic_fetch_add_i64(volatile int64_t *p, int64_t v) {
+    return __atomic_fetch_add(p, v, __ATOMIC_ACQ_REL);
+}
+
+static inline bool atomic_cas_i64(volatile int64_t *p, int64_t expected, int64_t desired) {
+    return __atomic_compare_exchange_n(p, &expected, desired, false,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+static inline void atomic_fence_seq_cst(void) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline void atomic_fence_release(void) {
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void atomic_cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+#endif
+
+#endif  // UTIL_ATOMIC_H
@@ -0,0 +1,21 @@
+#ifndef UTIL_CLOCK_H
+#define UTIL_CLOCK_H
+
+#include <stdint.h>
+
+uint64_t clock_now_ns(void);
+// Monotonic timestamp in nanoseconds (QueryPerformanceCounter / CLOCK_MONOTONIC).
+// Only differences are meaningful.
+
+void clock_sleep_until_ns(uint64_t deadline_ns);
+// Blocks the calling thread until clock_now_ns() >= deadline_ns. Sleeps on a
+// high-resolution OS timer (absolute CLOCK_MONOTONIC on POSIX, a
+// high-resolution waitable timer on Windows 10+) and spins only for the
+// final stretch the timer cannot hit reliably. Returns at once for past
+// deadlines. Not thread-safe on Windows (one lazily created timer).
+
+static inline double clock_ns_to_ms(uint64_t ns) {
+    return (double)ns * 1e-6;
+}
+
+#endif  // UTIL_CLOCK_H
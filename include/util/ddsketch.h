@@ -0,0 +1,47 @@
+#ifndef UTIL_DDSKETCH_H
+#define UTIL_DDSKETCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Fixed-memory DDSketch (relative-error quantile sketch). Positive values map
+// to logarithmic bins whose width is set by the relative accuracy; when the
+// value range outgrows DDSKETCH_MAX_BINS the lowest bins are collapsed, so
+// upper quantiles keep their guarantee. Values at or below
+// DDSKETCH_MIN_VALUE (including zero and negatives) share one zero bin.
+// Inserts are O(1) amortized and never allocate; the struct is plain data.
+
+#define DDSKETCH_MAX_BINS 256
+#define DDSKETCH_MIN_VALUE 1e-9
+#define DDSKETCH_DEFAULT_ACCURACY 0.02
+
+typedef struct DDSketch {
+    double gamma;
+    double inv_log_gamma;
+    int32_t bin_offset;  // log index represented by bins[0]
+    uint32_t collapses;  // times the range overflowed; low quantiles are coarse once > 0
+    uint64_t zero_count;
+    uint64_t count;
+    double sum;
+    double min;
+    double max;
+    uint32_t bins[DDSKETCH_MAX_BINS];
+} DDSketch;
+
+void ddsketch_init(DDSketch *sketch, double relative_accuracy);
+// Clears the sketch; relative_accuracy in (0, 1), e.g. 0.02 for +/-2%.
+
+void ddsketch_add(DDSketch *sketch, double value);
+
+double ddsketch_quantile(const DDSketch *sketch, double q);
+// Returns the estimated q-quantile (q in [0, 1]) clamped to [min, max];
+// 0 for an empty sketch.
+
+void ddsketch_merge(DDSketch *dst, const DDSketch *src);
+// Adds every sample of src into dst. Both must share the same accuracy.
+
+static inline double ddsketch_mean(const DDSketch *sketch) {
+    return sketch->count > 0 ? sketch->sum / (double)sketch->count : 0.0;
+}
+
+#endif  // UTIL_DDSKETCH_H
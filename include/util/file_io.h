@@ -0,0 +1,20 @@
+#ifndef UTIL_FILE_IO_H
+#define UTIL_FILE_IO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Unbuffered whole-file writes straight from caller memory. Uses writev on
+// POSIX so large array dumps avoid stdio copies; Windows loops over _write.
+
+typedef struct FileSlice {
+    const void *data;
+    size_t size;
+} FileSlice;
+
+bool file_write_slices(const char *path, const FileSlice *slices, size_t count);
+// Creates/truncates path and writes the slices back to back. Handles partial
+// writes and EINTR. Does not allocate or log, so it is safe to call from a
+// forked child. Returns false on any open/write/close failure.
+
+#endif  // UTIL_FILE_IO_H
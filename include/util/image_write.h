@@ -0,0 +1,49 @@
+#ifndef UTIL_IMAGE_WRITE_H
+#define UTIL_IMAGE_WRITE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Minimal still-image writers for headless and captured frames. Input is
+// RGBA8, rows top to bottom, tightly packed; alpha is dropped (frames are
+// opaque). PNG uses a built-in single-pass deflate (fixed Huffman codes,
+// greedy LZ77 over a 32 KiB window), which is plenty for flat backgrounds
+// with sparse discs and needs no zlib. Both allocate scratch on ALLOC_TAG_IO
+// and log failures.
+
+bool image_write_ppm(const char *path, const uint8_t *rgba, int width, int height);
+// Binary P6.
+
+bool image_write_png(const char *path, const uint8_t *rgba, int width, int height);
+// 8-bit truecolor PNG; each row picks the cheapest of the None/Sub/Up/Paeth
+// filters by sum of absolute residuals.
+
+typedef struct ImageScratch {
+    uint8_t *rgb;
+    uint8_t *raw;    // filtered PNG scanlines
+    uint8_t *rows;   // per-row filter candidates
+    uint8_t *zlib;
+    int32_t *head;   // deflate hash chain heads
+    int width;       // largest frame the buffers fit
+    int height;
+} ImageScratch;  // Zero-initialize; reusable across frames.
+
+bool image_scratch_reserve(ImageScratch *scratch, int width, int height);
+// Grows scratch to fit width x height frames (ALLOC_TAG_IO). Also builds the
+// shared CRC table, so writers using the _scratch variants on other threads
+// never touch lazily initialized state. False (logged) on failure.
+
+void image_scratch_free(ImageScratch *scratch);
+// Releases the buffers and zeroes scratch; safe on null.
+
+size_t image_scratch_bytes(const ImageScratch *scratch);
+
+bool image_write_ppm_scratch(const char *path, const uint8_t *rgba, int width, int height,
+                             ImageScratch *scratch);
+bool image_write_png_scratch(const char *path, const uint8_t *rgba, int width, int height,
+                             ImageScratch *scratch);
+// As above, encoding into reserved scratch instead of allocating, so they
+// can run on writer threads. The frame must fit the reserved size.
+
+#endif  // UTIL_IMAGE_WRITE_H
@@ -0,0 +1,63 @@
+#ifndef UTIL_JOBS_H
+#define UTIL_JOBS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "util/atomic.h"
+
+// Work-stealing job pool. A fixed set of workers (the creating thread is
+// worker 0) each own a Chase-Lev deque of range jobs stored by value, so
+// submitting never allocates. Owners push/pop at the bottom, idle workers
+// steal from the top. Range jobs split lazily: a worker halves its remaining
+// range only while its own deque is empty, which adapts the grain to load.
+//
+// Jobs may be submitted from pool workers only (worker 0 included); other
+// threads, a null pool and full deques all fall back to running inline.
+
+#define JOBS_MAX_THREADS 64
+#define JOBS_DEQUE_CAPACITY 1024
+
+typedef void (*JobFn)(void *user, size_t begin, size_t end);
+// Processes items [begin, end). Runs on any worker; must not block on other jobs.
+
+typedef struct JobCounter {
+    volatile int64_t pending;  // items still outstanding; touch only via jobs_* helpers
+} JobCounter;  // Zero-initialize before first use; reusable once it reaches zero.
+
+typedef struct JobPool JobPool;
+
+JobPool *jobs_create(int thread_count, bool pin_threads);
+// Starts thread_count - 1 workers (thread_count <= 0 uses every logical CPU)
+// and binds the calling thread as worker 0. Worker i > 0 is pinned to CPU i
+// when pin_threads is set. Returns NULL on failure.
+
+void jobs_destroy(JobPool *pool);
+// Stops and joins the workers; safe on null. No jobs may be outstanding.
+
+int jobs_thread_count(const JobPool *pool);
+// Total workers including the creating thread (1 for null).
+
+int jobs_worker_index(void);
+// Index of the calling worker in its pool, or 0 for threads outside a pool,
+// so callers can size per-worker scratch as jobs_thread_count().
+
+void jobs_submit(JobPool *pool, JobFn fn, void *user, JobCounter *counter);
+// Queues fn(user, 0, 1). counter (optional) is incremented now and
+// decremented once the job finishes.
+
+void jobs_parallel_for(JobPool *pool, size_t count, size_t grain, JobFn fn, void *user,
+                       JobCounter *counter);
+// Queues fn over [0, count) in chunks of at least grain items (0 picks a
+// grain from count and the thread count). counter tracks items, not chunks.
+
+void jobs_wait(JobPool *pool, JobCounter *counter);
+// Runs queued jobs on the calling thread until counter reaches zero, so a
+// phase graph is a sequence of submit + wait steps over shared counters.
+
+static inline bool job_counter_done(const JobCounter *counter) {
+    return !counter || atomic_load_i64(&counter->pending) == 0;
+}
+
+#endif  // UTIL_JOBS_H
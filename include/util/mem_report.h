@@ -0,0 +1,54 @@
+#ifndef UTIL_MEM_REPORT_H
+#define UTIL_MEM_REPORT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Fixed-capacity memory budget report. Subsystems append one entry per buffer
+// they own (sim_memory_report, render_memory_report, ui_memory_report); the
+// report itself never allocates so it can be rebuilt while running.
+
+#define MEM_REPORT_MAX_ENTRIES 64
+
+typedef enum MemRegion {
+    MEM_REGION_CPU = 0,
+    MEM_REGION_GPU = 1,
+} MemRegion;
+
+typedef struct MemReportEntry {
+    const char *subsystem;  // static string, e.g. "sim"
+    const char *name;       // static string, e.g. "x"
+    uint64_t bytes;
+    MemRegion region;
+    bool per_bee;           // scales with bee capacity
+} MemReportEntry;
+
+typedef struct MemReport {
+    MemReportEntry entries[MEM_REPORT_MAX_ENTRIES];
+    size_t count;
+    size_t bee_count;
+} MemReport;
+
+void mem_report_reset(MemReport *report, size_t bee_count);
+// Clears entries; bee_count is the divisor used for bytes-per-bee figures.
+
+void mem_report_add(MemReport *report,
+                    const char *subsystem,
+                    const char *name,
+                    uint64_t bytes,
+                    MemRegion region,
+                    bool per_bee);
+// Appends an entry; silently drops it once the report is full.
+
+uint64_t mem_report_total(const MemReport *report, const char *subsystem, MemRegion region);
+// Sums bytes for one subsystem (NULL = all) in the given region.
+
+double mem_report_bytes_per_bee(const MemReport *report, bool per_bee_only);
+// Total CPU+GPU bytes divided by bee_count. With per_bee_only, fixed-size
+// entries are excluded so the result is the marginal cost of one more bee.
+
+void mem_report_log(const MemReport *report);
+// Logs every entry plus per-subsystem and overall totals.
+
+#endif  // UTIL_MEM_REPORT_H
@@ -0,0 +1,43 @@
+#ifndef UTIL_RNG_H
+#define UTIL_RNG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Bulk random number generation. RngLanes runs RNG_LANES independent
+// xorshift64 generators side by side; the fill loops are written lane-major
+// so the compiler keeps every lane in one SIMD register (AVX2: 4 x u64 per
+// half). Gaussians use a 128-layer Marsaglia-Tsang ziggurat whose fast path
+// (~99% of draws) is one table compare and multiply.
+//
+// Streams are deterministic for a given seed and fill sizes, but differ from
+// the scalar xorshift64 helpers in sim_internal.h.
+
+#define RNG_LANES 8
+
+typedef struct RngLanes {
+    uint64_t s[RNG_LANES];
+    uint64_t slow;  // scalar stream for ziggurat tail/rejection draws
+} RngLanes;
+
+void rng_lanes_seed(RngLanes *rng, uint64_t seed);
+// Expands seed into RNG_LANES + 1 decorrelated non-zero states (splitmix64).
+
+void rng_lanes_seed_stream(RngLanes *rng, uint64_t seed, uint64_t stream);
+// Seeds stream number `stream` of a family keyed by seed, so parallel chunks
+// get independent, reproducible lanes regardless of which thread runs them.
+
+void rng_fill_u32(RngLanes *rng, uint32_t *out, size_t n);
+void rng_fill_uniform01(RngLanes *rng, float *out, size_t n);
+// Uniform floats in [0, 1) with 24 bits of resolution.
+
+void rng_fill_range(RngLanes *rng, float *out, size_t n, float lo, float hi);
+// Uniform floats in [lo, hi).
+
+void rng_fill_gaussian(RngLanes *rng, float *out, size_t n, float mean, float stddev);
+// Normal samples via the ziggurat.
+
+float rng_gaussian(uint64_t *state);
+// Scalar ziggurat standard normal driven by a single xorshift64 state.
+
+#endif  // UTIL_RNG_H
@@ -0,0 +1,67 @@
+#ifndef UTIL_SERIES_H
+#define UTIL_SERIES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Fixed-memory multi-resolution time series. Samples are folded into
+// level-0 points of period_sec each (min, max and mean of the samples), and
+// every SERIES_FANOUT closed points of a level fold into one point of the
+// next level. Each level is a SERIES_CAPACITY ring, so with a 1 s period the
+// levels reach back about 17 minutes, 2.3 hours and 18 hours at a fixed
+// ~37 KB per series. Adds are O(1) amortized and never allocate; the struct
+// is plain data.
+
+#define SERIES_CAPACITY 1024  // points per level
+#define SERIES_LEVELS 3
+#define SERIES_FANOUT 8       // level l+1 point = SERIES_FANOUT level-l points
+
+typedef struct SeriesPoint {
+    float min;
+    float max;
+    float mean;
+} SeriesPoint;
+
+typedef struct SeriesAccum {
+    float min;
+    float max;
+    double sum;
+    uint32_t count;
+} SeriesAccum;
+
+typedef struct SeriesLevel {
+    SeriesPoint points[SERIES_CAPACITY];  // ring; head is the next slot written
+    uint32_t head;
+    uint32_t count;
+    SeriesAccum pending;  // samples (level 0) or lower-level points not yet closed
+} SeriesLevel;
+
+typedef struct TimeSeries {
+    double period_sec;   // span of one level-0 point
+    double pending_sec;  // time covered by levels[0].pending
+    float last;          // most recent sample
+    uint64_t samples;
+    SeriesLevel levels[SERIES_LEVELS];
+} TimeSeries;
+
+void series_init(TimeSeries *series, double period_sec);
+// Clears the series; period_sec <= 0 falls back to 1 s.
+
+void series_add(TimeSeries *series, float value, double dt_sec);
+// Adds one sample covering dt_sec. A level-0 point closes each time the
+// covered time reaches period_sec.
+
+size_t series_decimate(const TimeSeries *series,
+                       double window_sec,
+                       SeriesPoint *out,
+                       size_t max_buckets,
+                       size_t *out_slots);
+// Min/max-decimates the newest window_sec of closed points into at most
+// max_buckets buckets, reading from the finest level that covers the
+// window. *out_slots receives the bucket count the whole window maps to;
+// the return value is how many of the newest of those slots hold data
+// (fewer while history is shorter than the window), written oldest first to
+// out[0..n). Reads at most SERIES_CAPACITY points whatever the history
+// length.
+
+#endif  // UTIL_SERIES_H
@@ -0,0 +1,74 @@
+#ifndef UTIL_THREAD_H
+#define UTIL_THREAD_H
+
+#include <stdbool.h>
+
+// Minimal portable threading shim (Win32 threads / pthreads). Objects are
+// plain structs so they can be embedded without extra allocations.
+
+#if defined(_WIN32)
+typedef struct ThreadHandle {
+    void *handle;
+} ThreadHandle;
+
+typedef struct ThreadMutex {
+    void *lock;  // SRWLOCK storage.
+} ThreadMutex;
+
+typedef struct ThreadCond {
+    void *cond;  // CONDITION_VARIABLE storage.
+} ThreadCond;
+#else
+#include <pthread.h>
+
+typedef struct ThreadHandle {
+    pthread_t handle;
+    bool started;
+} ThreadHandle;
+
+typedef struct ThreadMutex {
+    pthread_mutex_t lock;
+} ThreadMutex;
+
+typedef struct ThreadCond {
+    pthread_cond_t cond;
+} ThreadCond;
+#endif
+
+#if defined(_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
+typedef int (*ThreadFn)(void *user);
+
+bool thread_create(ThreadHandle *out_thread, ThreadFn fn, void *user);
+// Starts fn(user) on a new OS thread. Returns false when the thread could not
+// be created; out_thread is left unusable in that case.
+
+void thread_join(ThreadHandle *thread);
+// Blocks until the thread exits and releases its handle; idempotent.
+
+void thread_mutex_init(ThreadMutex *mutex);
+void thread_mutex_destroy(ThreadMutex *mutex);
+void thread_mutex_lock(ThreadMutex *mutex);
+void thread_mutex_unlock(ThreadMutex *mutex);
+
+void thread_cond_init(ThreadCond *cond);
+void thread_cond_destroy(ThreadCond *cond);
+void thread_cond_wait(ThreadCond *cond, ThreadMutex *mutex);
+void thread_cond_signal(ThreadCond *cond);
+void thread_cond_broadcast(ThreadCond *cond);
+
+int thread_cpu_count(void);
+// Returns the number of logical processors available (>= 1).
+
+bool thread_pin_current(int cpu);
+// Restricts the calling thread to one logical processor. Returns false when
+// unsupported or rejected by the OS; the thread keeps running unpinned.
+
+void thread_yield(void);
+// Gives up the rest of the calling thread's time slice.
+
+#endif  // UTIL_THREAD_H
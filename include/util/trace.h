@@ -0,0 +1,62 @@
+#ifndef UTIL_TRACE_H
+#define UTIL_TRACE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Lightweight begin/end scope recorder that dumps Chrome trace_event JSON
+// (load in chrome://tracing or ui.perfetto.dev). Each thread appends to its
+// own preallocated buffer, so recording takes no locks and never allocates.
+// When recording is off every TRACE_* macro is a single predictable branch.
+// A buffer near capacity drops new scopes whole but keeps room to close the
+// ones already open, so every recorded begin has its end.
+
+#define TRACE_MAX_THREADS 16
+#define TRACE_DEFAULT_EVENTS_PER_THREAD (1u << 17)
+
+extern volatile bool g_trace_recording;
+
+bool trace_init(size_t events_per_thread);
+// Allocates the calling thread's buffer and binds it as "main". Call once at
+// startup before any other trace_* function.
+
+void trace_shutdown(void);
+// Releases every buffer. Threads bound to a slot must have exited.
+
+int trace_reserve_thread(const char *name);
+// Allocates a buffer slot for a worker thread (call from the owning/main
+// thread so allocations stay on it). Returns the slot or -1 when full.
+
+void trace_bind_thread(int slot);
+// Called on the worker thread itself to route its events into `slot`.
+
+void trace_start(void);
+// Clears all buffers and begins recording.
+
+void trace_stop(void);
+
+bool trace_dump_json(const char *path);
+// Stops recording and writes every buffered event as Chrome trace JSON.
+// Worker threads still inside a scope may lose their last event; dump after
+// joining them when the tail matters.
+
+void trace_begin(const char *name);
+void trace_end(const char *name);
+// name must be a string literal (or otherwise outlive the dump).
+
+#define TRACE_BEGIN(name)             \
+    do {                              \
+        if (g_trace_recording) {      \
+            trace_begin(name);        \
+        }                             \
+    } while (0)
+
+#define TRACE_END(name)               \
+    do {                              \
+        if (g_trace_recording) {      \
+            trace_end(name);          \
+        }                             \
+    } while (0)
+
+#endif  // UTIL_TRACE_H
@@ -1,19 +1,32 @@
 #include "app.h"
 #include <math.h>
 #include <stddef.h>
+#include <stdio.h>
+#include "checkpoint.h"
+#include "event_stream.h"
+#include "frame_capture.h"
+#include "input_record.h"
 #include "params.h"
 #include "platform.h"
 #include "render.h"
+#include "shader_cache.h"
 #include "sim.h"
 #include "ui.h"
 
+#include "util/alloc.h"
+#include "util/clock.h"
+#include "util/ddsketch.h"
+#include "util/jobs.h"
 #include "util/log.h"
+#include "util/trace.h"
 
 static Platform g_platform = {0};
 static Render g_render = {0};
 static Params g_params = {0};
 static Params g_params_runtime = {0};
 static SimState *g_sim = NULL;
+static EventStream *g_events = NULL;
+static JobPool *g_jobs = NULL;
 static bool g_app_initialized = false;
 static bool g_app_should_quit = false;
 static RenderCamera g_camera = {{0.0f, 0.0f}, 1.0f};
@@ -24,6 +37,21 @@ static int g_fb_height = 0;
 static float g_sim_fixed_dt = 1.0f / 120.0f;
 static const double g_sim_max_accumulator = 0.25;
 static size_t g_selected_bee_index = SIZE_MAX;
+static MemReport g_mem_report;
+static CheckpointManager g_checkpoints;
+static unsigned g_trace_dump_index = 0;
+static InputRecorder *g_input_recorder = NULL;
+static InputReplay *g_input_replay = NULL;
+static DDSketch g_replay_frame_ms;
+static uint64_t g_replay_start_ns = 0;
+static FrameCapture *g_capture = NULL;
+static uint64_t g_capture_frame_counter = 0;
+static uint64_t g_capture_next_id = 0;
+static uint64_t g_capture_skipped = 0;
+static bool g_show_paths = false;
+static bool g_show_traffic = false;
+static uint64_t g_pace_deadline_ns = 0;
+static const int g_idle_wait_ms = 100;
 static float clampf(float v, float lo, float hi) {
     if (v < lo) {
         return lo;
@@ -43,6 +71,120 @@ static void app_reset_camera(void) {
 static void app_recompute_world_defaults(void);
 static bool app_apply_runtime_params(bool reinit_required);
 
+static void app_write_snapshot(void) {
+    if (!g_sim || g_params.snapshot.path_prefix[0] == '\0') {
+        return;
+    }
+    sim_write_tick_snapshot(g_sim, g_params.snapshot.path_prefix);
+}
+
+static void app_write_traffic(void) {
+    if (!g_sim || g_params.traffic.export_prefix[0] == '\0') {
+        return;
+    }
+    sim_write_traffic(g_sim, g_params.traffic.export_prefix);
+}
+
+static void app_build_memory_report(void) {
+    mem_report_reset(&g_mem_report, 0);
+    sim_memory_report(g_sim, &g_mem_report);
+    render_memory_report(&g_render, &g_mem_report);
+    ui_memory_report(&g_mem_report);
+    frame_capture_memory_report(g_capture, &g_mem_report);
+}
+
+static void app_capture_sink(void *user, const uint8_t *rgba, int width, int height, uint64_t frame_id) {
+    frame_capture_push((FrameCapture *)user, rgba, width, height, frame_id);
+}
+
+// Hands finished readbacks to the capture writers, then starts this frame's
+// readback every capture.every_frames frames. Neither step waits on the GPU.
+static void app_capture_frame(void) {
+    render_capture_collect(&g_render, app_capture_sink, g_capture, false);
+    if (g_capture_frame_counter++ % g_params.capture.every_frames != 0) {
+        return;
+    }
+    if (render_capture_read(&g_render, g_capture_next_id)) {
+        g_capture_next_id += 1;
+    } else {
+        g_capture_skipped += 1;
+    }
+}
+
+// Decimates each sim metric over the chart window into fixed buckets; the
+// cost is bounded by SERIES_CAPACITY points per metric whatever the window.
+static void app_update_charts(void) {
+    static SeriesPoint buckets[SIM_METRIC_COUNT][UI_CHART_BUCKETS];
+    UiChartData charts[SIM_METRIC_COUNT];
+    size_t count = 0;
+    double window_sec = ui_chart_window_sec();
+    for (int m = 0; m < SIM_METRIC_COUNT && g_sim; ++m) {
+        const TimeSeries *series = sim_metric_series(g_sim, (SimMetric)m);
+        UiChartData *chart = &charts[count++];
+        chart->label = sim_metric_name((SimMetric)m);
+        chart->buckets = buckets[m];
+        chart->bucket_count = series_decimate(series, window_sec, buckets[m], UI_CHART_BUCKETS,
+                                              &chart->slot_count);
+        chart->latest = series ? series->last : 0.0f;
+    }
+    ui_set_charts(charts, count);
+}
+
+static void app_dump_trace(void) {
+    char path[PARAMS_MAX_PATH_CHARS];
+    if (g_params.trace.path[0] != '\0') {
+        snprintf(path, sizeof path, "%s", g_params.trace.path);
+    } else {
+        snprintf(path, sizeof path, "bee_trace_%u.json", g_trace_dump_index);
+    }
+    g_trace_dump_index += 1;
+    trace_dump_json(path);
+}
+
+static void app_toggle_trace(void) {
+    if (g_trace_recording) {
+        app_dump_trace();
+    } else {
+        trace_start();
+    }
+}
+
+static void app_log_replay_summary(void) {
+    const DDSketch *ms = &g_replay_frame_ms;
+    if (ms->count == 0) {
+        return;
+    }
+    double wall_sec = (double)(clock_now_ns() - g_replay_start_ns) * 1e-9;
+    LOG_INFO("replay: frames=%llu/%zu wall=%.2fs frame_ms p50=%.2f p90=%.2f p99=%.2f p99.9=%.2f "
+             "max=%.2f mean=%.2f",
+             (unsigned long long)ms->count,
+             input_replay_frame_count(g_input_replay),
+             wall_sec,
+             ddsketch_quantile(ms, 0.50),
+             ddsketch_quantile(ms, 0.90),
+             ddsketch_quantile(ms, 0.99),
+             ddsketch_quantile(ms, 0.999),
+             ms->max,
+             ddsketch_mean(ms));
+}
+
+static void app_after_sim_tick(void) {
+    uint64_t tick = sim_tick_index(g_sim);
+    uint32_t every = g_params.snapshot.every_ticks;
+    if (every > 0 && tick % every == 0) {
+        app_write_snapshot();
+    }
+    uint32_t traffic_every = g_params.traffic.export_every_ticks;
+    if (traffic_every > 0 && tick % traffic_every == 0) {
+        app_write_traffic();
+    }
+    uint32_t checkpoint_every = g_params.checkpoint.every_ticks;
+    if (checkpoint_every > 0 && g_params.checkpoint.path_prefix[0] != '\0' &&
+        tick % checkpoint_every == 0) {
+        checkpoint_request(&g_checkpoints, g_sim, g_params.checkpoint.path_prefix);
+    }
+}
+
 static void app_update_camera(const Input *input, float dt_sec) {
     if (!input || g_fb_width <= 0 || g_fb_height <= 0) {
         return;
@@ -137,6 +279,7 @@ static double g_sim_accumulator_sec = 0.0;
 static bool g_sim_paused = false;
 static double g_log_accumulator_sec = 0.0;
 static unsigned g_log_frame_counter = 0;
+static uint64_t g_log_upload_mark = 0;
 static unsigned g_log_tick_counter = 0;
 
 bool app_init(const Params *params) {
@@ -165,6 +308,26 @@ bool app_init(const Params *params) {
         LOG_ERROR("Params validation failed: %s", err);
         return false;
     }
+    if (g_params.input.replay_path[0] != '\0') {
+        g_input_replay = input_replay_open(g_params.input.replay_path, &g_params,
+                                           g_params.input.replay_dt);
+        if (!g_input_replay) {
+            return false;
+        }
+        if (g_params.vsync_on) {
+            LOG_WARN("input_replay: vsync is on, so frame times include display waits (--no-vsync)");
+        }
+        ddsketch_init(&g_replay_frame_ms, DDSKETCH_DEFAULT_ACCURACY);
+    }
+
+    // Buffers are reserved up front so F9 can start a capture at any time.
+    if (trace_init(0) && g_params.trace.path[0] != '\0') {
+        trace_start();
+    }
+    g_jobs = jobs_create(g_params.jobs.threads, g_params.jobs.pin_threads);
+    if (!g_jobs) {
+        LOG_WARN("jobs: pool unavailable; running single-threaded");
+    }
 
     LOG_INFO("=== Bee Hive Boot ===");
     LOG_INFO("Window: %dx%d \"%s\" (vsync %s)",
@@ -192,26 +355,61 @@ bool app_init(const Params *params) {
     if (!plat_init(&g_platform, &g_params)) {
         LOG_ERROR("Platform initialization failed");
         plat_shutdown(&g_platform);
+        jobs_destroy(g_jobs);
+        g_jobs = NULL;
+        input_replay_close(g_input_replay);
+        g_input_replay = NULL;
+        trace_shutdown();
         return false;
     }
 
-    if (!render_init(&g_render, &g_params)) {
+    shader_cache_set_dir(g_params.shader_cache.dir);
+    if (!render_init_with_jobs(&g_render, &g_params, g_jobs)) {
         LOG_ERROR("Render initialization failed");
         plat_shutdown(&g_platform);
+        jobs_destroy(g_jobs);
+        g_jobs = NULL;
+        input_replay_close(g_input_replay);
+        g_input_replay = NULL;
+        trace_shutdown();
         return false;
     }
 
     ui_init();
     ui_sync_to_params(&g_params, &g_params_runtime);
 
-    if (!sim_init(&g_sim, &g_params)) {
+    if (!sim_init_with_jobs(&g_sim, &g_params, g_jobs)) {
         LOG_ERROR("Simulation initialization failed");
         ui_shutdown();
         render_shutdown(&g_render);
         plat_shutdown(&g_platform);
+        jobs_destroy(g_jobs);
+        g_jobs = NULL;
+        input_replay_close(g_input_replay);
+        g_input_replay = NULL;
+        trace_shutdown();
         return false;
     }
     LOG_INFO("app_init: sim ready");
+    checkpoint_manager_init(&g_checkpoints, g_params.checkpoint.max_concurrent);
+
+    if (g_params.events.path[0] != '\0') {
+        g_events = event_stream_open(g_params.events.path,
+                                     g_params.events.mask,
+                                     1,
+                                     (double)g_sim_fixed_dt,
+                                     sim_seed(g_sim));
+        if (!g_events) {
+            LOG_WARN("events: stream disabled");
+        }
+        sim_set_event_stream(g_sim, g_events);
+    }
+    if (g_params.input.record_path[0] != '\0') {
+        g_input_recorder = input_recorder_open(g_params.input.record_path, &g_params);
+        if (!g_input_recorder) {
+            LOG_WARN("input_record: recording disabled");
+        }
+    }
 
     int init_fb_w = g_params.window_width_px;
     int init_fb_h = g_params.window_height_px;
@@ -231,6 +429,13 @@ bool app_init(const Params *params) {
     app_recompute_world_defaults();
     app_reset_camera();
 
+    if (g_params.capture.path_prefix[0] != '\0' || g_params.capture.pipe_command[0] != '\0') {
+        g_capture = frame_capture_open(&g_params, g_fb_width, g_fb_height);
+        if (!g_capture) {
+            LOG_WARN("capture: disabled");
+        }
+    }
+
     g_sim_accumulator_sec = 0.0;
     g_sim_paused = false;
     g_log_accumulator_sec = 0.0;
@@ -260,7 +465,7 @@ static bool app_apply_runtime_params(bool reinit_required) {
 
     if (reinit_required) {
         SimState *fresh = NULL;
-        if (!sim_init(&fresh, &new_params)) {
+        if (!sim_init_with_jobs(&fresh, &new_params, g_jobs)) {
             LOG_ERROR("sim reinit failed; keeping previous simulation");
             g_params_runtime = g_params;
             ui_sync_to_params(&g_params, &g_params_runtime);
@@ -268,6 +473,7 @@ static bool app_apply_runtime_params(bool reinit_required) {
         }
         sim_shutdown(g_sim);
         g_sim = fresh;
+        sim_set_event_stream(g_sim, g_events);
         g_sim_accumulator_sec = 0.0;
     } else if (g_sim) {
         sim_apply_runtime_params(g_sim, &new_params);
@@ -291,18 +497,78 @@ static bool app_apply_runtime_params(bool reinit_required) {
     return true;
 }
 
+static bool app_input_active(const Input *input) {
+    return input->key_space_down || input->key_period_down || input->key_plus_down ||
+           input->key_minus_down || input->key_w_down || input->key_a_down || input->key_s_down ||
+           input->key_d_down || input->mouse_left_down || input->mouse_right_down ||
+           input->wheel_y != 0 || input->mouse_dx_px != 0.0f || input->mouse_dy_px != 0.0f;
+}
+
+// Runs after swap. Paused with no input in flight (or minimized), every frame
+// would be identical, so block on the event queue instead; the timeout keeps
+// checkpoints polled and a minimized sim ticking. Otherwise hold the frame
+// limit by sleeping to the next deadline.
+static void app_pace_frame(const Input *input) {
+    bool idle = plat_window_minimized(&g_platform) || (g_sim_paused && !app_input_active(input));
+    if (idle && !g_input_replay) {
+        TRACE_BEGIN("idle_wait");
+        plat_wait_events(&g_platform, g_idle_wait_ms);
+        TRACE_END("idle_wait");
+        g_pace_deadline_ns = 0;
+        return;
+    }
+    if (g_params.frame_limit_fps <= 0) {
+        return;
+    }
+    uint64_t period_ns = UINT64_C(1000000000) / (uint64_t)g_params.frame_limit_fps;
+    uint64_t now_ns = clock_now_ns();
+    // After a long frame, restart the cadence rather than rushing to catch up.
+    if (g_pace_deadline_ns == 0 || now_ns >= g_pace_deadline_ns + period_ns) {
+        g_pace_deadline_ns = now_ns;
+    }
+    g_pace_deadline_ns += period_ns;
+    TRACE_BEGIN("frame_limit");
+    clock_sleep_until_ns(g_pace_deadline_ns);
+    TRACE_END("frame_limit");
+}
+
 void app_frame(void) {
     if (!g_app_initialized) {
         return;
     }
+    alloc_frame_begin();
+    TRACE_BEGIN("frame");
+    uint64_t frame_start_ns = clock_now_ns();
 
     Input input = (Input){0};
     Timing timing = (Timing){0};
+    bool replay_frame = false;
+    TRACE_BEGIN("pump");
     plat_pump(&g_platform, &input, &timing);
+    if (g_input_replay) {
+        // SDL is still pumped so the window stays responsive and can be closed.
+        bool live_quit = input.quit_requested;
+        replay_frame = input_replay_next(g_input_replay, &input, &timing);
+        if (!replay_frame) {
+            input = (Input){0};
+            timing.dt_sec = 0.0f;
+            g_app_should_quit = true;
+        } else if (g_replay_frame_ms.count == 0) {
+            g_replay_start_ns = frame_start_ns;
+        }
+        input.quit_requested = input.quit_requested || live_quit;
+    }
+    input_recorder_write(g_input_recorder, &input, &timing);
+    TRACE_END("pump");
 
     ui_set_viewport(&g_camera, g_fb_width, g_fb_height);
 
+    if (ui_charts_panel_open()) {
+        app_update_charts();
+    }
+    TRACE_BEGIN("ui_update");
     UiActions ui_actions = ui_update(&input, g_sim_paused, timing.dt_sec);
+    TRACE_END("ui_update");
     bool ui_mouse = ui_wants_mouse();
     bool ui_keyboard = ui_wants_keyboard();
 
@@ -345,6 +611,24 @@ void app_frame(void) {
         g_sim_paused = !g_sim_paused;
         LOG_INFO("pause=%d", g_sim_paused ? 1 : 0);
     }
+    if (!ui_keyboard && input.key_m_pressed) {
+        ui_toggle_memory_panel();
+        if (ui_memory_panel_open()) {
+            app_build_memory_report();
+            ui_set_memory_report(&g_mem_report);
+        }
+    }
+    if (!ui_keyboard && input.key_c_pressed) {
+        ui_toggle_charts_panel();
+    }
+    if (!ui_keyboard && input.key_p_pressed) {
+        g_show_paths = !g_show_paths;
+        LOG_INFO("paths=%d", g_show_paths ? 1 : 0);
+    }
+    if (!ui_keyboard && input.key_h_pressed) {
+        g_show_traffic = !g_show_traffic;
+        LOG_INFO("traffic=%d", g_show_traffic ? 1 : 0);
+    }
 
     bool step_requested = false;
     if (ui_actions.step_once) {
@@ -413,17 +697,20 @@ void app_frame(void) {
         }
     }
 
+    TRACE_BEGIN("sim");
     unsigned ticks_this_frame = 0;
     if (g_sim) {
         if (g_sim_paused) {
             if (step_requested) {
                 sim_tick(g_sim, g_sim_fixed_dt);
+                app_after_sim_tick();
                 ticks_this_frame = 1;
                 LOG_INFO("step one tick (%.3fms)", g_sim_fixed_dt * 1000.0f);
             }
         } else {
             while (g_sim_accumulator_sec >= (double)g_sim_fixed_dt) {
                 sim_tick(g_sim, g_sim_fixed_dt);
+                app_after_sim_tick();
                 g_sim_accumulator_sec -= (double)g_sim_fixed_dt;
                 ++ticks_this_frame;
             }
@@ -433,6 +720,9 @@ void app_frame(void) {
         }
     }
 
+    checkpoint_poll(&g_checkpoints);
+    TRACE_END("sim");
+
     g_log_accumulator_sec += timing.dt_sec;
     g_log_frame_counter += 1;
     g_log_tick_counter += ticks_this_frame;
@@ -447,15 +737,22 @@ void app_frame(void) {
                                ? (double)g_log_frame_counter / g_log_accumulator_sec
                                : 0.0;
             int fps_est = (int)(fps_f + 0.5);
-            LOG_INFO("dt=%.3fms acc=%.2fms ticks=%u fps~%d",
+            uint64_t upload_bytes = render_instance_upload_bytes(&g_render);
+            LOG_INFO("dt=%.3fms acc=%.2fms ticks=%u fps~%d upload=%.1fKB",
                      dt_ms,
                      acc_ms,
                      g_log_tick_counter,
-                     fps_est);
+                     fps_est,
+                     (double)(upload_bytes - g_log_upload_mark) / 1024.0);
         }
         g_log_accumulator_sec = 0.0;
         g_log_frame_counter = 0;
         g_log_tick_counter = 0;
+        g_log_upload_mark = render_instance_upload_bytes(&g_render);
+        if (ui_memory_panel_open()) {
+            app_build_memory_report();
+            ui_set_memory_report(&g_mem_report);
+        }
     }
 
     int fb_w = 0;
@@ -476,9 +773,16 @@ void app_frame(void) {
     uint32_t debug_line_colors[2] = {0};
     size_t debug_line_count = 0;
 
+    TRACE_BEGIN("build_view");
     RenderView view = (RenderView){0};
     if (g_sim) {
         view = sim_build_view(g_sim);
+        if (!g_show_paths) {
+            view.path_count = 0;
+        }
+        if (g_show_traffic) {
+            sim_traffic_view(g_sim, &view);
+        }
         if (g_selected_bee_index != SIZE_MAX) {
             BeeDebugInfo info;
             if (sim_get_bee_info(g_sim, g_selected_bee_index, &info)) {
@@ -518,10 +822,33 @@ void app_frame(void) {
         view.debug_line_rgba = debug_line_colors;
         view.debug_line_count = debug_line_count;
     }
+    TRACE_END("build_view");
     render_set_camera(&g_render, &g_camera);
+    TRACE_BEGIN("render");
     render_frame(&g_render, &view);
+    TRACE_END("render");
+    TRACE_BEGIN("ui_render");
     ui_render(g_fb_width, g_fb_height);
+    TRACE_END("ui_render");
+    if (g_capture) {
+        TRACE_BEGIN("capture");
+        app_capture_frame();
+        TRACE_END("capture");
+    }
+    TRACE_BEGIN("swap");
     plat_swap(&g_platform);
+    TRACE_END("swap");
+    TRACE_END("frame");
+    if (replay_frame) {
+        ddsketch_add(&g_replay_frame_ms, clock_ns_to_ms(clock_now_ns() - frame_start_ns));
+    }
+    app_pace_frame(&input);
+
+    // Toggled between frames so every recorded scope is balanced.
+    if (input.key_f9_pressed) {
+        app_toggle_trace();
+    }
+    alloc_frame_end();
 }
 
 void app_shutdown(void) {
@@ -529,11 +856,43 @@ void app_shutdown(void) {
         return;
     }
 
+    if (g_params.snapshot.every_ticks == 0) {
+        app_write_snapshot();
+    }
+    if (g_params.traffic.export_every_ticks == 0) {
+        app_write_traffic();
+    }
+    app_build_memory_report();
+    mem_report_log(&g_mem_report);
+    app_log_replay_summary();
+    input_replay_close(g_input_replay);
+    g_input_replay = NULL;
+    input_recorder_close(g_input_recorder);
+    g_input_recorder = NULL;
+    if (g_capture) {
+        render_capture_collect(&g_render, app_capture_sink, g_capture, true);
+        if (g_capture_skipped > 0) {
+            LOG_INFO("capture: %llu readbacks skipped while the GPU was behind",
+                     (unsigned long long)g_capture_skipped);
+        }
+        frame_capture_close(g_capture);
+        g_capture = NULL;
+    }
+    checkpoint_manager_shutdown(&g_checkpoints);
     sim_shutdown(g_sim);
     g_sim = NULL;
+    jobs_destroy(g_jobs);
+    g_jobs = NULL;
+    event_stream_close(g_events);
+    g_events = NULL;
+    if (g_trace_recording) {
+        app_dump_trace();
+    }
+    trace_shutdown();
     ui_shutdown();
     render_shutdown(&g_render);
     plat_shutdown(&g_platform);
+    alloc_report();
     log_shutdown();
 
     g_app_should_quit = false;
@@ -543,6 +902,9 @@ void app_shutdown(void) {
     g_log_accumulator_sec = 0.0;
     g_log_frame_counter = 0;
     g_log_tick_counter = 0;
+    g_capture_frame_counter = 0;
+    g_capture_next_id = 0;
+    g_capture_skipped = 0;
     app_reset_camera();
 }
 
@@ -0,0 +1,355 @@
+#include "frame_capture.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "util/alloc.h"
+#include "util/file_io.h"
+#include "util/image_write.h"
+#include "util/log.h"
+#include "util/thread.h"
+
+#define FRAME_CAPTURE_SLOTS 6
+#define FRAME_CAPTURE_WRITERS 3  // file output only; a pipe gets one writer so frames stay in order
+
+#if defined(_WIN32)
+#define capture_popen(cmd) _popen((cmd), "wb")
+#define capture_pclose _pclose
+#else
+#define capture_popen(cmd) popen((cmd), "w")
+#define capture_pclose pclose
+#endif
+
+typedef struct CaptureFrame {
+    uint8_t *rgba;  // rows top to bottom
+    int width;
+    int height;
+    uint64_t frame_id;
+    bool busy;      // held by the push path, the queue or a writer
+} CaptureFrame;
+
+typedef struct CaptureWriter {
+    FrameCapture *capture;
+    ThreadHandle thread;
+    ImageScratch scratch;
+    bool started;
+} CaptureWriter;
+
+struct FrameCapture {
+    char path_prefix[PARAMS_MAX_PATH_CHARS];
+    int format;
+    FILE *pipe;
+    bool pipe_failed;       // touched only by the single pipe writer
+#if !defined(_WIN32)
+    struct sigaction prev_sigpipe;  // restored by frame_capture_close
+    bool sigpipe_saved;
+#endif
+    int pipe_width;         // size of the stream; 0 until the first frame
+    int pipe_height;
+    bool size_warned;
+    CaptureFrame frames[FRAME_CAPTURE_SLOTS];
+    size_t frame_capacity;  // bytes per slot buffer
+    int width_capacity;     // frames up to this size fit slots and scratch
+    int height_capacity;
+    uint32_t queue[FRAME_CAPTURE_SLOTS];  // FIFO of queued slot indices
+    uint32_t queue_head;
+    uint32_t queue_count;
+    uint32_t busy_count;
+    bool stopping;
+    ThreadMutex lock;
+    ThreadCond work;        // a frame was queued or the writers should stop
+    ThreadCond idle;        // a slot was released
+    CaptureWriter writers[FRAME_CAPTURE_WRITERS];
+    int writer_count;
+    uint64_t queued;
+    uint64_t written;
+    uint64_t failed;
+    uint64_t dropped;
+};
+
+static const char *capture_extension(int format) {
+    switch (format) {
+        case CAPTURE_FORMAT_PPM: return "ppm";
+        case CAPTURE_FORMAT_RAW: return "rgba";
+        default: return "png";
+    }
+}
+
+static bool capture_write_frame(FrameCapture *capture, CaptureWriter *writer, const CaptureFrame *frame) {
+    const size_t bytes = (size_t)frame->width * (size_t)frame->height * 4u;
+    if (capture->pipe) {
+        if (capture->pipe_failed) {
+            return false;
+        }
+        if (fwrite(frame->rgba, 1, bytes, capture->pipe) != bytes) {
+            capture->pipe_failed = true;
+            LOG_ERROR("capture: encoder pipe closed at frame %llu; later frames are dropped",
+                      (unsigned long long)frame->frame_id);
+            return false;
+        }
+        return true;
+    }
+    char path[PARAMS_MAX_PATH_CHARS + 32];
+    int n = snprintf(path, sizeof path, "%s_%08llu.%s", capture->path_prefix,
+                     (unsigned long long)frame->frame_id, capture_extension(capture->format));
+    if (n < 0 || (size_t)n >= sizeof path) {
+        LOG_WARN("capture: path too long for prefix '%s'", capture->path_prefix);
+        return false;
+    }
+    switch (capture->format) {
+        case CAPTURE_FORMAT_PPM:
+            return image_write_ppm_scratch(path, frame->rgba, frame->width, frame->height, &writer->scratch);
+        case CAPTURE_FORMAT_RAW: {
+            FileSlice slice = {frame->rgba, bytes};
+            if (!file_write_slices(path, &slice, 1)) {
+                LOG_ERROR("capture: failed to write '%s'", path);
+                return false;
+            }
+            return true;
+        }
+        default:
+            return image_write_png_scratch(path, frame->rgba, frame->width, frame->height, &writer->scratch);
+    }
+}
+
+static int capture_writer_main(void *user) {
+    CaptureWriter *writer = (CaptureWriter *)user;
+    FrameCapture *capture = writer->capture;
+    thread_mutex_lock(&capture->lock);
+    for (;;) {
+        while (capture->queue_count == 0 && !capture->stopping) {
+            thread_cond_wait(&capture->work, &capture->lock);
+        }
+        if (capture->queue_count == 0) {
+            break;  // stopping and drained
+        }
+        uint32_t index = capture->queue[capture->queue_head];
+        capture->queue_head = (capture->queue_head + 1u) % FRAME_CAPTURE_SLOTS;
+        capture->queue_count -= 1u;
+        thread_mutex_unlock(&capture->lock);
+
+        bool ok = capture_write_frame(capture, writer, &capture->frames[index]);
+
+        thread_mutex_lock(&capture->lock);
+        capture->frames[index].busy = false;
+        capture->busy_count -= 1u;
+        if (ok) {
+            capture->written += 1;
+        } else {
+            capture->failed += 1;
+        }
+        thread_cond_signal(&capture->idle);
+    }
+    thread_mutex_unlock(&capture->lock);
+    return 0;
+}
+
+// Waits until the writers hold no frames, then regrows slots and scratch to
+// fit width x height. Writers only touch those buffers while holding a
+// frame, so nothing races the reallocation.
+static bool capture_grow(FrameCapture *capture, int width, int height) {
+    int w = width > capture->width_capacity ? width : capture->width_capacity;
+    int h = height > capture->height_capacity ? height : capture->height_capacity;
+    const size_t bytes = (size_t)w * (size_t)h * 4u;
+    bool ok = true;
+    thread_mutex_lock(&capture->lock);
+    while (capture->busy_count > 0) {
+        thread_cond_wait(&capture->idle, &capture->lock);
+    }
+    for (int i = 0; i < FRAME_CAPTURE_SLOTS && ok; ++i) {
+        uint8_t *grown = (uint8_t *)mem_realloc(ALLOC_TAG_IO, capture->frames[i].rgba, bytes);
+        if (grown) {
+            capture->frames[i].rgba = grown;
+        } else {
+            ok = false;
+        }
+    }
+    if (ok && !capture->pipe && capture->format != CAPTURE_FORMAT_RAW) {
+        for (int i = 0; i < capture->writer_count && ok; ++i) {
+            ok = image_scratch_reserve(&capture->writers[i].scratch, w, h);
+        }
+    }
+    if (ok) {
+        capture->frame_capacity = bytes;
+        capture->width_capacity = w;
+        capture->height_capacity = h;
+    }
+    thread_mutex_unlock(&capture->lock);
+    if (!ok) {
+        LOG_ERROR("capture: failed to allocate buffers for %dx%d frames", w, h);
+    }
+    return ok;
+}
+
+FrameCapture *frame_capture_open(const Params *params, int width, int height) {
+    if (!params || width <= 0 || height <= 0) {
+        LOG_ERROR("capture: invalid arguments");
+        return NULL;
+    }
+    const bool to_pipe = params->capture.pipe_command[0] != '\0';
+    if (!to_pipe && params->capture.path_prefix[0] == '\0') {
+        LOG_ERROR("capture: no output configured");
+        return NULL;
+    }
+    FrameCapture *capture = (FrameCapture *)mem_calloc(ALLOC_TAG_IO, 1, sizeof(FrameCapture));
+    if (!capture) {
+        LOG_ERROR("capture: failed to allocate capture state");
+        return NULL;
+    }
+    memcpy(capture->path_prefix, params->capture.path_prefix, sizeof(capture->path_prefix));
+    capture->format = to_pipe ? CAPTURE_FORMAT_RAW : params->capture.format;
+    capture->writer_count = to_pipe ? 1 : FRAME_CAPTURE_WRITERS;
+    thread_mutex_init(&capture->lock);
+    thread_cond_init(&capture->work);
+    thread_cond_init(&capture->idle);
+    if (to_pipe) {
+#if !defined(_WIN32)
+        // A dead encoder should fail the write, not kill the app. The
+        // previous disposition comes back once the pipe is closed.
+        struct sigaction ignore;
+        memset(&ignore, 0, sizeof(ignore));
+        ignore.sa_handler = SIG_IGN;
+        sigemptyset(&ignore.sa_mask);
+        capture->sigpipe_saved = sigaction(SIGPIPE, &ignore, &capture->prev_sigpipe) == 0;
+#endif
+        capture->pipe = capture_popen(params->capture.pipe_command);
+        if (!capture->pipe) {
+            LOG_ERROR("capture: cannot start encoder '%s'", params->capture.pipe_command);
+            frame_capture_close(capture);
+            return NULL;
+        }
+    }
+    if (!capture_grow(capture, width, height)) {
+        frame_capture_close(capture);
+        return NULL;
+    }
+    for (int i = 0; i < capture->writer_count; ++i) {
+        CaptureWriter *writer = &capture->writers[i];
+        writer->capture = capture;
+        writer->started = thread_create(&writer->thread, capture_writer_main, writer);
+        if (!writer->started) {
+            LOG_ERROR("capture: failed to start writer thread %d", i);
+            frame_capture_close(capture);
+            return NULL;
+        }
+    }
+    if (to_pipe) {
+        LOG_INFO("capture: streaming %dx%d RGBA frames to '%s'", width, height,
+                 params->capture.pipe_command);
+    } else {
+        LOG_INFO("capture: writing %s_<frame>.%s with %d writers", capture->path_prefix,
+                 capture_extension(capture->format), capture->writer_count);
+    }
+    return capture;
+}
+
+bool frame_capture_push(FrameCapture *capture, const uint8_t *rgba_bottom_up, int width, int height,
+                        uint64_t frame_id) {
+    if (!capture || !rgba_bottom_up || width <= 0 || height <= 0) {
+        return false;
+    }
+    if (capture->pipe) {
+        if (capture->pipe_width == 0) {
+            capture->pipe_width = width;
+            capture->pipe_height = height;
+        } else if (width != capture->pipe_width || height != capture->pipe_height) {
+            if (!capture->size_warned) {
+                capture->size_warned = true;
+                LOG_WARN("capture: window is now %dx%d but the stream is %dx%d; dropping frames until it matches",
+                         width, height, capture->pipe_width, capture->pipe_height);
+            }
+            capture->dropped += 1;
+            return false;
+        }
+    }
+    if ((width > capture->width_capacity || height > capture->height_capacity) &&
+        !capture_grow(capture, width, height)) {
+        capture->dropped += 1;
+        return false;
+    }
+
+    thread_mutex_lock(&capture->lock);
+    int index = -1;
+    for (int i = 0; i < FRAME_CAPTURE_SLOTS; ++i) {
+        if (!capture->frames[i].busy) {
+            index = i;
+            break;
+        }
+    }
+    if (index < 0) {
+        capture->dropped += 1;
+        thread_mutex_unlock(&capture->lock);
+        return false;
+    }
+    CaptureFrame *frame = &capture->frames[index];
+    frame->busy = true;
+    capture->busy_count += 1u;
+    thread_mutex_unlock(&capture->lock);
+
+    const size_t stride = (size_t)width * 4u;
+    for (int y = 0; y < height; ++y) {
+        memcpy(frame->rgba + (size_t)y * stride, rgba_bottom_up + (size_t)(height - 1 - y) * stride, stride);
+    }
+    frame->width = width;
+    frame->height = height;
+    frame->frame_id = frame_id;
+
+    thread_mutex_lock(&capture->lock);
+    capture->queue[(capture->queue_head + capture->queue_count) % FRAME_CAPTURE_SLOTS] = (uint32_t)index;
+    capture->queue_count += 1u;
+    capture->queued += 1;
+    thread_cond_signal(&capture->work);
+    thread_mutex_unlock(&capture->lock);
+    return true;
+}
+
+void frame_capture_memory_report(const FrameCapture *capture, MemReport *report) {
+    if (!capture || !report) {
+        return;
+    }
+    uint64_t bytes = (uint64_t)capture->frame_capacity * FRAME_CAPTURE_SLOTS;
+    for (int i = 0; i < capture->writer_count; ++i) {
+        bytes += image_scratch_bytes(&capture->writers[i].scratch);
+    }
+    mem_report_add(report, "capture", "frames", bytes, MEM_REGION_CPU, false);
+}
+
+void frame_capture_close(FrameCapture *capture) {
+    if (!capture) {
+        return;
+    }
+    thread_mutex_lock(&capture->lock);
+    capture->stopping = true;
+    thread_cond_broadcast(&capture->work);
+    thread_mutex_unlock(&capture->lock);
+    for (int i = 0; i < capture->writer_count; ++i) {
+        if (capture->writers[i].started) {
+            thread_join(&capture->writers[i].thread);
+        }
+        image_scratch_free(&capture->writers[i].scratch);
+    }
+    if (capture->pipe) {
+        int status = capture_pclose(capture->pipe);
+        if (status != 0) {
+            LOG_WARN("capture: encoder exited with status %d", status);
+        }
+    }
+#if !defined(_WIN32)
+    if (capture->sigpipe_saved) {
+        sigaction(SIGPIPE, &capture->prev_sigpipe, NULL);
+    }
+#endif
+    if (capture->queued > 0 || capture->dropped > 0) {
+        LOG_INFO("capture: wrote %llu frames (%llu dropped, %llu failed)",
+                 (unsigned long long)capture->written, (unsigned long long)capture->dropped,
+                 (unsigned long long)capture->failed);
+    }
+    for (int i = 0; i < FRAME_CAPTURE_SLOTS; ++i) {
+        mem_free(ALLOC_TAG_IO, capture->frames[i].rgba);
+    }
+    thread_cond_destroy(&capture->idle);
+    thread_cond_destroy(&capture->work);
+    thread_mutex_destroy(&capture->lock);
+    mem_free(ALLOC_TAG_IO, capture);
+}
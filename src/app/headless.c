@@ -0,0 +1,218 @@
+#include "app.h"
+
+#include <stdio.h>
+
+#include "checkpoint.h"
+#include "event_stream.h"
+#include "params.h"
+#include "sim.h"
+#include "soft_render.h"
+#include "util/alloc.h"
+#include "util/clock.h"
+#include "util/jobs.h"
+#include "util/log.h"
+#include "util/mem_report.h"
+#include "util/trace.h"
+
+typedef struct HeadlessFrames {
+    SoftRender *render;
+    uint64_t written;
+    uint64_t render_ns;
+} HeadlessFrames;
+
+static void headless_write_frame(HeadlessFrames *frames, SimState *sim, const Params *params) {
+    if (!frames->render) {
+        return;
+    }
+    char path[PARAMS_MAX_PATH_CHARS + 32];
+    int n = snprintf(path, sizeof path, "%s_%08llu.%s", params->frames.path_prefix,
+                     (unsigned long long)sim_tick_index(sim), params->frames.ppm ? "ppm" : "png");
+    if (n < 0 || (size_t)n >= sizeof path) {
+        LOG_WARN("frames: path too long for prefix '%s'", params->frames.path_prefix);
+        return;
+    }
+    RenderView view = sim_build_view(sim);
+    uint64_t start_ns = clock_now_ns();
+    bool ok = soft_render_frame(frames->render, &view);
+    frames->render_ns += clock_now_ns() - start_ns;
+    if (ok && soft_render_write(frames->render, path)) {
+        frames->written += 1;
+    }
+}
+
+int app_run_headless(const Params *params) {
+    log_init();
+    log_set_level(LOG_LEVEL_INFO);
+
+    if (!params) {
+        LOG_ERROR("headless: null Params pointer");
+        return 1;
+    }
+    char err[256];
+    if (!params_validate(params, err, sizeof err)) {
+        LOG_ERROR("Params validation failed: %s", err);
+        return 1;
+    }
+
+    const bool tracing = params->trace.path[0] != '\0' && trace_init(0);
+    if (tracing) {
+        trace_start();
+    }
+    JobPool *jobs = jobs_create(params->jobs.threads, params->jobs.pin_threads);
+
+    SimState *sim = NULL;
+    if (!sim_init_with_jobs(&sim, params, jobs)) {
+        LOG_ERROR("headless: simulation initialization failed");
+        jobs_destroy(jobs);
+        trace_shutdown();
+        return 1;
+    }
+
+    float dt = params->sim_fixed_dt > 0.0f ? params->sim_fixed_dt : 1.0f / 120.0f;
+    EventStream *events = NULL;
+    if (params->events.path[0] != '\0') {
+        events = event_stream_open(params->events.path, params->events.mask, 1,
+                                   (double)dt, sim_seed(sim));
+        if (!events) {
+            LOG_WARN("events: stream disabled");
+        }
+        sim_set_event_stream(sim, events);
+    }
+
+    const uint64_t ticks = params->headless.ticks;
+    const uint32_t snapshot_every = params->snapshot.every_ticks;
+    const bool snapshots = params->snapshot.path_prefix[0] != '\0';
+    const uint32_t traffic_every = params->traffic.export_every_ticks;
+    const bool traffic = params->traffic.export_prefix[0] != '\0';
+    const uint32_t checkpoint_every = params->checkpoint.path_prefix[0] != '\0'
+                                          ? params->checkpoint.every_ticks
+                                          : 0u;
+    CheckpointManager checkpoints;
+    checkpoint_manager_init(&checkpoints, params->checkpoint.max_concurrent);
+
+    HeadlessFrames frames = {0};
+    const uint32_t frame_every = params->frames.every_ticks;
+    if (params->frames.path_prefix[0] != '\0') {
+        frames.render = soft_render_create(params, params->frames.width, params->frames.height, jobs);
+        if (!frames.render) {
+            LOG_WARN("frames: output disabled");
+        }
+        float world_w = params->world_width_px > 0.0f ? params->world_width_px
+                                                      : (float)params->window_width_px;
+        float world_h = params->world_height_px > 0.0f ? params->world_height_px
+                                                       : (float)params->window_height_px;
+        soft_render_fit_camera(frames.render, world_w, world_h);
+    }
+    LOG_INFO("headless: running %llu ticks bees=%zu dt=%.5f",
+             (unsigned long long)ticks, params->bee_count, dt);
+
+    uint64_t sim_ns = 0;
+    uint64_t worst_tick_ns = 0;
+    uint64_t run_start_ns = clock_now_ns();
+    for (uint64_t t = 0; t < ticks; ++t) {
+        uint64_t tick_start_ns = clock_now_ns();
+        sim_tick(sim, dt);
+        uint64_t tick_ns = clock_now_ns() - tick_start_ns;
+        sim_ns += tick_ns;
+        if (tick_ns > worst_tick_ns) {
+            worst_tick_ns = tick_ns;
+        }
+        if (snapshots && snapshot_every > 0 && sim_tick_index(sim) % snapshot_every == 0) {
+            sim_write_tick_snapshot(sim, params->snapshot.path_prefix);
+        }
+        if (traffic && traffic_every > 0 && sim_tick_index(sim) % traffic_every == 0) {
+            sim_write_traffic(sim, params->traffic.export_prefix);
+        }
+        if (checkpoint_every > 0 && sim_tick_index(sim) % checkpoint_every == 0) {
+            checkpoint_request(&checkpoints, sim, params->checkpoint.path_prefix);
+        }
+        if (frame_every > 0 && sim_tick_index(sim) % frame_every == 0) {
+            headless_write_frame(&frames, sim, params);
+        }
+        checkpoint_poll(&checkpoints);
+    }
+    if (snapshots && snapshot_every == 0) {
+        sim_write_tick_snapshot(sim, params->snapshot.path_prefix);
+    }
+    if (traffic && traffic_every == 0) {
+        sim_write_traffic(sim, params->traffic.export_prefix);
+    }
+    if (frame_every == 0) {
+        headless_write_frame(&frames, sim, params);
+    }
+    double wall_sec = (double)(clock_now_ns() - run_start_ns) * 1e-9;
+    double sim_sec = (double)sim_ns * 1e-9;
+
+    LOG_INFO("headless: summary ticks=%llu bees=%zu wall=%.3fs sim=%.3fs "
+             "tick_avg=%.3fms tick_max=%.3fms bee_ticks/s=%.2fM sim_time=%.1fs",
+             (unsigned long long)ticks,
+             params->bee_count,
+             wall_sec,
+             sim_sec,
+             ticks > 0 ? clock_ns_to_ms(sim_ns) / (double)ticks : 0.0,
+             clock_ns_to_ms(worst_tick_ns),
+             sim_sec > 0.0 ? (double)ticks * (double)params->bee_count / sim_sec * 1e-6 : 0.0,
+             (double)ticks * (double)dt);
+
+    SimStats stats;
+    if (sim_get_stats(sim, &stats)) {
+        LOG_INFO("headless: last tick=%llu plans=%llu los_hits=%llu probe_rays=%llu "
+                 "hive_tests=%llu hive_hits=%llu hive_iters=%llu patch_choices=%llu "
+                 "mode_changes=%llu bounces=%llu",
+                 (unsigned long long)stats.tick,
+                 (unsigned long long)stats.path_plans,
+                 (unsigned long long)stats.path_los_hits,
+                 (unsigned long long)stats.path_probe_rays,
+                 (unsigned long long)stats.hive_segment_tests,
+                 (unsigned long long)stats.hive_collisions,
+                 (unsigned long long)stats.hive_resolve_iters,
+                 (unsigned long long)stats.patch_choices,
+                 (unsigned long long)stats.mode_transitions,
+                 (unsigned long long)stats.wall_bounces);
+    }
+
+    for (size_t p = 0; p < sim_patch_count(sim); ++p) {
+        SimTripSummary trips;
+        if (!sim_get_trip_summary(sim, p, &trips) || (trips.trips == 0 && trips.abandoned == 0)) {
+            continue;
+        }
+        LOG_INFO("headless: patch %zu trips=%llu abandoned=%llu duration p50/p90/p99=%.1f/%.1f/%.1fs "
+                 "distance p50=%.0f nectar p50/p90=%.1f/%.1fuL energy p50=%.2f",
+                 p,
+                 (unsigned long long)trips.trips,
+                 (unsigned long long)trips.abandoned,
+                 trips.duration_sec.p50,
+                 trips.duration_sec.p90,
+                 trips.duration_sec.p99,
+                 trips.distance_world.p50,
+                 trips.nectar_uL.p50,
+                 trips.nectar_uL.p90,
+                 trips.energy.p50);
+    }
+
+    if (frames.render) {
+        LOG_INFO("headless: frames=%llu render_avg=%.2fms",
+                 (unsigned long long)frames.written,
+                 frames.written > 0 ? clock_ns_to_ms(frames.render_ns) / (double)frames.written : 0.0);
+    }
+
+    MemReport report;
+    mem_report_reset(&report, 0);
+    sim_memory_report(sim, &report);
+    soft_render_memory_report(frames.render, &report);
+    mem_report_log(&report);
+
+    soft_render_destroy(frames.render);
+    checkpoint_manager_shutdown(&checkpoints);
+    sim_shutdown(sim);
+    jobs_destroy(jobs);
+    event_stream_close(events);
+    if (tracing) {
+        // After the worker threads are joined so their buffers are quiescent.
+        trace_dump_json(params->trace.path);
+    }
+    trace_shutdown();
+    alloc_report();
+    log_shutdown();
+    return 0;
+}
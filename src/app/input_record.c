@@ -0,0 +1,283 @@
+#include "input_record.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "util/alloc.h"
+#include "util/log.h"
+
+// Bit i of InputFrameRecord.key_bits is the i-th entry here. Keys added to
+// Input later are appended at the end so older recordings keep their bits.
+static const size_t kInputBoolOffsets[] = {
+    offsetof(Input, quit_requested),
+    offsetof(Input, key_escape_down),
+    offsetof(Input, key_space_down),
+    offsetof(Input, key_period_down),
+    offsetof(Input, key_escape_pressed),
+    offsetof(Input, key_space_pressed),
+    offsetof(Input, key_period_pressed),
+    offsetof(Input, key_plus_pressed),
+    offsetof(Input, key_minus_pressed),
+    offsetof(Input, key_plus_down),
+    offsetof(Input, key_minus_down),
+    offsetof(Input, key_w_down),
+    offsetof(Input, key_a_down),
+    offsetof(Input, key_s_down),
+    offsetof(Input, key_d_down),
+    offsetof(Input, key_reset_pressed),
+    offsetof(Input, key_m_pressed),
+    offsetof(Input, key_f9_pressed),
+    offsetof(Input, mouse_left_down),
+    offsetof(Input, mouse_right_down),
+    offsetof(Input, mouse_left_pressed),
+    offsetof(Input, mouse_right_pressed),
+    offsetof(Input, key_c_pressed),
+    offsetof(Input, key_p_pressed),
+    offsetof(Input, key_h_pressed),
+};
+
+#define INPUT_BOOL_COUNT (sizeof(kInputBoolOffsets) / sizeof(kInputBoolOffsets[0]))
+
+struct InputRecorder {
+    FILE *file;
+    uint64_t frames;
+    bool write_failed;
+};
+
+struct InputReplay {
+    InputFrameRecord *frames;
+    size_t frame_count;
+    size_t cursor;
+    float fixed_dt;
+    double fixed_now_sec;
+};
+
+static void input_pack(const Input *input, const Timing *timing, InputFrameRecord *out) {
+    memset(out, 0, sizeof(*out));
+    for (size_t b = 0; b < INPUT_BOOL_COUNT; ++b) {
+        const bool *flag = (const bool *)((const char *)input + kInputBoolOffsets[b]);
+        out->key_bits |= *flag ? (1u << b) : 0u;
+    }
+    out->wheel_y = (int32_t)input->wheel_y;
+    out->mouse_x_px = input->mouse_x_px;
+    out->mouse_y_px = input->mouse_y_px;
+    out->mouse_dx_px = input->mouse_dx_px;
+    out->mouse_dy_px = input->mouse_dy_px;
+    out->dt_sec = timing->dt_sec;
+    out->now_sec = timing->now_sec;
+}
+
+static void input_unpack(const InputFrameRecord *record, Input *out_input, Timing *out_timing) {
+    memset(out_input, 0, sizeof(*out_input));
+    for (size_t b = 0; b < INPUT_BOOL_COUNT; ++b) {
+        bool *flag = (bool *)((char *)out_input + kInputBoolOffsets[b]);
+        *flag = (record->key_bits >> b) & 1u;
+    }
+    out_input->wheel_y = (int)record->wheel_y;
+    out_input->mouse_x_px = record->mouse_x_px;
+    out_input->mouse_y_px = record->mouse_y_px;
+    out_input->mouse_dx_px = record->mouse_dx_px;
+    out_input->mouse_dy_px = record->mouse_dy_px;
+    out_timing->dt_sec = record->dt_sec;
+    out_timing->now_sec = record->now_sec;
+}
+
+static void input_header_from_params(const Params *params, InputRecordHeader *out) {
+    memset(out, 0, sizeof(*out));
+    memcpy(out->magic, INPUT_RECORD_MAGIC, sizeof(out->magic));
+    out->version = INPUT_RECORD_VERSION;
+    out->frame_size = (uint32_t)sizeof(InputFrameRecord);
+    out->rng_seed = params->rng_seed;
+    out->bee_count = (uint64_t)params->bee_count;
+    out->window_width_px = params->window_width_px;
+    out->window_height_px = params->window_height_px;
+    out->sim_fixed_dt = params->sim_fixed_dt;
+}
+
+InputRecorder *input_recorder_open(const char *path, const Params *params) {
+    if (!path || !path[0] || !params) {
+        LOG_ERROR("input_record: invalid arguments");
+        return NULL;
+    }
+    InputRecorder *recorder = (InputRecorder *)mem_calloc(ALLOC_TAG_IO, 1, sizeof(InputRecorder));
+    if (!recorder) {
+        LOG_ERROR("input_record: failed to allocate recorder");
+        return NULL;
+    }
+    recorder->file = fopen(path, "wb");
+    if (!recorder->file) {
+        LOG_ERROR("input_record: cannot create '%s'", path);
+        mem_free(ALLOC_TAG_IO, recorder);
+        return NULL;
+    }
+    InputRecordHeader header;
+    input_header_from_params(params, &header);
+    if (fwrite(&header, sizeof(header), 1, recorder->file) != 1) {
+        LOG_ERROR("input_record: failed to write header to '%s'", path);
+        fclose(recorder->file);
+        mem_free(ALLOC_TAG_IO, recorder);
+        return NULL;
+    }
+    LOG_INFO("input_record: recording to %s", path);
+    return recorder;
+}
+
+void input_recorder_write(InputRecorder *recorder, const Input *input, const Timing *timing) {
+    if (!recorder || !input || !timing || recorder->write_failed) {
+        return;
+    }
+    InputFrameRecord record;
+    input_pack(input, timing, &record);
+    if (fwrite(&record, sizeof(record), 1, recorder->file) != 1) {
+        recorder->write_failed = true;
+        LOG_ERROR("input_record: write failed after %llu frames; recording stopped",
+                  (unsigned long long)recorder->frames);
+        return;
+    }
+    recorder->frames += 1;
+}
+
+void input_recorder_close(InputRecorder *recorder) {
+    if (!recorder) {
+        return;
+    }
+    if (fclose(recorder->file) != 0) {
+        recorder->write_failed = true;
+    }
+    if (recorder->write_failed) {
+        LOG_WARN("input_record: recording is truncated");
+    }
+    LOG_INFO("input_record: wrote %llu frames", (unsigned long long)recorder->frames);
+    mem_free(ALLOC_TAG_IO, recorder);
+}
+
+static bool input_replay_check_header(const InputRecordHeader *header, const char *path) {
+    if (memcmp(header->magic, INPUT_RECORD_MAGIC, sizeof(header->magic)) != 0) {
+        LOG_ERROR("input_replay: '%s' is not an input recording", path);
+        return false;
+    }
+    if (header->version != INPUT_RECORD_VERSION ||
+        header->frame_size != (uint32_t)sizeof(InputFrameRecord)) {
+        LOG_ERROR("input_replay: '%s' has version %u frame size %u (expected %u / %zu)",
+                  path, header->version, header->frame_size, INPUT_RECORD_VERSION,
+                  sizeof(InputFrameRecord));
+        return false;
+    }
+    return true;
+}
+
+static void input_replay_warn_mismatch(const InputRecordHeader *header, const Params *params) {
+    if (header->rng_seed != params->rng_seed || header->bee_count != (uint64_t)params->bee_count) {
+        LOG_WARN("input_replay: recorded with seed=0x%llx bees=%llu, running seed=0x%llx bees=%zu",
+                 (unsigned long long)header->rng_seed, (unsigned long long)header->bee_count,
+                 (unsigned long long)params->rng_seed, params->bee_count);
+    }
+    if (header->window_width_px != params->window_width_px ||
+        header->window_height_px != params->window_height_px) {
+        LOG_WARN("input_replay: recorded in a %dx%d window, running %dx%d; clicks may land elsewhere",
+                 header->window_width_px, header->window_height_px,
+                 params->window_width_px, params->window_height_px);
+    }
+    if (header->sim_fixed_dt != params->sim_fixed_dt) {
+        LOG_WARN("input_replay: recorded with sim dt=%.5f, running %.5f",
+                 header->sim_fixed_dt, params->sim_fixed_dt);
+    }
+}
+
+static bool input_replay_read(FILE *file, const char *path, const Params *params, InputReplay *replay) {
+    InputRecordHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1) {
+        LOG_ERROR("input_replay: '%s' is too short for a header", path);
+        return false;
+    }
+    if (!input_replay_check_header(&header, path)) {
+        return false;
+    }
+    input_replay_warn_mismatch(&header, params);
+
+    if (fseek(file, 0, SEEK_END) != 0) {
+        LOG_ERROR("input_replay: cannot seek '%s'", path);
+        return false;
+    }
+    long end = ftell(file);
+    if (end < (long)sizeof(header) || fseek(file, (long)sizeof(header), SEEK_SET) != 0) {
+        LOG_ERROR("input_replay: cannot size '%s'", path);
+        return false;
+    }
+    size_t payload = (size_t)end - sizeof(header);
+    size_t frame_count = payload / sizeof(InputFrameRecord);
+    if (payload % sizeof(InputFrameRecord) != 0) {
+        LOG_WARN("input_replay: '%s' ends in a partial frame; ignoring it", path);
+    }
+    if (frame_count == 0) {
+        LOG_ERROR("input_replay: '%s' holds no frames", path);
+        return false;
+    }
+    replay->frames = (InputFrameRecord *)mem_alloc(ALLOC_TAG_IO, sizeof(InputFrameRecord) * frame_count);
+    if (!replay->frames) {
+        LOG_ERROR("input_replay: failed to allocate %zu frames", frame_count);
+        return false;
+    }
+    if (fread(replay->frames, sizeof(InputFrameRecord), frame_count, file) != frame_count) {
+        LOG_ERROR("input_replay: short read from '%s'", path);
+        mem_free(ALLOC_TAG_IO, replay->frames);
+        replay->frames = NULL;
+        return false;
+    }
+    replay->frame_count = frame_count;
+    return true;
+}
+
+InputReplay *input_replay_open(const char *path, const Params *params, float fixed_dt) {
+    if (!path || !path[0] || !params) {
+        LOG_ERROR("input_replay: invalid arguments");
+        return NULL;
+    }
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        LOG_ERROR("input_replay: cannot open '%s'", path);
+        return NULL;
+    }
+    InputReplay *replay = (InputReplay *)mem_calloc(ALLOC_TAG_IO, 1, sizeof(InputReplay));
+    if (!replay) {
+        LOG_ERROR("input_replay: failed to allocate replay");
+        fclose(file);
+        return NULL;
+    }
+    bool ok = input_replay_read(file, path, params, replay);
+    fclose(file);
+    if (!ok) {
+        mem_free(ALLOC_TAG_IO, replay);
+        return NULL;
+    }
+    replay->fixed_dt = fixed_dt > 0.0f ? fixed_dt : 0.0f;
+    LOG_INFO("input_replay: %zu frames from %s dt=%s", replay->frame_count, path,
+             replay->fixed_dt > 0.0f ? "fixed" : "recorded");
+    return replay;
+}
+
+bool input_replay_next(InputReplay *replay, Input *out_input, Timing *out_timing) {
+    if (!replay || !out_input || !out_timing || replay->cursor >= replay->frame_count) {
+        return false;
+    }
+    input_unpack(&replay->frames[replay->cursor], out_input, out_timing);
+    replay->cursor += 1;
+    if (replay->fixed_dt > 0.0f) {
+        replay->fixed_now_sec += (double)replay->fixed_dt;
+        out_timing->dt_sec = replay->fixed_dt;
+        out_timing->now_sec = replay->fixed_now_sec;
+    }
+    return true;
+}
+
+size_t input_replay_frame_count(const InputReplay *replay) {
+    return replay ? replay->frame_count : 0;
+}
+
+void input_replay_close(InputReplay *replay) {
+    if (!replay) {
+        return;
+    }
+    mem_free(ALLOC_TAG_IO, replay->frames);
+    mem_free(ALLOC_TAG_IO, replay);
+}
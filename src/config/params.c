@@ -1,9 +1,12 @@
 #include "params.h"
 
 #include <inttypes.h>
+#include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#include "event_stream.h"
 #include "util/log.h"
 
 static void copy_string(char *dst, size_t cap, const char *src) {
@@ -29,6 +32,7 @@ void params_init_defaults(Params *params) {
     params->window_height_px = 720;
     copy_string(params->window_title, PARAMS_MAX_TITLE_CHARS, "Bee Simulation");
     params->vsync_on = true;
+    params->frame_limit_fps = 0;
     params->clear_color_rgba[0] = 0.98f;
     params->clear_color_rgba[1] = 0.98f;
     params->clear_color_rgba[2] = 0.96f;
@@ -70,6 +74,432 @@ void params_init_defaults(Params *params) {
     params->bee.speed_mps = 60.0f;
     params->bee.seek_accel = 220.0f;
     params->bee.arrive_tol_world = params->bee_radius_px * 2.0f;
+
+    params->hex.tile_size_px = 40.0f;
+
+    params->events.path[0] = '\0';
+    params->events.mask = BEE_EVENT_MASK_ALL;
+
+    params->snapshot.path_prefix[0] = '\0';
+    params->snapshot.every_ticks = 0;
+
+    params->checkpoint.path_prefix[0] = '\0';
+    params->checkpoint.every_ticks = 0;
+    params->checkpoint.max_concurrent = 2;
+
+    params->trace.path[0] = '\0';
+
+    params->jobs.threads = 0;
+    params->jobs.pin_threads = false;
+
+    params->headless.ticks = 0;
+
+    params->frames.path_prefix[0] = '\0';
+    params->frames.every_ticks = 0;
+    params->frames.width = 0;
+    params->frames.height = 0;
+    params->frames.ppm = false;
+
+    params->input.record_path[0] = '\0';
+    params->input.replay_path[0] = '\0';
+    params->input.replay_dt = 0.0f;
+
+    params->capture.path_prefix[0] = '\0';
+    params->capture.pipe_command[0] = '\0';
+    params->capture.every_frames = 1;
+    params->capture.format = CAPTURE_FORMAT_PNG;
+
+    params->shader_cache.dir[0] = '\0';
+
+    params->traffic.cell_world = 4.0f;
+    params->traffic.decay_sec = 30.0f;
+    params->traffic.export_prefix[0] = '\0';
+    params->traffic.export_every_ticks = 0;
+}
+
+static bool params_parse_u64(const char *text, uint64_t *out_value) {
+    if (!text || !text[0]) {
+        return false;
+    }
+    char *end = NULL;
+    unsigned long long value = strtoull(text, &end, 0);
+    if (!end || *end != '\0') {
+        return false;
+    }
+    *out_value = (uint64_t)value;
+    return true;
+}
+
+static bool params_parse_float(const char *text, float *out_value) {
+    if (!text || !text[0]) {
+        return false;
+    }
+    char *end = NULL;
+    float value = strtof(text, &end);
+    if (!end || *end != '\0' || !isfinite(value)) {
+        return false;
+    }
+    *out_value = value;
+    return true;
+}
+
+static bool params_parse_size(const char *text, int *out_w, int *out_h) {
+    if (!text) {
+        return false;
+    }
+    const char *sep = strchr(text, 'x');
+    if (!sep || sep == text || (size_t)(sep - text) >= 16) {
+        return false;
+    }
+    char width_text[16];
+    memcpy(width_text, text, (size_t)(sep - text));
+    width_text[sep - text] = '\0';
+    uint64_t w = 0;
+    uint64_t h = 0;
+    if (!params_parse_u64(width_text, &w) || !params_parse_u64(sep + 1, &h) ||
+        w == 0 || h == 0 || w > 16384 || h > 16384) {
+        return false;
+    }
+    *out_w = (int)w;
+    *out_h = (int)h;
+    return true;
+}
+
+static bool params_parse_event_mask(const char *text, uint32_t *out_mask) {
+    if (!text || !text[0]) {
+        return false;
+    }
+    if (strcmp(text, "all") == 0) {
+        *out_mask = BEE_EVENT_MASK_ALL;
+        return true;
+    }
+    uint32_t mask = 0;
+    const char *cursor = text;
+    while (*cursor) {
+        const char *end = strchr(cursor, ',');
+        size_t len = end ? (size_t)(end - cursor) : strlen(cursor);
+        bool matched = false;
+        for (uint32_t type = 0; type < BEE_EVENT_TYPE_COUNT; ++type) {
+            const char *name = bee_event_type_name(type);
+            if (strlen(name) == len && strncmp(cursor, name, len) == 0) {
+                mask |= BEE_EVENT_BIT(type);
+                matched = true;
+                break;
+            }
+        }
+        if (!matched) {
+            return false;
+        }
+        cursor += len;
+        if (*cursor == ',') {
+            ++cursor;
+        }
+    }
+    *out_mask = mask;
+    return true;
+}
+
+bool params_apply_cli(Params *params, int argc, char **argv,
+                      char *err_buf, size_t err_cap) {
+    if (!params) {
+        if (err_buf && err_cap > 0) {
+            snprintf(err_buf, err_cap, "%s", "Params pointer is null");
+        }
+        return false;
+    }
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        uint64_t number = 0;
+        if (strcmp(arg, "--bees") == 0) {
+            if (!params_parse_u64(value, &number) || number == 0 || number > SIZE_MAX) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "--bees expects a positive count (got '%s')",
+                             value ? value : "");
+                }
+                return false;
+            }
+            params->bee_count = (size_t)number;
+            ++i;
+        } else if (strcmp(arg, "--seed") == 0) {
+            if (!params_parse_u64(value, &number)) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "--seed expects an integer (got '%s')",
+                             value ? value : "");
+                }
+                return false;
+            }
+            params->rng_seed = number;
+            ++i;
+        } else if (strcmp(arg, "--headless") == 0) {
+            if (!params_parse_u64(value, &number) || number == 0) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "--headless expects a tick count (got '%s')",
+                             value ? value : "");
+                }
+                return false;
+            }
+            params->headless.ticks = number;
+            ++i;
+        } else if (strcmp(arg, "--events") == 0) {
+            if (!value) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "%s", "--events requires a file path");
+                }
+                return false;
+            }
+            copy_string(params->events.path, PARAMS_MAX_PATH_CHARS, value);
+            ++i;
+        } else if (strcmp(arg, "--events-mask") == 0) {
+            if (!value || !params_parse_event_mask(value, &params->events.mask)) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap,
+                             "--events-mask expects 'all' or a comma list of "
+                             "mode,target,harvest,unload,role (got '%s')",
+                             value ? value : "");
+                }
+                return false;
+            }
+            ++i;
+        } else if (strcmp(arg, "--snapshot") == 0) {
+            if (!value) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "%s", "--snapshot requires a path prefix");
+                }
+                return false;
+            }
+            copy_string(params->snapshot.path_prefix, PARAMS_MAX_PATH_CHARS, value);
+            ++i;
+        } else if (strcmp(arg, "--snapshot-every") == 0) {
+            if (!params_parse_u64(value, &number) || number > UINT32_MAX) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "--snapshot-every expects a tick count (got '%s')",
+                             value ? value : "");
+                }
+                return false;
+            }
+            params->snapshot.every_ticks = (uint32_t)number;
+            ++i;
+        } else if (strcmp(arg, "--checkpoint") == 0) {
+            if (!value) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "%s", "--checkpoint requires a path prefix");
+                }
+                return false;
+            }
+            copy_string(params->checkpoint.path_prefix, PARAMS_MAX_PATH_CHARS, value);
+            ++i;
+        } else if (strcmp(arg, "--checkpoint-every") == 0) {
+            if (!params_parse_u64(value, &number) || number == 0 || number > UINT32_MAX) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "--checkpoint-every expects a tick count (got '%s')",
+                             value ? value : "");
+                }
+                return false;
+            }
+            params->checkpoint.every_ticks = (uint32_t)number;
+            ++i;
+        } else if (strcmp(arg, "--checkpoint-max") == 0) {
+            if (!params_parse_u64(value, &number) || number == 0 || number > 8) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "--checkpoint-max expects 1-8 (got '%s')",
+                             value ? value : "");
+                }
+                return false;
+            }
+            params->checkpoint.max_concurrent = (int)number;
+            ++i;
+        } else if (strcmp(arg, "--trace") == 0) {
+            if (!value) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "%s", "--trace requires an output path");
+                }
+                return false;
+            }
+            copy_string(params->trace.path, PARAMS_MAX_PATH_CHARS, value);
+            ++i;
+        } else if (strcmp(arg, "--jobs") == 0) {
+            if (!params_parse_u64(value, &number) || number == 0 || number > 64) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "--jobs expects 1-64 threads (got '%s')",
+                             value ? value : "");
+                }
+                return false;
+            }
+            params->jobs.threads = (int)number;
+            ++i;
+        } else if (strcmp(arg, "--pin-threads") == 0) {
+            params->jobs.pin_threads = true;
+        } else if (strcmp(arg, "--frames") == 0) {
+            if (!value) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "%s", "--frames requires a path prefix");
+                }
+                return false;
+            }
+            copy_string(params->frames.path_prefix, PARAMS_MAX_PATH_CHARS, value);
+            ++i;
+        } else if (strcmp(arg, "--frames-every") == 0) {
+            if (!params_parse_u64(value, &number) || number > UINT32_MAX) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "--frames-every expects a tick count (got '%s')",
+                             value ? value : "");
+                }
+                return false;
+            }
+            params->frames.every_ticks = (uint32_t)number;
+            ++i;
+        } else if (strcmp(arg, "--frames-size") == 0) {
+            if (!params_parse_size(value, &params->frames.width, &params->frames.height)) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "--frames-size expects WxH up to 16384 (got '%s')",
+                             value ? value : "");
+                }
+                return false;
+            }
+            ++i;
+        } else if (strcmp(arg, "--frames-ppm") == 0) {
+            params->frames.ppm = true;
+        } else if (strcmp(arg, "--record-input") == 0) {
+            if (!value) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "%s", "--record-input requires an output path");
+                }
+                return false;
+            }
+            copy_string(params->input.record_path, PARAMS_MAX_PATH_CHARS, value);
+            ++i;
+        } else if (strcmp(arg, "--replay-input") == 0) {
+            if (!value) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "%s", "--replay-input requires a recording path");
+                }
+                return false;
+            }
+            copy_string(params->input.replay_path, PARAMS_MAX_PATH_CHARS, value);
+            ++i;
+        } else if (strcmp(arg, "--replay-dt") == 0) {
+            if (!params_parse_float(value, &params->input.replay_dt) ||
+                params->input.replay_dt <= 0.0f || params->input.replay_dt > 1.0f) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "--replay-dt expects seconds in (0, 1] (got '%s')",
+                             value ? value : "");
+                }
+                return false;
+            }
+            ++i;
+        } else if (strcmp(arg, "--capture") == 0) {
+            if (!value) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "%s", "--capture requires a path prefix");
+                }
+                return false;
+            }
+            copy_string(params->capture.path_prefix, PARAMS_MAX_PATH_CHARS, value);
+            ++i;
+        } else if (strcmp(arg, "--capture-pipe") == 0) {
+            if (!value) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "%s", "--capture-pipe requires an encoder command");
+                }
+                return false;
+            }
+            copy_string(params->capture.pipe_command, PARAMS_MAX_COMMAND_CHARS, value);
+            ++i;
+        } else if (strcmp(arg, "--capture-every") == 0) {
+            if (!params_parse_u64(value, &number) || number == 0 || number > UINT32_MAX) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "--capture-every expects a frame count >= 1 (got '%s')",
+                             value ? value : "");
+                }
+                return false;
+            }
+            params->capture.every_frames = (uint32_t)number;
+            ++i;
+        } else if (strcmp(arg, "--capture-format") == 0) {
+            if (value && strcmp(value, "png") == 0) {
+                params->capture.format = CAPTURE_FORMAT_PNG;
+            } else if (value && strcmp(value, "ppm") == 0) {
+                params->capture.format = CAPTURE_FORMAT_PPM;
+            } else if (value && strcmp(value, "raw") == 0) {
+                params->capture.format = CAPTURE_FORMAT_RAW;
+            } else {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "--capture-format expects png, ppm or raw (got '%s')",
+                             value ? value : "");
+                }
+                return false;
+            }
+            ++i;
+        } else if (strcmp(arg, "--shader-cache") == 0) {
+            if (!value) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "%s", "--shader-cache requires a directory");
+                }
+                return false;
+            }
+            copy_string(params->shader_cache.dir, PARAMS_MAX_PATH_CHARS, value);
+            ++i;
+        } else if (strcmp(arg, "--traffic-cell") == 0) {
+            if (!params_parse_float(value, &params->traffic.cell_world) || params->traffic.cell_world < 0.0f) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "--traffic-cell expects a cell size >= 0 (got '%s')",
+                             value ? value : "");
+                }
+                return false;
+            }
+            ++i;
+        } else if (strcmp(arg, "--traffic-decay") == 0) {
+            if (!params_parse_float(value, &params->traffic.decay_sec) || params->traffic.decay_sec < 0.0f) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "--traffic-decay expects seconds >= 0 (got '%s')",
+                             value ? value : "");
+                }
+                return false;
+            }
+            ++i;
+        } else if (strcmp(arg, "--traffic-export") == 0) {
+            if (!value) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "%s", "--traffic-export requires a path prefix");
+                }
+                return false;
+            }
+            copy_string(params->traffic.export_prefix, PARAMS_MAX_PATH_CHARS, value);
+            ++i;
+        } else if (strcmp(arg, "--traffic-export-every") == 0) {
+            if (!params_parse_u64(value, &number) || number > UINT32_MAX) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "--traffic-export-every expects a tick count (got '%s')",
+                             value ? value : "");
+                }
+                return false;
+            }
+            params->traffic.export_every_ticks = (uint32_t)number;
+            ++i;
+        } else if (strcmp(arg, "--no-vsync") == 0) {
+            params->vsync_on = false;
+        } else if (strcmp(arg, "--fps") == 0) {
+            if (!params_parse_u64(value, &number) || number > 1000) {
+                if (err_buf && err_cap > 0) {
+                    snprintf(err_buf, err_cap, "--fps expects 0 (uncapped) to 1000 (got '%s')",
+                             value ? value : "");
+                }
+                return false;
+            }
+            params->frame_limit_fps = (int)number;
+            ++i;
+        } else {
+            if (err_buf && err_cap > 0) {
+                snprintf(err_buf, err_cap, "unknown option '%s'", arg);
+            }
+            return false;
+        }
+    }
+    if (err_buf && err_cap > 0) {
+        err_buf[0] = '\0';
+    }
+    return true;
 }
 
 bool params_validate(const Params *params, char *err_buf, size_t err_cap) {
@@ -138,6 +568,13 @@ bool params_validate(const Params *params, char *err_buf, size_t err_cap) {
         }
         return false;
     }
+    if (params->frame_limit_fps < 0 || params->frame_limit_fps > 1000) {
+        if (err_buf && err_cap > 0) {
+            snprintf(err_buf, err_cap, "frame_limit_fps (%d) must be within [0, 1000]",
+                     params->frame_limit_fps);
+        }
+        return false;
+    }
     if (params->window_height_px < 240) {
         if (err_buf && err_cap > 0) {
             snprintf(err_buf, err_cap, "window_height_px (%d) must be >= 240",
@@ -158,10 +595,10 @@ bool params_validate(const Params *params, char *err_buf, size_t err_cap) {
         }
         return false;
     }
-    if (params->bee_count == 0 || params->bee_count > 1000000) {
+    if (params->bee_count == 0 || params->bee_count > PARAMS_MAX_BEE_COUNT) {
         if (err_buf && err_cap > 0) {
             snprintf(err_buf, err_cap,
-                     "bee_count (%zu) must be within [1, 1000000]", params->bee_count);
+                     "bee_count (%zu) must be within [1, %u]", params->bee_count, PARAMS_MAX_BEE_COUNT);
         }
         return false;
     }
@@ -173,6 +610,13 @@ bool params_validate(const Params *params, char *err_buf, size_t err_cap) {
         }
         return false;
     }
+    if (params->hex.tile_size_px < 4.0f || params->hex.tile_size_px > 4096.0f) {
+        if (err_buf && err_cap > 0) {
+            snprintf(err_buf, err_cap, "hex tile_size_px (%.2f) must be within [4, 4096]",
+                     params->hex.tile_size_px);
+        }
+        return false;
+    }
     if (params->sim_fixed_dt <= 0.0f) {
         if (err_buf && err_cap > 0) {
             snprintf(err_buf, err_cap, "sim_fixed_dt (%f) must be > 0", params->sim_fixed_dt);
@@ -333,6 +777,39 @@ bool params_validate(const Params *params, char *err_buf, size_t err_cap) {
             return false;
         }
     }
+    if (params->capture.every_frames == 0) {
+        if (err_buf && err_cap > 0) {
+            snprintf(err_buf, err_cap, "%s", "capture every_frames must be >= 1");
+        }
+        return false;
+    }
+    if (params->capture.format < CAPTURE_FORMAT_PNG || params->capture.format > CAPTURE_FORMAT_RAW) {
+        if (err_buf && err_cap > 0) {
+            snprintf(err_buf, err_cap, "capture format (%d) must be %d-%d", params->capture.format,
+                     CAPTURE_FORMAT_PNG, CAPTURE_FORMAT_RAW);
+        }
+        return false;
+    }
+    if (params->capture.path_prefix[0] != '\0' && params->capture.pipe_command[0] != '\0') {
+        if (err_buf && err_cap > 0) {
+            snprintf(err_buf, err_cap, "%s", "capture to files or to a pipe, not both");
+        }
+        return false;
+    }
+    if (params->traffic.cell_world != 0.0f &&
+        (params->traffic.cell_world < 0.5f || params->traffic.cell_world > 4096.0f)) {
+        if (err_buf && err_cap > 0) {
+            snprintf(err_buf, err_cap, "traffic cell_world (%.2f) must be 0 (off) or within [0.5, 4096]",
+                     params->traffic.cell_world);
+        }
+        return false;
+    }
+    if (params->traffic.decay_sec < 0.0f) {
+        if (err_buf && err_cap > 0) {
+            snprintf(err_buf, err_cap, "traffic decay_sec (%.2f) must be >= 0", params->traffic.decay_sec);
+        }
+        return false;
+    }
     if (err_buf && err_cap > 0) {
         err_buf[0] = '\0';
     }
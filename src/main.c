@@ -5,12 +5,19 @@
 #include "util/log.h"
 
 int main(int argc, char **argv) {
-    (void)argc;
-    (void)argv;
-
     Params params;
     params_init_defaults(&params);
 
+    char err[256];
+    if (!params_apply_cli(&params, argc, argv, err, sizeof err)) {
+        LOG_ERROR("command line: %s", err);
+        return 1;
+    }
+
+    if (params.headless.ticks > 0) {
+        return app_run_headless(&params);
+    }
+
     if (!app_init(&params)) {
         LOG_ERROR("app_init failed; aborting");
         app_shutdown();
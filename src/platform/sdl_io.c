@@ -6,6 +6,7 @@
 #include <stdlib.h>
 
 #include "params.h"
+#include "util/alloc.h"
 #include "util/log.h"
 
 typedef struct PlatformState {
@@ -22,6 +23,11 @@ typedef struct PlatformState {
     bool prev_key_plus_down;
     bool prev_key_minus_down;
     bool prev_key_reset_down;
+    bool prev_key_m_down;
+    bool prev_key_f9_down;
+    bool prev_key_c_down;
+    bool prev_key_p_down;
+    bool prev_key_h_down;
     bool prev_mouse_left_down;
     bool prev_mouse_right_down;
     float prev_mouse_x_px;
@@ -52,7 +58,7 @@ static void platform_cleanup_partial(PlatformState *state) {
     if (state->window) {
         SDL_DestroyWindow(state->window);
     }
-    free(state);
+    mem_free(ALLOC_TAG_PLATFORM, state);
 
     if (SDL_WasInit(SDL_INIT_VIDEO)) {
         SDL_QuitSubSystem(SDL_INIT_VIDEO);
@@ -133,7 +139,7 @@ bool plat_init(Platform *plat, const Params *params) {
                  SDL_GetError());
     }
 
-    PlatformState *state = (PlatformState *)calloc(1, sizeof(PlatformState));
+    PlatformState *state = (PlatformState *)mem_calloc(ALLOC_TAG_PLATFORM, 1, sizeof(PlatformState));
     if (!state) {
         LOG_ERROR("Failed to allocate PlatformState");
         SDL_GL_MakeCurrent(window, NULL);
@@ -221,6 +227,11 @@ void plat_pump(Platform *plat, Input *out_input, Timing *out_timing) {
     bool plus_down = keyboard ? (keyboard[SDL_SCANCODE_EQUALS] || keyboard[SDL_SCANCODE_KP_PLUS]) : false;
     bool minus_down = keyboard ? (keyboard[SDL_SCANCODE_MINUS] || keyboard[SDL_SCANCODE_KP_MINUS]) : false;
     bool reset_down = keyboard ? (keyboard[SDL_SCANCODE_0] || keyboard[SDL_SCANCODE_KP_0]) : false;
+    bool m_down = keyboard ? keyboard[SDL_SCANCODE_M] != 0 : false;
+    bool f9_down = keyboard ? keyboard[SDL_SCANCODE_F9] != 0 : false;
+    bool c_down = keyboard ? keyboard[SDL_SCANCODE_C] != 0 : false;
+    bool p_down = keyboard ? keyboard[SDL_SCANCODE_P] != 0 : false;
+    bool h_down = keyboard ? keyboard[SDL_SCANCODE_H] != 0 : false;
 
     bool escape_pressed = escape_down && !state->prev_key_escape_down;
     bool space_pressed = space_down && !state->prev_key_space_down;
@@ -228,6 +239,11 @@ void plat_pump(Platform *plat, Input *out_input, Timing *out_timing) {
     bool plus_pressed = plus_down && !state->prev_key_plus_down;
     bool minus_pressed = minus_down && !state->prev_key_minus_down;
     bool reset_pressed = reset_down && !state->prev_key_reset_down;
+    bool m_pressed = m_down && !state->prev_key_m_down;
+    bool f9_pressed = f9_down && !state->prev_key_f9_down;
+    bool c_pressed = c_down && !state->prev_key_c_down;
+    bool p_pressed = p_down && !state->prev_key_p_down;
+    bool h_pressed = h_down && !state->prev_key_h_down;
 
     state->prev_key_escape_down = escape_down;
     state->prev_key_space_down = space_down;
@@ -235,6 +251,11 @@ void plat_pump(Platform *plat, Input *out_input, Timing *out_timing) {
     state->prev_key_plus_down = plus_down;
     state->prev_key_minus_down = minus_down;
     state->prev_key_reset_down = reset_down;
+    state->prev_key_m_down = m_down;
+    state->prev_key_f9_down = f9_down;
+    state->prev_key_c_down = c_down;
+    state->prev_key_p_down = p_down;
+    state->prev_key_h_down = h_down;
     state->prev_mouse_left_down = mouse_left_down;
     state->prev_mouse_right_down = mouse_right_down;
     state->prev_mouse_x_px = mouse_x_px;
@@ -252,6 +273,11 @@ void plat_pump(Platform *plat, Input *out_input, Timing *out_timing) {
     input.key_plus_pressed = plus_pressed;
     input.key_minus_pressed = minus_pressed;
     input.key_reset_pressed = reset_pressed;
+    input.key_m_pressed = m_pressed;
+    input.key_f9_pressed = f9_pressed;
+    input.key_c_pressed = c_pressed;
+    input.key_p_pressed = p_pressed;
+    input.key_h_pressed = h_pressed;
     input.key_w_down = keyboard ? keyboard[SDL_SCANCODE_W] != 0 : false;
     input.key_a_down = keyboard ? keyboard[SDL_SCANCODE_A] != 0 : false;
     input.key_s_down = keyboard ? keyboard[SDL_SCANCODE_S] != 0 : false;
@@ -317,6 +343,23 @@ void plat_shutdown(Platform *plat) {
     platform_cleanup_partial(state);
 }
 
+void plat_wait_events(Platform *plat, int timeout_ms) {
+    if (!plat || !plat->state) {
+        return;
+    }
+    // A NULL event leaves whatever woke us in the queue for plat_pump.
+    SDL_WaitEventTimeout(NULL, timeout_ms > 0 ? timeout_ms : 1);
+}
+
+bool plat_window_minimized(const Platform *plat) {
+    if (!plat || !plat->state) {
+        return false;
+    }
+    const PlatformState *state = (const PlatformState *)plat->state;
+    Uint32 flags = SDL_GetWindowFlags(state->window);
+    return (flags & (SDL_WINDOW_MINIMIZED | SDL_WINDOW_HIDDEN)) != 0;
+}
+
 bool plat_poll_resize(Platform *plat, int *out_fb_w, int *out_fb_h) {
     if (!plat || !plat->state) {
         return false;
@@ -2,22 +2,41 @@
 
 #include <glad/glad.h>
 
+#include <math.h>
 #include <stdint.h>
 #include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "params.h"
+#include "shader_cache.h"
+#include "util/alloc.h"
+#include "util/jobs.h"
 #include "util/log.h"
+#include "util/trace.h"
 
 typedef struct InstanceAttrib {
     float center[2];
     float radius;
-    unsigned char color[4];
+    uint32_t color;  // bytes R, G, B, A in memory (normalized ubyte attribute)
 } InstanceAttrib;
 
 #define INSTANCE_STRIDE ((GLsizei)sizeof(InstanceAttrib))
 
+// Bee instances live in a persistent buffer mirrored by instance_cpu_buffer.
+// Each frame a bee is repacked and compared with its mirrored copy; it is
+// marked dirty when its color or radius changed or its center moved by
+// RENDER_INSTANCE_EPSILON_PX on screen. Dirty state is kept per block of
+// RENDER_DIRTY_BLOCK instances (512 bytes); adjacent dirty blocks upload as
+// one glBufferSubData, and small clean gaps are bridged when the frame would
+// otherwise need more than RENDER_MAX_UPLOAD_RUNS calls.
+#define RENDER_INSTANCE_EPSILON_PX 0.1f
+#define RENDER_DIRTY_BLOCK 32
+#define RENDER_MAX_UPLOAD_RUNS 64
+#define RENDER_PACK_CHUNK 16384  // bees per packing job (a multiple of RENDER_DIRTY_BLOCK)
+#define RENDER_CAPTURE_RING 3    // readbacks in flight before new ones are skipped
+#define RENDER_CAPTURE_WAIT_NS 1000000000ull
+
 typedef struct LineVertex {
     float pos[2];
     float color[4];
@@ -25,6 +44,67 @@ typedef struct LineVertex {
 
 #define LINE_VERTEX_STRIDE ((GLsizei)sizeof(LineVertex))
 
+// Path overlay: every bee's planned route as instanced GL_LINES segments
+// built straight from the sim's path arrays. A segment is two world points
+// and a palette index (20 bytes, against 48 for a debug line); segments
+// whose bounding box misses the view are culled while packing. Chunks of
+// RENDER_PATH_CHUNK bees pack on the job pool into their own region of
+// path_segments (two slots per bee) and upload back to back.
+#define RENDER_PATH_CHUNK 8192
+
+typedef enum PathSegmentKind {
+    PATH_SEGMENT_DIRECT = 0,  // bee straight to its target
+    PATH_SEGMENT_LEG = 1,     // bee to its detour waypoint
+    PATH_SEGMENT_ONWARD = 2,  // detour waypoint on to the target
+    PATH_SEGMENT_KIND_COUNT   // size of u_palette in kPathVertexShaderSrc
+} PathSegmentKind;
+
+typedef struct PathSegment {
+    float start[2];
+    float end[2];
+    uint8_t palette;  // PathSegmentKind
+    uint8_t pad[3];
+} PathSegment;
+
+#define PATH_SEGMENT_STRIDE ((GLsizei)sizeof(PathSegment))
+
+static const float kPathPalette[PATH_SEGMENT_KIND_COUNT][4] = {
+    {0.95f, 0.95f, 0.95f, 0.22f},
+    {0.35f, 0.75f, 1.00f, 0.35f},
+    {1.00f, 0.70f, 0.25f, 0.22f},
+};
+
+// Static layer: patch discs and hive walls drawn into an offscreen texture
+// and copied to the backbuffer each frame. A rebuild is forced by any exact
+// change except the stock rings, which shrink a little every tick; those
+// only count once a ring radius moves by RENDER_STATIC_RING_TOLERANCE_PX on
+// screen or a ring color channel by RENDER_STATIC_COLOR_TOLERANCE levels.
+#define RENDER_STATIC_RING_TOLERANCE_PX 0.5f
+#define RENDER_STATIC_COLOR_TOLERANCE 4
+#define RENDER_WALL_VERTICES 6  // two triangles per wall
+
+typedef struct StaticPatch {
+    float center[2];
+    float radius;
+    float ring_radius;
+    uint32_t fill_rgba;
+    uint32_t ring_rgba;
+} StaticPatch;
+
+typedef struct StaticWall {
+    float xy[4];
+    uint32_t rgba;
+} StaticWall;
+
+typedef struct CaptureSlot {
+    GLuint pbo;
+    GLsync fence;  // set while the readback is in flight
+    size_t bytes;  // size of pbo
+    int width;
+    int height;
+    uint64_t frame_id;
+} CaptureSlot;
+
 typedef struct RenderState {
     float clear_color[4];
     float default_color[4];
@@ -32,10 +112,11 @@ typedef struct RenderState {
     float default_radius_px;
     int fb_width;
     int fb_height;
+    JobPool *jobs;
     GLuint program;
     GLuint vao;
     GLuint quad_vbo;
-   GLuint instance_vbo;
+    GLuint instance_vbo;
     GLint u_screen;
     GLint u_cam_center;
     GLint u_cam_zoom;
@@ -43,7 +124,11 @@ typedef struct RenderState {
     float cam_zoom;
     size_t instance_capacity;
     size_t instance_buffer_size;
-    unsigned char *instance_cpu_buffer;
+    unsigned char *instance_cpu_buffer;  // what instance_vbo holds for bees
+    uint8_t *instance_dirty;             // one flag per RENDER_DIRTY_BLOCK instances
+    size_t instance_uploaded_count;      // bees in instance_vbo; 0 forces a full upload
+    float instance_uploaded_zoom;
+    uint64_t instance_upload_bytes;
     GLuint line_program;
     GLuint line_vao;
     GLuint line_vbo;
@@ -53,6 +138,53 @@ typedef struct RenderState {
     size_t line_capacity;
     size_t line_buffer_size;
     float *line_cpu_buffer;
+    GLuint path_program;
+    GLuint path_vao;
+    GLuint path_t_vbo;           // {0, 1}: segment start and end
+    GLuint path_vbo;
+    GLint path_u_screen;
+    GLint path_u_cam_center;
+    GLint path_u_cam_zoom;
+    PathSegment *path_segments;  // two slots per bee, filled from the front of each chunk
+    size_t *path_chunk_counts;   // visible segments per RENDER_PATH_CHUNK bees
+    size_t path_capacity;        // bees the path buffers fit
+    size_t path_segment_count;   // drawn by the last frame
+    GLuint traffic_program;
+    GLuint traffic_vao;          // quad_vbo stretched over the heatmap extent
+    GLuint traffic_texture;      // GL_R8, one texel per cell
+    GLint traffic_u_screen;
+    GLint traffic_u_cam_center;
+    GLint traffic_u_cam_zoom;
+    GLint traffic_u_extent;
+    int traffic_cols;            // size of traffic_texture; 0 before the first upload
+    int traffic_rows;
+    uint64_t traffic_version;    // RenderView::traffic_version last uploaded
+    GLuint wall_vao;
+    GLuint wall_vbo;
+    size_t wall_vertex_capacity;
+    LineVertex *wall_cpu_buffer;
+    GLuint static_fbo;
+    GLuint static_texture;
+    int static_width;             // size of static_texture; 0 before the first frame
+    int static_height;
+    bool static_unsupported;      // incomplete framebuffer; draw the layer directly
+    bool static_valid;
+    GLuint patch_vao;
+    GLuint patch_vbo;
+    InstanceAttrib *patch_instances;
+    size_t patch_instance_capacity;
+    float static_cam_center[2];   // inputs the cached layer was drawn with
+    float static_cam_zoom;
+    float static_clear_color[4];
+    StaticPatch *static_patches;
+    size_t static_patch_count;
+    size_t static_patch_capacity;
+    StaticWall *static_walls;
+    size_t static_wall_count;
+    size_t static_wall_capacity;
+    CaptureSlot capture_slots[RENDER_CAPTURE_RING];
+    uint32_t capture_head;       // next slot read into
+    uint32_t capture_in_flight;  // slots awaiting collection, oldest just behind head
 } RenderState;
 
 static void destroy_render_state(RenderState *state) {
@@ -71,6 +203,12 @@ static void destroy_render_state(RenderState *state) {
     if (state->instance_vbo) {
         glDeleteBuffers(1, &state->instance_vbo);
     }
+    if (state->patch_vao) {
+        glDeleteVertexArrays(1, &state->patch_vao);
+    }
+    if (state->patch_vbo) {
+        glDeleteBuffers(1, &state->patch_vbo);
+    }
     if (state->line_program) {
         glDeleteProgram(state->line_program);
     }
@@ -80,47 +218,58 @@ static void destroy_render_state(RenderState *state) {
     if (state->line_vbo) {
         glDeleteBuffers(1, &state->line_vbo);
     }
-    free(state->instance_cpu_buffer);
-    free(state->line_cpu_buffer);
-    free(state);
-}
-
-static GLuint compile_shader(GLenum type, const char *src, char *log_buf, size_t log_cap) {
-    GLuint shader = glCreateShader(type);
-    glShaderSource(shader, 1, &src, NULL);
-    glCompileShader(shader);
-    GLint status = GL_FALSE;
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
-    if (status != GL_TRUE) {
-        if (log_buf && log_cap > 0) {
-            glGetShaderInfoLog(shader, (GLsizei)log_cap, NULL, log_buf);
-        }
-        return 0;
+    if (state->path_program) {
+        glDeleteProgram(state->path_program);
     }
-    if (log_buf && log_cap > 0) {
-        log_buf[0] = '\0';
+    if (state->path_vao) {
+        glDeleteVertexArrays(1, &state->path_vao);
     }
-    return shader;
-}
-
-static GLuint link_program(GLuint vs, GLuint fs, char *log_buf, size_t log_cap) {
-    GLuint program = glCreateProgram();
-    glAttachShader(program, vs);
-    glAttachShader(program, fs);
-    glLinkProgram(program);
-    GLint status = GL_FALSE;
-    glGetProgramiv(program, GL_LINK_STATUS, &status);
-    if (status != GL_TRUE) {
-        if (log_buf && log_cap > 0) {
-            glGetProgramInfoLog(program, (GLsizei)log_cap, NULL, log_buf);
-        }
-        glDeleteProgram(program);
-        return 0;
+    if (state->path_t_vbo) {
+        glDeleteBuffers(1, &state->path_t_vbo);
+    }
+    if (state->path_vbo) {
+        glDeleteBuffers(1, &state->path_vbo);
+    }
+    if (state->traffic_program) {
+        glDeleteProgram(state->traffic_program);
+    }
+    if (state->traffic_vao) {
+        glDeleteVertexArrays(1, &state->traffic_vao);
+    }
+    if (state->traffic_texture) {
+        glDeleteTextures(1, &state->traffic_texture);
+    }
+    if (state->wall_vao) {
+        glDeleteVertexArrays(1, &state->wall_vao);
+    }
+    if (state->wall_vbo) {
+        glDeleteBuffers(1, &state->wall_vbo);
     }
-    if (log_buf && log_cap > 0) {
-        log_buf[0] = '\0';
+    if (state->static_fbo) {
+        glDeleteFramebuffers(1, &state->static_fbo);
     }
-    return program;
+    if (state->static_texture) {
+        glDeleteTextures(1, &state->static_texture);
+    }
+    for (int i = 0; i < RENDER_CAPTURE_RING; ++i) {
+        CaptureSlot *slot = &state->capture_slots[i];
+        if (slot->fence) {
+            glDeleteSync(slot->fence);
+        }
+        if (slot->pbo) {
+            glDeleteBuffers(1, &slot->pbo);
+        }
+    }
+    mem_free(ALLOC_TAG_RENDER, state->instance_cpu_buffer);
+    mem_free(ALLOC_TAG_RENDER, state->instance_dirty);
+    mem_free(ALLOC_TAG_RENDER, state->patch_instances);
+    mem_free(ALLOC_TAG_RENDER, state->line_cpu_buffer);
+    mem_free(ALLOC_TAG_RENDER, state->wall_cpu_buffer);
+    mem_free(ALLOC_TAG_RENDER, state->path_segments);
+    mem_free(ALLOC_TAG_RENDER, state->path_chunk_counts);
+    mem_free(ALLOC_TAG_RENDER, state->static_patches);
+    mem_free(ALLOC_TAG_RENDER, state->static_walls);
+    mem_free(ALLOC_TAG_RENDER, state);
 }
 
 static const char *kVertexShaderSrc =
@@ -190,6 +339,61 @@ static const char *kLineFragmentShaderSrc =
     "    frag_color = v_color_rgba;\n"
     "}\n";
 
+static const char *kPathVertexShaderSrc =
+    "#version 330 core\n"
+    "layout(location=0) in float a_t;\n"
+    "layout(location=1) in vec4 a_segment_world;\n"
+    "layout(location=2) in float a_palette;\n"
+    "uniform vec2 u_screen;\n"
+    "uniform vec2 u_cam_center;\n"
+    "uniform float u_cam_zoom;\n"
+    "uniform vec4 u_palette[3];\n"
+    "out vec4 v_color_rgba;\n"
+    "void main() {\n"
+    "    vec2 world = mix(a_segment_world.xy, a_segment_world.zw, a_t);\n"
+    "    vec2 px = (world - u_cam_center) * u_cam_zoom + 0.5 * u_screen;\n"
+    "    vec2 ndc;\n"
+    "    ndc.x = (px.x / u_screen.x) * 2.0 - 1.0;\n"
+    "    ndc.y = 1.0 - (px.y / u_screen.y) * 2.0;\n"
+    "    gl_Position = vec4(ndc, 0.0, 1.0);\n"
+    "    v_color_rgba = u_palette[int(a_palette)];\n"
+    "}\n";
+
+// The quad covers the heatmap grid in world space; texel (0, 0) is the cell
+// at world (0, 0), so texture coordinates are the quad corners themselves.
+static const char *kTrafficVertexShaderSrc =
+    "#version 330 core\n"
+    "layout(location=0) in vec2 a_pos;\n"
+    "uniform vec2 u_screen;\n"
+    "uniform vec2 u_cam_center;\n"
+    "uniform float u_cam_zoom;\n"
+    "uniform vec2 u_extent;\n"
+    "out vec2 v_uv;\n"
+    "void main() {\n"
+    "    vec2 px = (a_pos * u_extent - u_cam_center) * u_cam_zoom + 0.5 * u_screen;\n"
+    "    vec2 ndc;\n"
+    "    ndc.x = (px.x / u_screen.x) * 2.0 - 1.0;\n"
+    "    ndc.y = 1.0 - (px.y / u_screen.y) * 2.0;\n"
+    "    gl_Position = vec4(ndc, 0.0, 1.0);\n"
+    "    v_uv = a_pos;\n"
+    "}\n";
+
+// Black-body style ramp: dark red through orange to pale yellow, fading in
+// with intensity so quiet cells leave the background visible.
+static const char *kTrafficFragmentShaderSrc =
+    "#version 330 core\n"
+    "in vec2 v_uv;\n"
+    "uniform sampler2D u_traffic;\n"
+    "out vec4 frag_color;\n"
+    "void main() {\n"
+    "    float t = texture(u_traffic, v_uv).r;\n"
+    "    if (t <= 0.0) {\n"
+    "        discard;\n"
+    "    }\n"
+    "    vec3 heat = clamp(vec3(3.0 * t, 3.0 * t - 1.0, 3.0 * t - 2.0), 0.0, 1.0);\n"
+    "    frag_color = vec4(mix(vec3(0.35, 0.0, 0.0), vec3(1.0), heat), 0.15 + 0.6 * t);\n"
+    "}\n";
+
 static float clamp01(float v) {
     if (v < 0.0f) {
         return 0.0f;
@@ -200,14 +404,14 @@ static float clamp01(float v) {
     return v;
 }
 
-static void configure_instance_attribs(RenderState *state) {
-    glBindVertexArray(state->vao);
+static void configure_instance_attribs(const RenderState *state, GLuint vao, GLuint instance_vbo) {
+    glBindVertexArray(vao);
 
     glBindBuffer(GL_ARRAY_BUFFER, state->quad_vbo);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void *)0);
 
-    glBindBuffer(GL_ARRAY_BUFFER, state->instance_vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, instance_vbo);
     glEnableVertexAttribArray(1);
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, INSTANCE_STRIDE, (void *)0);
     glVertexAttribDivisor(1, 1);
@@ -224,9 +428,9 @@ static void configure_instance_attribs(RenderState *state) {
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
-static void configure_line_attribs(RenderState *state) {
-    glBindVertexArray(state->line_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, state->line_vbo);
+static void configure_line_attribs(GLuint vao, GLuint vbo) {
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, LINE_VERTEX_STRIDE, (void *)offsetof(LineVertex, pos));
     glEnableVertexAttribArray(1);
@@ -235,6 +439,64 @@ static void configure_line_attribs(RenderState *state) {
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
+static void configure_path_attribs(const RenderState *state) {
+    glBindVertexArray(state->path_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, state->path_t_vbo);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void *)0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, state->path_vbo);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, PATH_SEGMENT_STRIDE, (void *)offsetof(PathSegment, start));
+    glVertexAttribDivisor(1, 1);
+
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 1, GL_UNSIGNED_BYTE, GL_FALSE, PATH_SEGMENT_STRIDE,
+                          (void *)offsetof(PathSegment, palette));
+    glVertexAttribDivisor(2, 1);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+static bool ensure_path_capacity(RenderState *state, size_t bee_count) {
+    if (bee_count <= state->path_capacity) {
+        return true;
+    }
+    size_t old_capacity = state->path_capacity;
+    size_t new_capacity = old_capacity ? old_capacity : RENDER_PATH_CHUNK;
+    while (new_capacity < bee_count) {
+        if (new_capacity > SIZE_MAX / (4 * sizeof(PathSegment))) {
+            LOG_ERROR("render: path capacity overflow (requested %zu)", bee_count);
+            return false;
+        }
+        new_capacity *= 2;
+    }
+    size_t segment_bytes = new_capacity * 2 * sizeof(PathSegment);
+    size_t chunk_count = (new_capacity + RENDER_PATH_CHUNK - 1) / RENDER_PATH_CHUNK;
+    PathSegment *segments = (PathSegment *)mem_realloc(ALLOC_TAG_RENDER, state->path_segments, segment_bytes);
+    if (segments) {
+        state->path_segments = segments;
+    }
+    size_t *chunk_counts = (size_t *)mem_realloc(ALLOC_TAG_RENDER, state->path_chunk_counts,
+                                                 chunk_count * sizeof(size_t));
+    if (chunk_counts) {
+        state->path_chunk_counts = chunk_counts;
+    }
+    if (!segments || !chunk_counts) {
+        LOG_ERROR("render: failed to grow path buffers to %zu bees", new_capacity);
+        return false;
+    }
+    state->path_capacity = new_capacity;
+
+    glBindBuffer(GL_ARRAY_BUFFER, state->path_vbo);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)segment_bytes, NULL, GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    LOG_INFO("render: path buffer grow old=%zu new=%zu bytes=%zu", old_capacity, new_capacity, segment_bytes);
+    return true;
+}
+
 static bool ensure_line_capacity(RenderState *state, size_t desired_count) {
     if (desired_count == 0) {
         return true;
@@ -255,7 +517,7 @@ static bool ensure_line_capacity(RenderState *state, size_t desired_count) {
 
     size_t vertex_count = new_capacity * 2;
     size_t new_bytes = vertex_count * sizeof(LineVertex);
-    float *cpu_buffer = (float *)realloc(state->line_cpu_buffer, new_bytes);
+    float *cpu_buffer = (float *)mem_realloc(ALLOC_TAG_RENDER, state->line_cpu_buffer, new_bytes);
     if (!cpu_buffer) {
         LOG_ERROR("render: failed to resize line CPU buffer to %zu bytes", new_bytes);
         return false;
@@ -267,7 +529,7 @@ static bool ensure_line_capacity(RenderState *state, size_t desired_count) {
     glBindBuffer(GL_ARRAY_BUFFER, state->line_vbo);
     glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)new_bytes, NULL, GL_STREAM_DRAW);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
-    configure_line_attribs(state);
+    configure_line_attribs(state->line_vao, state->line_vbo);
 
     LOG_INFO("render: line buffer grow old=%zu new=%zu bytes=%zu",
              old_capacity, new_capacity, new_bytes);
@@ -297,78 +559,627 @@ static bool ensure_instance_capacity(RenderState *state, size_t desired_count) {
     }
 
     size_t new_bytes = new_capacity * (size_t)INSTANCE_STRIDE;
-    unsigned char *cpu_buffer = (unsigned char *)realloc(state->instance_cpu_buffer, new_bytes);
+    unsigned char *cpu_buffer = (unsigned char *)mem_realloc(ALLOC_TAG_RENDER, state->instance_cpu_buffer, new_bytes);
     if (!cpu_buffer) {
         LOG_ERROR("render: failed to resize instance CPU buffer to %zu bytes", new_bytes);
         return false;
     }
     state->instance_cpu_buffer = cpu_buffer;
+    size_t block_count = (new_capacity + RENDER_DIRTY_BLOCK - 1) / RENDER_DIRTY_BLOCK;
+    uint8_t *dirty = (uint8_t *)mem_realloc(ALLOC_TAG_RENDER, state->instance_dirty, block_count);
+    if (!dirty) {
+        LOG_ERROR("render: failed to resize instance dirty flags to %zu blocks", block_count);
+        return false;
+    }
+    memset(dirty, 0, block_count);
+    state->instance_dirty = dirty;
     state->instance_capacity = new_capacity;
     state->instance_buffer_size = new_bytes;
+    state->instance_uploaded_count = 0;
 
     glBindBuffer(GL_ARRAY_BUFFER, state->instance_vbo);
-    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)new_bytes, NULL, GL_STREAM_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)new_bytes, NULL, GL_DYNAMIC_DRAW);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
-    configure_instance_attribs(state);
+    configure_instance_attribs(state, state->vao, state->instance_vbo);
 
     LOG_INFO("render: instance buffer grow old=%zu new=%zu bytes=%zu",
              old_capacity, new_capacity, new_bytes);
     return true;
 }
 
-static void pack_instance_batch(RenderState *state,
-                                size_t offset,
+// 0xRRGGBBAA to R, G, B, A byte order on little-endian hosts (every
+// supported target); compilers turn this into a bswap, or a byte shuffle
+// when the loop around it is vectorized.
+static inline uint32_t rgba_to_bytes(uint32_t packed) {
+    return (packed >> 24) | ((packed >> 8) & 0x0000FF00u) | ((packed << 8) & 0x00FF0000u) | (packed << 24);
+}
+
+static inline void pack_instance(const RenderState *state,
+                                 const float *positions_xy,
+                                 const float *radii_px,
+                                 const uint32_t *color_rgba,
+                                 size_t i,
+                                 InstanceAttrib *out) {
+    const float default_radius = state->default_radius_px > 0.0f ? state->default_radius_px : 1.0f;
+    float cx = positions_xy ? positions_xy[i * 2 + 0] : state->fb_width * 0.5f;
+    float cy = positions_xy ? positions_xy[i * 2 + 1] : state->fb_height * 0.5f;
+    float radius = radii_px ? radii_px[i] : default_radius;
+    if (!radii_px && radius <= 0.0f) {
+        radius = default_radius;
+    }
+    if (radius < 0.0f) {
+        radius = 0.0f;
+    }
+
+    out->center[0] = cx;
+    out->center[1] = cy;
+    out->radius = radius;
+    if (color_rgba) {
+        out->color = rgba_to_bytes(color_rgba[i]);
+    } else {
+        memcpy(&out->color, state->default_color_rgba, sizeof(out->color));
+    }
+}
+
+static void pack_instance_batch(const RenderState *state,
+                                InstanceAttrib *attribs,
                                 const float *positions_xy,
                                 const float *radii_px,
                                 const uint32_t *color_rgba,
                                 size_t count) {
-    if (!state->instance_cpu_buffer || count == 0) {
+    for (size_t i = 0; i < count; ++i) {
+        pack_instance(state, positions_xy, radii_px, color_rgba, i, &attribs[i]);
+    }
+}
+
+typedef struct BeePackJob {
+    RenderState *state;
+    const RenderView *view;
+    size_t count;
+    float epsilon_world;
+    bool full;
+    volatile int64_t dirty_blocks;
+} BeePackJob;
+
+// Straight-line pack for a view with every bee array present: no per-bee
+// branches, so the loop vectorizes (the color swizzle becomes a byte
+// shuffle).
+static void pack_bee_range(InstanceAttrib *restrict out,
+                           const float *restrict xy,
+                           const float *restrict radii,
+                           const uint32_t *restrict colors,
+                           size_t begin,
+                           size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        float radius = radii[i];
+        out[i].center[0] = xy[i * 2 + 0];
+        out[i].center[1] = xy[i * 2 + 1];
+        out[i].radius = radius < 0.0f ? 0.0f : radius;
+        out[i].color = rgba_to_bytes(colors[i]);
+    }
+}
+
+static bool bee_range_changed(const InstanceAttrib *restrict mirror,
+                              const float *restrict xy,
+                              const float *restrict radii,
+                              const uint32_t *restrict colors,
+                              size_t begin,
+                              size_t end,
+                              float epsilon_world) {
+    int changed = 0;
+    for (size_t i = begin; i < end; ++i) {
+        float radius = radii[i] < 0.0f ? 0.0f : radii[i];
+        changed |= (fabsf(xy[i * 2 + 0] - mirror[i].center[0]) >= epsilon_world) |
+                   (fabsf(xy[i * 2 + 1] - mirror[i].center[1]) >= epsilon_world) |
+                   (radius != mirror[i].radius) | (rgba_to_bytes(colors[i]) != mirror[i].color);
+    }
+    return changed != 0;
+}
+
+// Packs bees [chunk * RENDER_PACK_CHUNK, ...) block by block. A block whose
+// bees all stay within the epsilon is left alone; otherwise the whole block
+// is repacked exactly and flagged. Chunks write disjoint mirror ranges and
+// flags, so they run on any worker.
+static void pack_bee_chunks(void *user, size_t chunk_begin, size_t chunk_end) {
+    BeePackJob *job = (BeePackJob *)user;
+    RenderState *state = job->state;
+    const RenderView *view = job->view;
+    InstanceAttrib *mirror = (InstanceAttrib *)state->instance_cpu_buffer;
+    const bool fast = view->positions_xy && view->radii_px && view->color_rgba;
+    size_t begin_all = chunk_begin * RENDER_PACK_CHUNK;
+    size_t end_all = chunk_end * RENDER_PACK_CHUNK < job->count ? chunk_end * RENDER_PACK_CHUNK : job->count;
+    int64_t dirty_blocks = 0;
+    for (size_t begin = begin_all; begin < end_all; begin += RENDER_DIRTY_BLOCK) {
+        size_t end = begin + RENDER_DIRTY_BLOCK < end_all ? begin + RENDER_DIRTY_BLOCK : end_all;
+        bool dirty = job->full || !fast ||
+                     bee_range_changed(mirror, view->positions_xy, view->radii_px, view->color_rgba, begin, end,
+                                       job->epsilon_world);
+        if (dirty && fast) {
+            pack_bee_range(mirror, view->positions_xy, view->radii_px, view->color_rgba, begin, end);
+        } else if (dirty) {
+            InstanceAttrib packed[RENDER_DIRTY_BLOCK];
+            pack_instance_batch(state, packed, view->positions_xy ? view->positions_xy + begin * 2 : NULL,
+                                view->radii_px ? view->radii_px + begin : NULL,
+                                view->color_rgba ? view->color_rgba + begin : NULL, end - begin);
+            dirty = job->full || memcmp(packed, &mirror[begin], (end - begin) * sizeof(InstanceAttrib)) != 0;
+            memcpy(&mirror[begin], packed, (end - begin) * sizeof(InstanceAttrib));
+        }
+        state->instance_dirty[begin / RENDER_DIRTY_BLOCK] = dirty ? 1u : 0u;
+        dirty_blocks += dirty ? 1 : 0;
+    }
+    atomic_fetch_add_i64(&job->dirty_blocks, dirty_blocks);
+}
+
+// Repacks bees into the mirror on the job pool and flags the blocks whose
+// contents changed. Returns the number of dirty blocks. With `full` every
+// block is rewritten and flagged.
+static size_t pack_bee_instances(RenderState *state, const RenderView *view, size_t count, bool full) {
+    BeePackJob job = {0};
+    job.state = state;
+    job.view = view;
+    job.count = count;
+    job.epsilon_world = RENDER_INSTANCE_EPSILON_PX / (state->cam_zoom > 0.0f ? state->cam_zoom : 1.0f);
+    job.full = full;
+    size_t chunk_count = (count + RENDER_PACK_CHUNK - 1) / RENDER_PACK_CHUNK;
+    JobCounter done = {0};
+    jobs_parallel_for(state->jobs, chunk_count, 1, pack_bee_chunks, &job, &done);
+    jobs_wait(state->jobs, &done);
+    return (size_t)atomic_load_i64(&job.dirty_blocks);
+}
+
+// Number of uploads needed when runs of dirty blocks separated by at most
+// `gap` clean blocks are sent as one.
+static size_t count_upload_runs(const uint8_t *dirty, size_t first, size_t last, size_t gap) {
+    size_t runs = 0;
+    size_t clean = gap + 1;
+    for (size_t block = first; block <= last; ++block) {
+        if (!dirty[block]) {
+            ++clean;
+            continue;
+        }
+        runs += clean > gap ? 1u : 0u;
+        clean = 0;
+    }
+    return runs;
+}
+
+// Sends the dirty blocks of the first `count` bees and clears their flags.
+// Runs of dirty blocks are coalesced, bridging ever wider clean gaps until
+// at most RENDER_MAX_UPLOAD_RUNS glBufferSubData calls remain.
+static void upload_bee_instances(RenderState *state, size_t count, size_t dirty_blocks) {
+    if (dirty_blocks == 0) {
         return;
     }
+    const uint8_t *dirty = state->instance_dirty;
+    size_t block_count = (count + RENDER_DIRTY_BLOCK - 1) / RENDER_DIRTY_BLOCK;
+    size_t first = 0;
+    while (!dirty[first]) {
+        ++first;
+    }
+    size_t last = block_count - 1;
+    while (!dirty[last]) {
+        --last;
+    }
+    size_t gap = 0;
+    while (count_upload_runs(dirty, first, last, gap) > RENDER_MAX_UPLOAD_RUNS) {
+        gap = gap ? gap * 2 : 1;
+    }
 
-    InstanceAttrib *attribs = (InstanceAttrib *)state->instance_cpu_buffer + offset;
-    const float default_cx = state->fb_width * 0.5f;
-    const float default_cy = state->fb_height * 0.5f;
-    const float default_radius = state->default_radius_px > 0.0f ? state->default_radius_px : 1.0f;
-    const unsigned char def_r = state->default_color_rgba[0];
-    const unsigned char def_g = state->default_color_rgba[1];
-    const unsigned char def_b = state->default_color_rgba[2];
-    const unsigned char def_a = state->default_color_rgba[3];
+    const size_t stride = (size_t)INSTANCE_STRIDE;
+    glBindBuffer(GL_ARRAY_BUFFER, state->instance_vbo);
+    size_t block = first;
+    while (block <= last) {
+        size_t run_end = block + 1;  // one past the last dirty block of the run
+        for (size_t next = run_end; next <= last && next - run_end <= gap; ++next) {
+            if (dirty[next]) {
+                run_end = next + 1;
+            }
+        }
+        size_t begin = block * RENDER_DIRTY_BLOCK;
+        size_t end = run_end * RENDER_DIRTY_BLOCK < count ? run_end * RENDER_DIRTY_BLOCK : count;
+        glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)(begin * stride), (GLsizeiptr)((end - begin) * stride),
+                        state->instance_cpu_buffer + begin * stride);
+        state->instance_upload_bytes += (uint64_t)((end - begin) * stride);
+        block = run_end;
+        while (block <= last && !dirty[block]) {
+            ++block;
+        }
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    memset(state->instance_dirty + first, 0, last - first + 1);
+}
 
-    for (size_t i = 0; i < count; ++i) {
-        float cx = positions_xy ? positions_xy[i * 2 + 0] : default_cx;
-        float cy = positions_xy ? positions_xy[i * 2 + 1] : default_cy;
-        float radius = radii_px ? radii_px[i] : default_radius;
-        if (!radii_px && radius <= 0.0f) {
-            radius = default_radius;
+typedef struct PathPackJob {
+    RenderState *state;
+    const RenderView *view;
+    size_t count;
+    float view_min[2];  // visible world rectangle
+    float view_max[2];
+} PathPackJob;
+
+// Writes the segment into out[0] and returns 1 when its bounding box meets
+// the view, 0 otherwise (the slot is then reused by the next segment).
+static inline size_t emit_path_segment(PathSegment *out,
+                                       const PathPackJob *job,
+                                       float ax,
+                                       float ay,
+                                       float bx,
+                                       float by,
+                                       PathSegmentKind kind) {
+    out->start[0] = ax;
+    out->start[1] = ay;
+    out->end[0] = bx;
+    out->end[1] = by;
+    out->palette = (uint8_t)kind;
+    bool visible = fminf(ax, bx) <= job->view_max[0] && fmaxf(ax, bx) >= job->view_min[0] &&
+                   fminf(ay, by) <= job->view_max[1] && fmaxf(ay, by) >= job->view_min[1];
+    return visible ? 1u : 0u;
+}
+
+static void pack_path_chunks(void *user, size_t chunk_begin, size_t chunk_end) {
+    PathPackJob *job = (PathPackJob *)user;
+    const RenderView *view = job->view;
+    const float *xy = view->positions_xy;
+    const float eps = 1e-3f;
+    for (size_t chunk = chunk_begin; chunk < chunk_end; ++chunk) {
+        size_t begin = chunk * RENDER_PATH_CHUNK;
+        size_t end = begin + RENDER_PATH_CHUNK < job->count ? begin + RENDER_PATH_CHUNK : job->count;
+        PathSegment *out = job->state->path_segments + begin * 2;
+        size_t n = 0;
+        for (size_t i = begin; i < end; ++i) {
+            if (!view->path_valid[i]) {
+                continue;
+            }
+            float px = xy[i * 2 + 0];
+            float py = xy[i * 2 + 1];
+            float tx = view->path_target_x[i];
+            float ty = view->path_target_y[i];
+            float wx = view->path_waypoint_x[i];
+            float wy = view->path_waypoint_y[i];
+            if (view->path_has_waypoint[i] && (fabsf(wx - tx) > eps || fabsf(wy - ty) > eps)) {
+                n += emit_path_segment(&out[n], job, px, py, wx, wy, PATH_SEGMENT_LEG);
+                n += emit_path_segment(&out[n], job, wx, wy, tx, ty, PATH_SEGMENT_ONWARD);
+            } else {
+                n += emit_path_segment(&out[n], job, px, py, tx, ty, PATH_SEGMENT_DIRECT);
+            }
+        }
+        job->state->path_chunk_counts[chunk] = n;
+    }
+}
+
+// Builds the visible path segments on the job pool, uploads them into the
+// orphaned path buffer and returns how many there are.
+static size_t build_path_segments(RenderState *state, const RenderView *view, size_t count) {
+    PathPackJob job = {0};
+    job.state = state;
+    job.view = view;
+    job.count = count;
+    float zoom = state->cam_zoom > 0.0f ? state->cam_zoom : 1.0f;
+    float half_w = 0.5f * (float)state->fb_width / zoom;
+    float half_h = 0.5f * (float)state->fb_height / zoom;
+    job.view_min[0] = state->cam_center[0] - half_w;
+    job.view_min[1] = state->cam_center[1] - half_h;
+    job.view_max[0] = state->cam_center[0] + half_w;
+    job.view_max[1] = state->cam_center[1] + half_h;
+    size_t chunk_count = (count + RENDER_PATH_CHUNK - 1) / RENDER_PATH_CHUNK;
+    JobCounter done = {0};
+    jobs_parallel_for(state->jobs, chunk_count, 1, pack_path_chunks, &job, &done);
+    jobs_wait(state->jobs, &done);
+
+    glBindBuffer(GL_ARRAY_BUFFER, state->path_vbo);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(state->path_capacity * 2 * sizeof(PathSegment)), NULL,
+                 GL_STREAM_DRAW);
+    size_t total = 0;
+    for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+        size_t n = state->path_chunk_counts[chunk];
+        if (n == 0) {
+            continue;
+        }
+        glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)(total * sizeof(PathSegment)),
+                        (GLsizeiptr)(n * sizeof(PathSegment)),
+                        state->path_segments + chunk * RENDER_PATH_CHUNK * 2);
+        total += n;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return total;
+}
+
+static void draw_path_segments(const RenderState *state, size_t count) {
+    glUseProgram(state->path_program);
+    glUniform2f(state->path_u_screen, (float)state->fb_width, (float)state->fb_height);
+    glUniform2f(state->path_u_cam_center, state->cam_center[0], state->cam_center[1]);
+    glUniform1f(state->path_u_cam_zoom, state->cam_zoom > 0.0f ? state->cam_zoom : 1.0f);
+    glBindVertexArray(state->path_vao);
+    glDrawArraysInstanced(GL_LINES, 0, 2, (GLsizei)count);
+    glBindVertexArray(0);
+    glUseProgram(0);
+}
+
+static void draw_instances(const RenderState *state, GLuint vao, size_t count) {
+    glUseProgram(state->program);
+    glUniform2f(state->u_screen, (float)state->fb_width, (float)state->fb_height);
+    glUniform2f(state->u_cam_center, state->cam_center[0], state->cam_center[1]);
+    glUniform1f(state->u_cam_zoom, state->cam_zoom > 0.0f ? state->cam_zoom : 1.0f);
+    glBindVertexArray(vao);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)count);
+    glBindVertexArray(0);
+    glUseProgram(0);
+}
+
+// Uploads the heatmap only when the sim produced a new one or the grid
+// changed size; most frames between ticks reuse the texture as is.
+static void upload_traffic(RenderState *state, const RenderView *view) {
+    glBindTexture(GL_TEXTURE_2D, state->traffic_texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    if (view->traffic_cols != state->traffic_cols || view->traffic_rows != state->traffic_rows) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, view->traffic_cols, view->traffic_rows, 0, GL_RED,
+                     GL_UNSIGNED_BYTE, view->traffic_intensity);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        state->traffic_cols = view->traffic_cols;
+        state->traffic_rows = view->traffic_rows;
+        LOG_INFO("render: traffic texture %dx%d", state->traffic_cols, state->traffic_rows);
+    } else {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, view->traffic_cols, view->traffic_rows, GL_RED, GL_UNSIGNED_BYTE,
+                        view->traffic_intensity);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    state->traffic_version = view->traffic_version;
+}
+
+static void draw_traffic(const RenderState *state, const RenderView *view) {
+    glUseProgram(state->traffic_program);
+    glUniform2f(state->traffic_u_screen, (float)state->fb_width, (float)state->fb_height);
+    glUniform2f(state->traffic_u_cam_center, state->cam_center[0], state->cam_center[1]);
+    glUniform1f(state->traffic_u_cam_zoom, state->cam_zoom > 0.0f ? state->cam_zoom : 1.0f);
+    glUniform2f(state->traffic_u_extent, (float)view->traffic_cols * view->traffic_cell_world,
+                (float)view->traffic_rows * view->traffic_cell_world);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, state->traffic_texture);
+    glBindVertexArray(state->traffic_vao);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(0);
+}
+
+static bool ensure_static_storage(RenderState *state, size_t patch_count, size_t wall_count) {
+    if (patch_count > state->static_patch_capacity) {
+        StaticPatch *patches = (StaticPatch *)mem_realloc(ALLOC_TAG_RENDER, state->static_patches,
+                                                          patch_count * sizeof(StaticPatch));
+        if (!patches) {
+            LOG_ERROR("render: failed to grow static patch cache to %zu", patch_count);
+            return false;
         }
-        if (radius < 0.0f) {
-            radius = 0.0f;
+        state->static_patches = patches;
+        state->static_patch_capacity = patch_count;
+    }
+    if (wall_count > state->static_wall_capacity) {
+        StaticWall *walls = (StaticWall *)mem_realloc(ALLOC_TAG_RENDER, state->static_walls,
+                                                      wall_count * sizeof(StaticWall));
+        if (!walls) {
+            LOG_ERROR("render: failed to grow static wall cache to %zu", wall_count);
+            return false;
+        }
+        state->static_walls = walls;
+        state->static_wall_capacity = wall_count;
+    }
+    size_t vertex_count = wall_count * RENDER_WALL_VERTICES;
+    if (vertex_count > state->wall_vertex_capacity) {
+        LineVertex *verts = (LineVertex *)mem_realloc(ALLOC_TAG_RENDER, state->wall_cpu_buffer,
+                                                      vertex_count * sizeof(LineVertex));
+        if (!verts) {
+            LOG_ERROR("render: failed to grow wall vertex buffer to %zu", vertex_count);
+            return false;
         }
+        state->wall_cpu_buffer = verts;
+        state->wall_vertex_capacity = vertex_count;
+    }
+    return true;
+}
+
+// Sizes the offscreen layer to the framebuffer. Returns false when the layer
+// cannot be used and static content must be drawn straight to the screen.
+static bool ensure_static_target(RenderState *state) {
+    if (state->static_unsupported || !state->static_fbo || !state->static_texture ||
+        state->fb_width <= 0 || state->fb_height <= 0) {
+        return false;
+    }
+    if (state->static_width == state->fb_width && state->static_height == state->fb_height) {
+        return true;
+    }
+    glBindTexture(GL_TEXTURE_2D, state->static_texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, state->fb_width, state->fb_height, 0, GL_RGBA,
+                 GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, state->static_fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, state->static_texture, 0);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        LOG_WARN("render: static layer framebuffer incomplete (0x%x); drawing patches every frame",
+                 (unsigned)status);
+        state->static_unsupported = true;
+        state->static_width = 0;
+        state->static_height = 0;
+        return false;
+    }
+    state->static_width = state->fb_width;
+    state->static_height = state->fb_height;
+    state->static_valid = false;
+    LOG_INFO("render: static layer %dx%d", state->static_width, state->static_height);
+    return true;
+}
+
+static bool color_moved(uint32_t a, uint32_t b) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        int ca = (int)((a >> shift) & 0xFF);
+        int cb = (int)((b >> shift) & 0xFF);
+        if (abs(ca - cb) >= RENDER_STATIC_COLOR_TOLERANCE) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool static_layer_stale(const RenderState *state,
+                               const RenderView *view,
+                               size_t patch_count,
+                               size_t wall_count) {
+    if (!state->static_valid || patch_count != state->static_patch_count ||
+        wall_count != state->static_wall_count || state->static_cam_zoom != state->cam_zoom ||
+        state->static_cam_center[0] != state->cam_center[0] ||
+        state->static_cam_center[1] != state->cam_center[1] ||
+        memcmp(state->static_clear_color, state->clear_color, sizeof(state->clear_color)) != 0) {
+        return true;
+    }
+    for (size_t i = 0; i < patch_count; ++i) {
+        const StaticPatch *baked = &state->static_patches[i];
+        if (baked->center[0] != view->patch_positions_xy[i * 2 + 0] ||
+            baked->center[1] != view->patch_positions_xy[i * 2 + 1] ||
+            baked->radius != view->patch_radii_px[i] || baked->fill_rgba != view->patch_fill_rgba[i]) {
+            return true;
+        }
+        float ring_delta_px = fabsf(view->patch_ring_radii_px[i] - baked->ring_radius) * state->cam_zoom;
+        if (ring_delta_px >= RENDER_STATIC_RING_TOLERANCE_PX ||
+            color_moved(baked->ring_rgba, view->patch_ring_rgba[i])) {
+            return true;
+        }
+    }
+    for (size_t i = 0; i < wall_count; ++i) {
+        const StaticWall *baked = &state->static_walls[i];
+        if (memcmp(baked->xy, &view->hive_walls_xy[i * 4], sizeof(baked->xy)) != 0 ||
+            baked->rgba != view->hive_wall_rgba[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void static_layer_bake(RenderState *state, const RenderView *view, size_t patch_count, size_t wall_count) {
+    state->static_valid = false;
+    if (!ensure_static_storage(state, patch_count, wall_count)) {
+        return;
+    }
+    for (size_t i = 0; i < patch_count; ++i) {
+        StaticPatch *baked = &state->static_patches[i];
+        baked->center[0] = view->patch_positions_xy[i * 2 + 0];
+        baked->center[1] = view->patch_positions_xy[i * 2 + 1];
+        baked->radius = view->patch_radii_px[i];
+        baked->ring_radius = view->patch_ring_radii_px[i];
+        baked->fill_rgba = view->patch_fill_rgba[i];
+        baked->ring_rgba = view->patch_ring_rgba[i];
+    }
+    for (size_t i = 0; i < wall_count; ++i) {
+        memcpy(state->static_walls[i].xy, &view->hive_walls_xy[i * 4], sizeof(state->static_walls[i].xy));
+        state->static_walls[i].rgba = view->hive_wall_rgba[i];
+    }
+    state->static_patch_count = patch_count;
+    state->static_wall_count = wall_count;
+    state->static_cam_center[0] = state->cam_center[0];
+    state->static_cam_center[1] = state->cam_center[1];
+    state->static_cam_zoom = state->cam_zoom;
+    memcpy(state->static_clear_color, state->clear_color, sizeof(state->clear_color));
+    state->static_valid = true;
+}
 
-        unsigned char r = def_r;
-        unsigned char g = def_g;
-        unsigned char b = def_b;
-        unsigned char a = def_a;
-        if (color_rgba) {
-            uint32_t packed = color_rgba[i];
-            r = (unsigned char)((packed >> 24) & 0xFF);
-            g = (unsigned char)((packed >> 16) & 0xFF);
-            b = (unsigned char)((packed >> 8) & 0xFF);
-            a = (unsigned char)(packed & 0xFF);
+// Walls are world-space quads drawn with the line program, kept at least
+// 2 px thick on screen and 0.8 world units when zoomed in.
+static void draw_walls(RenderState *state, const RenderView *view, size_t wall_count) {
+    if (wall_count == 0 || !state->line_program || !ensure_static_storage(state, 0, wall_count)) {
+        return;
+    }
+    float zoom = state->cam_zoom > 0.0f ? state->cam_zoom : 1.0f;
+    float half_thickness = 0.5f * fmaxf(2.0f, zoom * 0.8f) / zoom;
+    size_t vertex_count = 0;
+    for (size_t i = 0; i < wall_count; ++i) {
+        const float *xy = &view->hive_walls_xy[i * 4];
+        float dx = xy[2] - xy[0];
+        float dy = xy[3] - xy[1];
+        float len = sqrtf(dx * dx + dy * dy);
+        if (len * zoom < 1.0f) {
+            continue;
         }
+        float nx = -dy / len * half_thickness;
+        float ny = dx / len * half_thickness;
+        const float corners[RENDER_WALL_VERTICES][2] = {
+            {xy[0] + nx, xy[1] + ny}, {xy[0] - nx, xy[1] - ny}, {xy[2] + nx, xy[3] + ny},
+            {xy[2] + nx, xy[3] + ny}, {xy[0] - nx, xy[1] - ny}, {xy[2] - nx, xy[3] - ny},
+        };
+        float color_rgba[4];
+        unpack_color(view->hive_wall_rgba[i], color_rgba);
+        for (int c = 0; c < RENDER_WALL_VERTICES; ++c) {
+            LineVertex *v = &state->wall_cpu_buffer[vertex_count++];
+            v->pos[0] = corners[c][0];
+            v->pos[1] = corners[c][1];
+            memcpy(v->color, color_rgba, sizeof(color_rgba));
+        }
+    }
+    if (vertex_count == 0) {
+        return;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, state->wall_vbo);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(vertex_count * sizeof(LineVertex)), state->wall_cpu_buffer,
+                 GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-        attribs[i].center[0] = cx;
-        attribs[i].center[1] = cy;
-        attribs[i].radius = radius;
-        attribs[i].color[0] = r;
-        attribs[i].color[1] = g;
-        attribs[i].color[2] = b;
-        attribs[i].color[3] = a;
+    glUseProgram(state->line_program);
+    glUniform2f(state->line_u_screen, (float)state->fb_width, (float)state->fb_height);
+    glUniform2f(state->line_u_cam_center, state->cam_center[0], state->cam_center[1]);
+    glUniform1f(state->line_u_cam_zoom, zoom);
+    glBindVertexArray(state->wall_vao);
+    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)vertex_count);
+    glBindVertexArray(0);
+    glUseProgram(0);
+}
+
+static bool ensure_patch_capacity(RenderState *state, size_t count) {
+    if (count <= state->patch_instance_capacity) {
+        return true;
+    }
+    InstanceAttrib *instances = (InstanceAttrib *)mem_realloc(ALLOC_TAG_RENDER, state->patch_instances,
+                                                              count * sizeof(InstanceAttrib));
+    if (!instances) {
+        LOG_ERROR("render: failed to grow patch instances to %zu", count);
+        return false;
     }
+    state->patch_instances = instances;
+    state->patch_instance_capacity = count;
+    return true;
+}
+
+// Clears the bound framebuffer and draws patch fills, stock rings and hive
+// walls in that order.
+static void draw_static_layer(RenderState *state, const RenderView *view, size_t patch_count, size_t wall_count) {
+    glClearColor(state->clear_color[0],
+                 state->clear_color[1],
+                 state->clear_color[2],
+                 state->clear_color[3]);
+    glClear(GL_COLOR_BUFFER_BIT);
+    if (state->program && patch_count > 0 && ensure_patch_capacity(state, patch_count * 2)) {
+        pack_instance_batch(state, state->patch_instances, view->patch_positions_xy, view->patch_radii_px,
+                            view->patch_fill_rgba, patch_count);
+        pack_instance_batch(state, state->patch_instances + patch_count, view->patch_positions_xy,
+                            view->patch_ring_radii_px, view->patch_ring_rgba, patch_count);
+        glBindBuffer(GL_ARRAY_BUFFER, state->patch_vbo);
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(patch_count * 2 * sizeof(InstanceAttrib)),
+                     state->patch_instances, GL_STREAM_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        draw_instances(state, state->patch_vao, patch_count * 2);
+    }
+    draw_walls(state, view, wall_count);
 }
 
 bool render_init(Render *render, const Params *params) {
+    return render_init_with_jobs(render, params, NULL);
+}
+
+bool render_init_with_jobs(Render *render, const Params *params, JobPool *jobs) {
     if (!render || !params) {
         LOG_ERROR("render_init received null argument");
         return false;
@@ -383,12 +1194,13 @@ bool render_init(Render *render, const Params *params) {
         return false;
     }
 
-    RenderState *state = (RenderState *)calloc(1, sizeof(RenderState));
+    RenderState *state = (RenderState *)mem_calloc(ALLOC_TAG_RENDER, 1, sizeof(RenderState));
     if (!state) {
         LOG_ERROR("Failed to allocate RenderState");
         return false;
     }
 
+    state->jobs = jobs;
     memcpy(state->clear_color, params->clear_color_rgba, sizeof(state->clear_color));
     memcpy(state->default_color, params->bee_color_rgba, sizeof(state->default_color));
     for (int i = 0; i < 4; ++i) {
@@ -426,9 +1238,9 @@ bool render_init(Render *render, const Params *params) {
     glBufferData(GL_ARRAY_BUFFER, sizeof(quad_vertices), quad_vertices, GL_STATIC_DRAW);
 
     glBindBuffer(GL_ARRAY_BUFFER, state->instance_vbo);
-    glBufferData(GL_ARRAY_BUFFER, 0, NULL, GL_STREAM_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, 0, NULL, GL_DYNAMIC_DRAW);
 
-    configure_instance_attribs(state);
+    configure_instance_attribs(state, state->vao, state->instance_vbo);
 
     glBindVertexArray(0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -438,29 +1250,35 @@ bool render_init(Render *render, const Params *params) {
     glBufferData(GL_ARRAY_BUFFER, 0, NULL, GL_STREAM_DRAW);
     glBindVertexArray(0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
-    configure_line_attribs(state);
-
-    char log_buffer[2048];
-    GLuint vs = compile_shader(GL_VERTEX_SHADER, kVertexShaderSrc, log_buffer, sizeof(log_buffer));
-    if (!vs) {
-        LOG_ERROR("Vertex shader compilation failed:\n%s", log_buffer);
-        destroy_render_state(state);
-        return false;
-    }
-
-    GLuint fs = compile_shader(GL_FRAGMENT_SHADER, kFragmentShaderSrc, log_buffer, sizeof(log_buffer));
-    if (!fs) {
-        LOG_ERROR("Fragment shader compilation failed:\n%s", log_buffer);
-        glDeleteShader(vs);
-        destroy_render_state(state);
-        return false;
-    }
+    configure_line_attribs(state->line_vao, state->line_vbo);
+
+    glGenVertexArrays(1, &state->patch_vao);
+    glGenBuffers(1, &state->patch_vbo);
+    configure_instance_attribs(state, state->patch_vao, state->patch_vbo);
+    static const float path_ends[2] = {0.0f, 1.0f};
+    glGenVertexArrays(1, &state->path_vao);
+    glGenBuffers(1, &state->path_t_vbo);
+    glGenBuffers(1, &state->path_vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, state->path_t_vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(path_ends), path_ends, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    configure_path_attribs(state);
+    glGenVertexArrays(1, &state->traffic_vao);
+    glGenTextures(1, &state->traffic_texture);
+    glBindVertexArray(state->traffic_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, state->quad_vbo);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void *)0);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glGenVertexArrays(1, &state->wall_vao);
+    glGenBuffers(1, &state->wall_vbo);
+    glGenFramebuffers(1, &state->static_fbo);
+    glGenTextures(1, &state->static_texture);
+    configure_line_attribs(state->wall_vao, state->wall_vbo);
 
-    state->program = link_program(vs, fs, log_buffer, sizeof(log_buffer));
-    glDeleteShader(vs);
-    glDeleteShader(fs);
+    state->program = shader_program_build("render_bees", kVertexShaderSrc, kFragmentShaderSrc);
     if (!state->program) {
-        LOG_ERROR("Shader program link failed:\n%s", log_buffer);
         destroy_render_state(state);
         return false;
     }
@@ -471,34 +1289,43 @@ bool render_init(Render *render, const Params *params) {
     state->u_cam_zoom = glGetUniformLocation(state->program, "u_cam_zoom");
     glUseProgram(0);
 
-    GLuint line_vs = compile_shader(GL_VERTEX_SHADER, kLineVertexShaderSrc, log_buffer, sizeof(log_buffer));
-    if (!line_vs) {
-        LOG_ERROR("Line vertex shader compilation failed:\n%s", log_buffer);
+    state->line_program = shader_program_build("render_lines", kLineVertexShaderSrc, kLineFragmentShaderSrc);
+    if (!state->line_program) {
         destroy_render_state(state);
         return false;
     }
 
-    GLuint line_fs = compile_shader(GL_FRAGMENT_SHADER, kLineFragmentShaderSrc, log_buffer, sizeof(log_buffer));
-    if (!line_fs) {
-        LOG_ERROR("Line fragment shader compilation failed:\n%s", log_buffer);
-        glDeleteShader(line_vs);
+    glUseProgram(state->line_program);
+    state->line_u_screen = glGetUniformLocation(state->line_program, "u_screen");
+    state->line_u_cam_center = glGetUniformLocation(state->line_program, "u_cam_center");
+    state->line_u_cam_zoom = glGetUniformLocation(state->line_program, "u_cam_zoom");
+    glUseProgram(0);
+
+    state->path_program = shader_program_build("render_paths", kPathVertexShaderSrc, kLineFragmentShaderSrc);
+    if (!state->path_program) {
         destroy_render_state(state);
         return false;
     }
 
-    state->line_program = link_program(line_vs, line_fs, log_buffer, sizeof(log_buffer));
-    glDeleteShader(line_vs);
-    glDeleteShader(line_fs);
-    if (!state->line_program) {
-        LOG_ERROR("Line shader program link failed:\n%s", log_buffer);
+    glUseProgram(state->path_program);
+    state->path_u_screen = glGetUniformLocation(state->path_program, "u_screen");
+    state->path_u_cam_center = glGetUniformLocation(state->path_program, "u_cam_center");
+    state->path_u_cam_zoom = glGetUniformLocation(state->path_program, "u_cam_zoom");
+    glUniform4fv(glGetUniformLocation(state->path_program, "u_palette"), PATH_SEGMENT_KIND_COUNT, &kPathPalette[0][0]);
+    glUseProgram(0);
+
+    state->traffic_program = shader_program_build("render_traffic", kTrafficVertexShaderSrc, kTrafficFragmentShaderSrc);
+    if (!state->traffic_program) {
         destroy_render_state(state);
         return false;
     }
 
-    glUseProgram(state->line_program);
-    state->line_u_screen = glGetUniformLocation(state->line_program, "u_screen");
-    state->line_u_cam_center = glGetUniformLocation(state->line_program, "u_cam_center");
-    state->line_u_cam_zoom = glGetUniformLocation(state->line_program, "u_cam_zoom");
+    glUseProgram(state->traffic_program);
+    state->traffic_u_screen = glGetUniformLocation(state->traffic_program, "u_screen");
+    state->traffic_u_cam_center = glGetUniformLocation(state->traffic_program, "u_cam_center");
+    state->traffic_u_cam_zoom = glGetUniformLocation(state->traffic_program, "u_cam_zoom");
+    state->traffic_u_extent = glGetUniformLocation(state->traffic_program, "u_extent");
+    glUniform1i(glGetUniformLocation(state->traffic_program, "u_traffic"), 0);
     glUseProgram(0);
 
     if (state->u_screen < 0 || state->u_cam_center < 0 || state->u_cam_zoom < 0) {
@@ -507,13 +1334,21 @@ bool render_init(Render *render, const Params *params) {
     if (state->line_u_screen < 0 || state->line_u_cam_center < 0 || state->line_u_cam_zoom < 0) {
         LOG_WARN("render: missing camera uniforms for debug lines; rendering may be incorrect");
     }
+    if (state->path_u_screen < 0 || state->path_u_cam_center < 0 || state->path_u_cam_zoom < 0) {
+        LOG_WARN("render: missing camera uniforms for the path overlay; rendering may be incorrect");
+    }
+    if (state->traffic_u_screen < 0 || state->traffic_u_cam_center < 0 || state->traffic_u_cam_zoom < 0 ||
+        state->traffic_u_extent < 0) {
+        LOG_WARN("render: missing camera uniforms for the traffic heatmap; rendering may be incorrect");
+    }
 
     glDisable(GL_DEPTH_TEST);
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     render->state = state;
-    LOG_INFO("render: circle instancing enabled (stride=%d bytes)", INSTANCE_STRIDE);
+    LOG_INFO("render: circle instancing enabled (stride=%d bytes, pack threads=%d)", INSTANCE_STRIDE,
+             jobs_thread_count(jobs));
     return true;
 }
 
@@ -578,11 +1413,6 @@ void render_frame(Render *render, const RenderView *view) {
     if (state->fb_width > 0 && state->fb_height > 0) {
         glViewport(0, 0, state->fb_width, state->fb_height);
     }
-    glClearColor(state->clear_color[0],
-                 state->clear_color[1],
-                 state->clear_color[2],
-                 state->clear_color[3]);
-    glClear(GL_COLOR_BUFFER_BIT);
 
     size_t bee_count = view ? view->count : 0;
     size_t patch_count = view ? view->patch_count : 0;
@@ -590,35 +1420,38 @@ void render_frame(Render *render, const RenderView *view) {
     if (!patch_data_valid) {
         patch_count = 0;
     }
-    size_t total_instances = bee_count + (patch_count * 2);
-    if (!state->program || total_instances == 0) {
-        return;
+    size_t wall_count = view && view->hive_walls_xy && view->hive_wall_rgba ? view->hive_wall_count : 0;
+
+    TRACE_BEGIN("render_static");
+    if (ensure_static_target(state)) {
+        if (static_layer_stale(state, view, patch_count, wall_count)) {
+            glBindFramebuffer(GL_FRAMEBUFFER, state->static_fbo);
+            draw_static_layer(state, view, patch_count, wall_count);
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            static_layer_bake(state, view, patch_count, wall_count);
+        }
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, state->static_fbo);
+        glBlitFramebuffer(0, 0, state->static_width, state->static_height,
+                          0, 0, state->static_width, state->static_height,
+                          GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    } else {
+        draw_static_layer(state, view, patch_count, wall_count);
     }
-
-    if (!ensure_instance_capacity(state, total_instances)) {
-        return;
+    TRACE_END("render_static");
+
+    const bool traffic_data_valid = view && view->traffic_intensity && view->traffic_cols > 0 &&
+                                    view->traffic_rows > 0 && view->traffic_cell_world > 0.0f;
+    if (state->traffic_program && traffic_data_valid) {
+        TRACE_BEGIN("render_traffic");
+        if (view->traffic_version != state->traffic_version || view->traffic_cols != state->traffic_cols ||
+            view->traffic_rows != state->traffic_rows) {
+            upload_traffic(state, view);
+        }
+        draw_traffic(state, view);
+        TRACE_END("render_traffic");
     }
 
-    size_t offset = 0;
-    if (patch_count > 0) {
-        pack_instance_batch(state,
-                            offset,
-                            view->patch_positions_xy,
-                            view->patch_radii_px,
-                            view->patch_fill_rgba,
-                            patch_count);
-        offset += patch_count;
-        pack_instance_batch(state,
-                            offset,
-                            view->patch_positions_xy,
-                            view->patch_ring_radii_px,
-                            view->patch_ring_rgba,
-                            patch_count);
-        offset += patch_count;
-    }
-    pack_instance_batch(state, offset, view ? view->positions_xy : NULL, view ? view->radii_px : NULL,
-                        view ? view->color_rgba : NULL, bee_count);
-
     float cam_zoom = state->cam_zoom;
     if (cam_zoom <= 0.0f) {
         cam_zoom = 1.0f;
@@ -626,20 +1459,36 @@ void render_frame(Render *render, const RenderView *view) {
     float cam_center_x = state->cam_center[0];
     float cam_center_y = state->cam_center[1];
 
-    size_t byte_count = total_instances * (size_t)INSTANCE_STRIDE;
-    glBindBuffer(GL_ARRAY_BUFFER, state->instance_vbo);
-    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)state->instance_buffer_size, NULL, GL_STREAM_DRAW);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)byte_count, state->instance_cpu_buffer);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    state->path_segment_count = 0;
+    const bool path_data_valid = view && view->path_count == bee_count && view->positions_xy &&
+                                 view->path_valid && view->path_has_waypoint && view->path_waypoint_x &&
+                                 view->path_waypoint_y && view->path_target_x && view->path_target_y;
+    if (state->path_program && path_data_valid && bee_count > 0 && ensure_path_capacity(state, bee_count)) {
+        TRACE_BEGIN("render_paths");
+        state->path_segment_count = build_path_segments(state, view, bee_count);
+        if (state->path_segment_count > 0) {
+            draw_path_segments(state, state->path_segment_count);
+        }
+        TRACE_END("render_paths");
+    }
 
-    glUseProgram(state->program);
-    glUniform2f(state->u_screen, (float)state->fb_width, (float)state->fb_height);
-    glUniform2f(state->u_cam_center, cam_center_x, cam_center_y);
-    glUniform1f(state->u_cam_zoom, cam_zoom);
-    glBindVertexArray(state->vao);
-    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)total_instances);
-    glBindVertexArray(0);
-    glUseProgram(0);
+    if (state->program && bee_count > 0 && ensure_instance_capacity(state, bee_count)) {
+        // Zooming in magnifies the drift the epsilon allowed, so resend all.
+        bool full = bee_count != state->instance_uploaded_count || state->cam_zoom > state->instance_uploaded_zoom;
+        TRACE_BEGIN("render_pack");
+        size_t dirty_blocks = pack_bee_instances(state, view, bee_count, full);
+        TRACE_END("render_pack");
+
+        TRACE_BEGIN("render_upload");
+        upload_bee_instances(state, bee_count, dirty_blocks);
+        state->instance_uploaded_count = bee_count;
+        state->instance_uploaded_zoom = state->cam_zoom;
+        TRACE_END("render_upload");
+
+        TRACE_BEGIN("render_draw");
+        draw_instances(state, state->vao, bee_count);
+        TRACE_END("render_draw");
+    }
 
     if (view && view->debug_line_count > 0 && view->debug_lines_xy && view->debug_line_rgba &&
         state->line_program && state->line_vao) {
@@ -685,6 +1534,132 @@ void render_frame(Render *render, const RenderView *view) {
         }
     }
 }
+
+bool render_capture_read(Render *render, uint64_t frame_id) {
+    if (!render || !render->state) {
+        return false;
+    }
+    RenderState *state = (RenderState *)render->state;
+    if (state->capture_in_flight >= RENDER_CAPTURE_RING) {
+        return false;
+    }
+    CaptureSlot *slot = &state->capture_slots[state->capture_head];
+    const int width = state->fb_width;
+    const int height = state->fb_height;
+    const size_t bytes = (size_t)width * (size_t)height * 4u;
+    if (!slot->pbo) {
+        glGenBuffers(1, &slot->pbo);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
+    if (slot->bytes < bytes) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)bytes, NULL, GL_STREAM_READ);
+        slot->bytes = bytes;
+    }
+    // With a pack buffer bound the copy lands in slot->pbo and returns
+    // without waiting for the GPU; the fence tells collect when it is done.
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    glReadBuffer(GL_BACK);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, (void *)0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    if (!slot->fence) {
+        LOG_WARN("render: capture fence failed; frame %llu skipped", (unsigned long long)frame_id);
+        return false;
+    }
+    slot->width = width;
+    slot->height = height;
+    slot->frame_id = frame_id;
+    state->capture_head = (state->capture_head + 1u) % RENDER_CAPTURE_RING;
+    state->capture_in_flight += 1u;
+    return true;
+}
+
+size_t render_capture_collect(Render *render, RenderCaptureFn fn, void *user, bool wait) {
+    if (!render || !render->state) {
+        return 0;
+    }
+    RenderState *state = (RenderState *)render->state;
+    size_t delivered = 0;
+    while (state->capture_in_flight > 0) {
+        uint32_t oldest = (state->capture_head + RENDER_CAPTURE_RING - state->capture_in_flight) % RENDER_CAPTURE_RING;
+        CaptureSlot *slot = &state->capture_slots[oldest];
+        GLenum status = wait ? glClientWaitSync(slot->fence, GL_SYNC_FLUSH_COMMANDS_BIT, RENDER_CAPTURE_WAIT_NS)
+                             : glClientWaitSync(slot->fence, 0, 0);
+        if (status == GL_TIMEOUT_EXPIRED && !wait) {
+            break;  // readbacks finish in order, so later slots are not ready either
+        }
+        glDeleteSync(slot->fence);
+        slot->fence = NULL;
+        state->capture_in_flight -= 1u;
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            LOG_WARN("render: capture of frame %llu did not complete (0x%x); dropped",
+                     (unsigned long long)slot->frame_id, (unsigned)status);
+            continue;
+        }
+        const size_t bytes = (size_t)slot->width * (size_t)slot->height * 4u;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
+        const uint8_t *pixels = (const uint8_t *)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)bytes,
+                                                                  GL_MAP_READ_BIT);
+        if (pixels) {
+            if (fn) {
+                fn(user, pixels, slot->width, slot->height, slot->frame_id);
+            }
+            delivered += 1;
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        } else {
+            LOG_WARN("render: failed to map capture of frame %llu; dropped", (unsigned long long)slot->frame_id);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+    return delivered;
+}
+
+void render_memory_report(const Render *render, MemReport *report) {
+    if (!render || !render->state || !report) {
+        return;
+    }
+    const RenderState *state = (const RenderState *)render->state;
+    // Instance storage tracks the bee count (grown by doubling), so it is
+    // reported as per-bee; line buffers only hold debug overlays.
+    mem_report_add(report, "render", "instances",
+                   state->instance_buffer_size + (state->instance_capacity + RENDER_DIRTY_BLOCK - 1) / RENDER_DIRTY_BLOCK,
+                   MEM_REGION_CPU, true);
+    mem_report_add(report, "render", "instances", state->instance_buffer_size, MEM_REGION_GPU, true);
+    mem_report_add(report, "render", "lines", state->line_buffer_size, MEM_REGION_CPU, false);
+    mem_report_add(report, "render", "lines", state->line_buffer_size, MEM_REGION_GPU, false);
+    mem_report_add(report, "render", "paths",
+                   state->path_capacity * 2 * sizeof(PathSegment) +
+                       (state->path_capacity + RENDER_PATH_CHUNK - 1) / RENDER_PATH_CHUNK * sizeof(size_t),
+                   MEM_REGION_CPU, false);
+    mem_report_add(report, "render", "paths", state->path_capacity * 2 * sizeof(PathSegment), MEM_REGION_GPU,
+                   false);
+    mem_report_add(report, "render", "traffic", (uint64_t)state->traffic_cols * (uint64_t)state->traffic_rows,
+                   MEM_REGION_GPU, false);
+    mem_report_add(report, "render", "static_layer",
+                   state->static_patch_capacity * sizeof(StaticPatch) +
+                       state->static_wall_capacity * sizeof(StaticWall) +
+                       state->wall_vertex_capacity * sizeof(LineVertex) +
+                       state->patch_instance_capacity * sizeof(InstanceAttrib),
+                   MEM_REGION_CPU, false);
+    mem_report_add(report, "render", "static_layer",
+                   (uint64_t)state->static_width * (uint64_t)state->static_height * 4u +
+                       state->wall_vertex_capacity * sizeof(LineVertex) +
+                       state->patch_instance_capacity * sizeof(InstanceAttrib),
+                   MEM_REGION_GPU, false);
+    uint64_t capture_bytes = 0;
+    for (int i = 0; i < RENDER_CAPTURE_RING; ++i) {
+        capture_bytes += state->capture_slots[i].bytes;
+    }
+    mem_report_add(report, "render", "capture", capture_bytes, MEM_REGION_GPU, false);
+}
+
+uint64_t render_instance_upload_bytes(const Render *render) {
+    if (!render || !render->state) {
+        return 0;
+    }
+    return ((const RenderState *)render->state)->instance_upload_bytes;
+}
+
 void render_shutdown(Render *render) {
     if (!render || !render->state) {
         return;
@@ -0,0 +1,259 @@
+#include "shader_cache.h"
+
+#include <glad/glad.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#include "params.h"
+#include "util/alloc.h"
+#include "util/clock.h"
+#include "util/file_io.h"
+#include "util/log.h"
+
+// glGetProgramBinary is core in GL 4.1 and ARB_get_program_binary before
+// that; a glad build without either compiles the cache out.
+#if defined(GL_VERSION_4_1) || defined(GL_ARB_get_program_binary)
+#define SHADER_CACHE_BINARY 1
+#endif
+
+// Larger entries are treated as corrupt rather than allocated.
+#define SHADER_CACHE_MAX_BINARY (64u << 20)
+
+static char g_cache_dir[PARAMS_MAX_PATH_CHARS];
+
+void shader_cache_set_dir(const char *dir) {
+    snprintf(g_cache_dir, sizeof g_cache_dir, "%s", dir ? dir : "");
+}
+
+static GLuint shader_compile(const char *name, const char *stage, GLenum type, const char *src) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &src, NULL);
+    glCompileShader(shader);
+    GLint status = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+    if (status != GL_TRUE) {
+        char log_buf[2048];
+        log_buf[0] = '\0';
+        glGetShaderInfoLog(shader, (GLsizei)sizeof(log_buf), NULL, log_buf);
+        LOG_ERROR("shader: %s %s shader compilation failed:\n%s", name, stage, log_buf);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+static GLuint shader_compile_link(const char *name, const char *vs_src, const char *fs_src,
+                                  bool retrievable) {
+    GLuint vs = shader_compile(name, "vertex", GL_VERTEX_SHADER, vs_src);
+    if (!vs) {
+        return 0;
+    }
+    GLuint fs = shader_compile(name, "fragment", GL_FRAGMENT_SHADER, fs_src);
+    if (!fs) {
+        glDeleteShader(vs);
+        return 0;
+    }
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vs);
+    glAttachShader(program, fs);
+#ifdef SHADER_CACHE_BINARY
+    if (retrievable) {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+#else
+    (void)retrievable;
+#endif
+    glLinkProgram(program);
+    glDeleteShader(vs);
+    glDeleteShader(fs);
+    GLint status = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (status != GL_TRUE) {
+        char log_buf[2048];
+        log_buf[0] = '\0';
+        glGetProgramInfoLog(program, (GLsizei)sizeof(log_buf), NULL, log_buf);
+        LOG_ERROR("shader: %s program link failed:\n%s", name, log_buf);
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+#ifdef SHADER_CACHE_BINARY
+
+static int g_cache_supported = -1;  // -1 until probed with a current context
+
+static bool shader_cache_supported(void) {
+    if (g_cache_supported < 0) {
+        bool loaded = false;
+#ifdef GL_VERSION_4_1
+        loaded = loaded || GLAD_GL_VERSION_4_1;
+#endif
+#ifdef GL_ARB_get_program_binary
+        loaded = loaded || GLAD_GL_ARB_get_program_binary;
+#endif
+        GLint formats = 0;
+        if (loaded) {
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        }
+        g_cache_supported = formats > 0 ? 1 : 0;
+        if (!g_cache_supported) {
+            LOG_WARN("shader_cache: driver has no program binary formats; compiling from source");
+        }
+    }
+    return g_cache_supported == 1;
+}
+
+static uint64_t fnv1a_string(uint64_t hash, const char *text) {
+    const unsigned char *p = (const unsigned char *)(text ? text : "");
+    do {
+        hash ^= *p;
+        hash *= 1099511628211ull;
+    } while (*p++ != '\0');
+    return hash;
+}
+
+static uint64_t shader_cache_key(const char *vs_src, const char *fs_src) {
+    uint64_t hash = 14695981039346656037ull;
+    hash = fnv1a_string(hash, vs_src);
+    hash = fnv1a_string(hash, fs_src);
+    hash = fnv1a_string(hash, (const char *)glGetString(GL_VENDOR));
+    hash = fnv1a_string(hash, (const char *)glGetString(GL_RENDERER));
+    hash = fnv1a_string(hash, (const char *)glGetString(GL_VERSION));
+    return hash;
+}
+
+static bool shader_cache_path(const char *name, char *out, size_t out_cap) {
+    int written = snprintf(out, out_cap, "%s/%s.bin", g_cache_dir, name);
+    return written > 0 && (size_t)written < out_cap;
+}
+
+static GLuint shader_cache_load(const char *name, uint64_t key) {
+    char path[PARAMS_MAX_PATH_CHARS + 64];
+    if (!shader_cache_path(name, path, sizeof path)) {
+        return 0;
+    }
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return 0;
+    }
+    ShaderCacheHeader header;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+              memcmp(header.magic, SHADER_CACHE_MAGIC, sizeof(header.magic)) == 0 &&
+              header.version == SHADER_CACHE_VERSION && header.binary_size > 0 &&
+              header.binary_size <= SHADER_CACHE_MAX_BINARY;
+    if (!ok || header.key != key) {
+        fclose(file);
+        LOG_INFO("shader_cache: %s is %s; recompiling", path, ok ? "stale" : "not a cache entry");
+        return 0;
+    }
+    void *binary = mem_alloc(ALLOC_TAG_RENDER, header.binary_size);
+    if (!binary) {
+        fclose(file);
+        LOG_WARN("shader_cache: failed to allocate %u bytes for %s", header.binary_size, path);
+        return 0;
+    }
+    ok = fread(binary, 1, header.binary_size, file) == header.binary_size;
+    fclose(file);
+    GLuint program = 0;
+    if (ok) {
+        program = glCreateProgram();
+        glProgramBinary(program, (GLenum)header.binary_format, binary, (GLsizei)header.binary_size);
+        GLint status = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &status);
+        if (status != GL_TRUE) {
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+    mem_free(ALLOC_TAG_RENDER, binary);
+    if (!program) {
+        LOG_INFO("shader_cache: %s was %s; recompiling", path, ok ? "rejected by the driver" : "truncated");
+    }
+    return program;
+}
+
+static void shader_cache_store(const char *name, uint64_t key, GLuint program) {
+    char path[PARAMS_MAX_PATH_CHARS + 64];
+    if (!shader_cache_path(name, path, sizeof path)) {
+        LOG_WARN("shader_cache: path for %s is too long", name);
+        return;
+    }
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0 || (uint32_t)length > SHADER_CACHE_MAX_BINARY) {
+        return;
+    }
+    void *binary = mem_alloc(ALLOC_TAG_RENDER, (size_t)length);
+    if (!binary) {
+        LOG_WARN("shader_cache: failed to allocate %d bytes for %s", length, name);
+        return;
+    }
+    GLsizei written = 0;
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &written, &format, binary);
+    if (written > 0) {
+#ifdef _WIN32
+        _mkdir(g_cache_dir);
+#else
+        mkdir(g_cache_dir, 0755);
+#endif
+        ShaderCacheHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, SHADER_CACHE_MAGIC, sizeof(header.magic));
+        header.version = SHADER_CACHE_VERSION;
+        header.binary_format = (uint32_t)format;
+        header.key = key;
+        header.binary_size = (uint32_t)written;
+        FileSlice slices[2] = {
+            {&header, sizeof(header)},
+            {binary, (size_t)written},
+        };
+        if (file_write_slices(path, slices, 2)) {
+            LOG_INFO("shader_cache: stored %s (%d bytes)", path, (int)written);
+        } else {
+            LOG_WARN("shader_cache: cannot write %s", path);
+        }
+    }
+    mem_free(ALLOC_TAG_RENDER, binary);
+}
+
+#endif  // SHADER_CACHE_BINARY
+
+unsigned int shader_program_build(const char *name, const char *vs_src, const char *fs_src) {
+    if (!name || !vs_src || !fs_src) {
+        LOG_ERROR("shader_program_build received null argument");
+        return 0;
+    }
+    uint64_t start_ns = clock_now_ns();
+#ifdef SHADER_CACHE_BINARY
+    bool cached = g_cache_dir[0] != '\0' && shader_cache_supported();
+    uint64_t key = 0;
+    if (cached) {
+        key = shader_cache_key(vs_src, fs_src);
+        GLuint program = shader_cache_load(name, key);
+        if (program) {
+            LOG_DEBUG("shader: %s loaded from cache in %.2f ms", name,
+                      clock_ns_to_ms(clock_now_ns() - start_ns));
+            return program;
+        }
+    }
+    GLuint program = shader_compile_link(name, vs_src, fs_src, cached);
+    if (program && cached) {
+        shader_cache_store(name, key, program);
+    }
+#else
+    GLuint program = shader_compile_link(name, vs_src, fs_src, false);
+#endif
+    if (program) {
+        LOG_DEBUG("shader: %s compiled in %.2f ms", name, clock_ns_to_ms(clock_now_ns() - start_ns));
+    }
+    return program;
+}
@@ -0,0 +1,555 @@
+#include "soft_render.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "util/alloc.h"
+#include "util/image_write.h"
+#include "util/log.h"
+#include "util/trace.h"
+
+#define SOFT_TILE_PX 64
+#define SOFT_BIN_SLICES 64
+#define SOFT_EDGE_PX 1.5f       // smoothstep width of the GL disc fragment shader
+#define SOFT_LINE_HALF_PX 1.0f  // glLineWidth(2.0f)
+#define SOFT_SMALL_SPAN 16      // fixed shading window for small discs (one AVX-512 vector)
+
+typedef struct SoftDisc {
+    float x;
+    float y;
+    float r;
+    uint32_t rgba;
+} SoftDisc;
+
+struct SoftRender {
+    int width;
+    int height;
+    int tiles_x;
+    int tiles_y;
+    size_t tile_count;
+    JobPool *jobs;
+    float clear_color[3];
+    uint32_t default_color_rgba;
+    float default_radius;
+    float cam_center[2];
+    float cam_zoom;
+    uint8_t *pixels;
+    uint32_t *slice_cursor;  // SOFT_BIN_SLICES x tile_count: counts, then write cursors
+    uint32_t *tile_start;    // tile_count + 1 offsets into bins
+    SoftDisc *bins;          // screen-space discs per tile, in draw order
+    size_t bin_capacity;
+
+    // Per-frame inputs, read-only while jobs run.
+    const RenderView *view;
+    size_t patch_count;
+    size_t item_count;
+    size_t slice_items;
+};
+
+static float soft_clamp01(float v) {
+    return v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+}
+
+static uint32_t soft_pack_color(const float rgba[4]) {
+    uint32_t packed = 0;
+    for (int i = 0; i < 4; ++i) {
+        packed = (packed << 8) | (uint32_t)(soft_clamp01(rgba[i]) * 255.0f + 0.5f);
+    }
+    return packed;
+}
+
+// Items are numbered in GL draw order: patch fills, patch rings, then bees.
+static bool soft_item(const SoftRender *sr, size_t item, SoftDisc *out) {
+    const RenderView *view = sr->view;
+    const float *pos;
+    float radius;
+    uint32_t rgba;
+    if (item < sr->patch_count) {
+        pos = view->patch_positions_xy + item * 2u;
+        radius = view->patch_radii_px[item];
+        rgba = view->patch_fill_rgba[item];
+    } else if (item < sr->patch_count * 2u) {
+        size_t p = item - sr->patch_count;
+        pos = view->patch_positions_xy + p * 2u;
+        radius = view->patch_ring_radii_px[p];
+        rgba = view->patch_ring_rgba[p];
+    } else {
+        size_t i = item - sr->patch_count * 2u;
+        pos = view->positions_xy + i * 2u;
+        radius = view->radii_px ? view->radii_px[i] : sr->default_radius;
+        rgba = view->color_rgba ? view->color_rgba[i] : sr->default_color_rgba;
+    }
+    if (radius <= 0.0f || (rgba & 0xFFu) == 0) {
+        return false;
+    }
+    float x = (pos[0] - sr->cam_center[0]) * sr->cam_zoom + 0.5f * (float)sr->width;
+    float y = (pos[1] - sr->cam_center[1]) * sr->cam_zoom + 0.5f * (float)sr->height;
+    float r = radius * sr->cam_zoom;
+    if (!(x + r > 0.0f && y + r > 0.0f && x - r < (float)sr->width && y - r < (float)sr->height)) {
+        return false;  // off-screen (also rejects NaN positions)
+    }
+    out->x = x;
+    out->y = y;
+    out->r = r;
+    out->rgba = rgba;
+    return true;
+}
+
+static void soft_disc_tiles(const SoftRender *sr, const SoftDisc *disc, int *tx0, int *tx1, int *ty0,
+                            int *ty1) {
+    float x0 = disc->x - disc->r;
+    float x1 = disc->x + disc->r;
+    float y0 = disc->y - disc->r;
+    float y1 = disc->y + disc->r;
+    x0 = x0 < 0.0f ? 0.0f : x0;
+    y0 = y0 < 0.0f ? 0.0f : y0;
+    x1 = x1 > (float)(sr->width - 1) ? (float)(sr->width - 1) : x1;
+    y1 = y1 > (float)(sr->height - 1) ? (float)(sr->height - 1) : y1;
+    *tx0 = (int)x0 / SOFT_TILE_PX;
+    *tx1 = (int)x1 / SOFT_TILE_PX;
+    *ty0 = (int)y0 / SOFT_TILE_PX;
+    *ty1 = (int)y1 / SOFT_TILE_PX;
+}
+
+static void soft_bin_count(void *user, size_t begin, size_t end) {
+    SoftRender *sr = (SoftRender *)user;
+    for (size_t slice = begin; slice < end; ++slice) {
+        uint32_t *counts = sr->slice_cursor + slice * sr->tile_count;
+        memset(counts, 0, sizeof(uint32_t) * sr->tile_count);
+        size_t item_end = (slice + 1u) * sr->slice_items;
+        item_end = item_end < sr->item_count ? item_end : sr->item_count;
+        for (size_t item = slice * sr->slice_items; item < item_end; ++item) {
+            SoftDisc disc;
+            if (!soft_item(sr, item, &disc)) {
+                continue;
+            }
+            int tx0, tx1, ty0, ty1;
+            soft_disc_tiles(sr, &disc, &tx0, &tx1, &ty0, &ty1);
+            for (int ty = ty0; ty <= ty1; ++ty) {
+                for (int tx = tx0; tx <= tx1; ++tx) {
+                    counts[(size_t)ty * (size_t)sr->tiles_x + (size_t)tx] += 1u;
+                }
+            }
+        }
+    }
+}
+
+static void soft_bin_scatter(void *user, size_t begin, size_t end) {
+    SoftRender *sr = (SoftRender *)user;
+    for (size_t slice = begin; slice < end; ++slice) {
+        uint32_t *cursor = sr->slice_cursor + slice * sr->tile_count;
+        size_t item_end = (slice + 1u) * sr->slice_items;
+        item_end = item_end < sr->item_count ? item_end : sr->item_count;
+        for (size_t item = slice * sr->slice_items; item < item_end; ++item) {
+            SoftDisc disc;
+            if (!soft_item(sr, item, &disc)) {
+                continue;
+            }
+            int tx0, tx1, ty0, ty1;
+            soft_disc_tiles(sr, &disc, &tx0, &tx1, &ty0, &ty1);
+            for (int ty = ty0; ty <= ty1; ++ty) {
+                for (int tx = tx0; tx <= tx1; ++tx) {
+                    sr->bins[cursor[(size_t)ty * (size_t)sr->tiles_x + (size_t)tx]++] = disc;
+                }
+            }
+        }
+    }
+}
+
+typedef struct SoftTile {
+    float r[SOFT_TILE_PX * SOFT_TILE_PX];
+    float g[SOFT_TILE_PX * SOFT_TILE_PX];
+    float b[SOFT_TILE_PX * SOFT_TILE_PX];
+    int x0;
+    int y0;
+    int w;
+    int h;
+} SoftTile;
+
+static void soft_color(uint32_t rgba, float *r, float *g, float *b, float *a) {
+    *r = (float)((rgba >> 24) & 0xFFu) * (1.0f / 255.0f);
+    *g = (float)((rgba >> 16) & 0xFFu) * (1.0f / 255.0f);
+    *b = (float)((rgba >> 8) & 0xFFu) * (1.0f / 255.0f);
+    *a = (float)(rgba & 0xFFu) * (1.0f / 255.0f);
+}
+
+// Coverage matches the GL fragment shader: smoothstep(r, r - 1.5, dist).
+// The span loop is branch-free so it vectorizes across pixels.
+static void soft_shade_disc(SoftTile *tile, const SoftDisc *disc) {
+    const float lx = disc->x - (float)tile->x0;
+    const float ly = disc->y - (float)tile->y0;
+    const float r = disc->r;
+    float fx0 = floorf(lx - r);
+    float fx1 = ceilf(lx + r);
+    float fy0 = floorf(ly - r);
+    float fy1 = ceilf(ly + r);
+    int x0 = fx0 < 0.0f ? 0 : (int)fx0;
+    int y0 = fy0 < 0.0f ? 0 : (int)fy0;
+    int x1 = fx1 > (float)tile->w ? tile->w : (int)fx1;
+    int y1 = fy1 > (float)tile->h ? tile->h : (int)fy1;
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+    float cr, cg, cb, ca;
+    soft_color(disc->rgba, &cr, &cg, &cb, &ca);
+    const float inv_edge = 1.0f / SOFT_EDGE_PX;
+    if (x1 - x0 <= SOFT_SMALL_SPAN && x0 + SOFT_SMALL_SPAN <= SOFT_TILE_PX) {
+        // Bees are a handful of pixels wide: shade a fixed-width window so each
+        // row is whole vectors with no scalar remainder. Pixels outside the
+        // disc get zero coverage, and columns past tile->w are never output.
+        for (int y = y0; y < y1; ++y) {
+            const float dy = (float)y + 0.5f - ly;
+            const float dy2 = dy * dy;
+            float *restrict row_r = tile->r + y * SOFT_TILE_PX + x0;
+            float *restrict row_g = tile->g + y * SOFT_TILE_PX + x0;
+            float *restrict row_b = tile->b + y * SOFT_TILE_PX + x0;
+            const float dx0 = (float)x0 + 0.5f - lx;
+            for (int k = 0; k < SOFT_SMALL_SPAN; ++k) {
+                float dx = dx0 + (float)k;
+                float dist = sqrtf(dx * dx + dy2);
+                float t = (r - dist) * inv_edge;
+                t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+                float a = t * t * (3.0f - 2.0f * t) * ca;
+                row_r[k] += (cr - row_r[k]) * a;
+                row_g[k] += (cg - row_g[k]) * a;
+                row_b[k] += (cb - row_b[k]) * a;
+            }
+        }
+        return;
+    }
+    for (int y = y0; y < y1; ++y) {
+        const float dy = (float)y + 0.5f - ly;
+        const float dy2 = dy * dy;
+        float *restrict row_r = tile->r + y * SOFT_TILE_PX;
+        float *restrict row_g = tile->g + y * SOFT_TILE_PX;
+        float *restrict row_b = tile->b + y * SOFT_TILE_PX;
+        for (int x = x0; x < x1; ++x) {
+            float dx = (float)x + 0.5f - lx;
+            float dist = sqrtf(dx * dx + dy2);
+            float t = (r - dist) * inv_edge;
+            t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+            float a = t * t * (3.0f - 2.0f * t) * ca;
+            row_r[x] += (cr - row_r[x]) * a;
+            row_g[x] += (cg - row_g[x]) * a;
+            row_b[x] += (cb - row_b[x]) * a;
+        }
+    }
+}
+
+static void soft_blend_px(SoftTile *tile, int x, int y, float cr, float cg, float cb, float ca) {
+    size_t i = (size_t)y * SOFT_TILE_PX + (size_t)x;
+    tile->r[i] += (cr - tile->r[i]) * ca;
+    tile->g[i] += (cg - tile->g[i]) * ca;
+    tile->b[i] += (cb - tile->b[i]) * ca;
+}
+
+// Hard-edged 2 px line stepped along its major axis, like unsmoothed GL_LINES.
+static void soft_shade_line(SoftTile *tile, float ax, float ay, float bx, float by, uint32_t rgba) {
+    ax -= (float)tile->x0;
+    bx -= (float)tile->x0;
+    ay -= (float)tile->y0;
+    by -= (float)tile->y0;
+    const float pad = SOFT_LINE_HALF_PX;
+    if (fmaxf(ax, bx) + pad < 0.0f || fminf(ax, bx) - pad > (float)tile->w ||
+        fmaxf(ay, by) + pad < 0.0f || fminf(ay, by) - pad > (float)tile->h) {
+        return;
+    }
+    float cr, cg, cb, ca;
+    soft_color(rgba, &cr, &cg, &cb, &ca);
+    const float dx = bx - ax;
+    const float dy = by - ay;
+    if (fabsf(dx) >= fabsf(dy)) {
+        if (dx == 0.0f) {
+            return;
+        }
+        float lo = fminf(ax, bx);
+        float hi = fmaxf(ax, bx);
+        int x0 = lo < 0.0f ? 0 : (int)lo;
+        int x1 = hi > (float)(tile->w - 1) ? tile->w - 1 : (int)hi;
+        for (int x = x0; x <= x1; ++x) {
+            float cx = (float)x + 0.5f;
+            if (cx < lo || cx > hi) {
+                continue;
+            }
+            float yc = ay + (cx - ax) * (dy / dx);
+            int y_lo = (int)floorf(yc - pad + 0.5f);
+            for (int y = y_lo; y < y_lo + 2; ++y) {
+                if (y >= 0 && y < tile->h) {
+                    soft_blend_px(tile, x, y, cr, cg, cb, ca);
+                }
+            }
+        }
+    } else {
+        float lo = fminf(ay, by);
+        float hi = fmaxf(ay, by);
+        int y0 = lo < 0.0f ? 0 : (int)lo;
+        int y1 = hi > (float)(tile->h - 1) ? tile->h - 1 : (int)hi;
+        for (int y = y0; y <= y1; ++y) {
+            float cy = (float)y + 0.5f;
+            if (cy < lo || cy > hi) {
+                continue;
+            }
+            float xc = ax + (cy - ay) * (dx / dy);
+            int x_lo = (int)floorf(xc - pad + 0.5f);
+            for (int x = x_lo; x < x_lo + 2; ++x) {
+                if (x >= 0 && x < tile->w) {
+                    soft_blend_px(tile, x, y, cr, cg, cb, ca);
+                }
+            }
+        }
+    }
+}
+
+static void soft_raster_tiles(void *user, size_t begin, size_t end) {
+    SoftRender *sr = (SoftRender *)user;
+    const RenderView *view = sr->view;
+    SoftTile tile;
+    for (size_t t = begin; t < end; ++t) {
+        tile.x0 = (int)(t % (size_t)sr->tiles_x) * SOFT_TILE_PX;
+        tile.y0 = (int)(t / (size_t)sr->tiles_x) * SOFT_TILE_PX;
+        tile.w = sr->width - tile.x0 < SOFT_TILE_PX ? sr->width - tile.x0 : SOFT_TILE_PX;
+        tile.h = sr->height - tile.y0 < SOFT_TILE_PX ? sr->height - tile.y0 : SOFT_TILE_PX;
+        for (size_t i = 0; i < SOFT_TILE_PX * SOFT_TILE_PX; ++i) {
+            tile.r[i] = sr->clear_color[0];
+            tile.g[i] = sr->clear_color[1];
+            tile.b[i] = sr->clear_color[2];
+        }
+
+        for (uint32_t k = sr->tile_start[t]; k < sr->tile_start[t + 1]; ++k) {
+            soft_shade_disc(&tile, &sr->bins[k]);
+        }
+        if (view->debug_line_count > 0 && view->debug_lines_xy && view->debug_line_rgba) {
+            const float half_w = 0.5f * (float)sr->width;
+            const float half_h = 0.5f * (float)sr->height;
+            for (size_t i = 0; i < view->debug_line_count; ++i) {
+                const float *seg = view->debug_lines_xy + i * 4u;
+                soft_shade_line(&tile,
+                                (seg[0] - sr->cam_center[0]) * sr->cam_zoom + half_w,
+                                (seg[1] - sr->cam_center[1]) * sr->cam_zoom + half_h,
+                                (seg[2] - sr->cam_center[0]) * sr->cam_zoom + half_w,
+                                (seg[3] - sr->cam_center[1]) * sr->cam_zoom + half_h,
+                                view->debug_line_rgba[i]);
+            }
+        }
+
+        for (int y = 0; y < tile.h; ++y) {
+            uint8_t *dst = sr->pixels + ((size_t)(tile.y0 + y) * (size_t)sr->width + (size_t)tile.x0) * 4u;
+            const float *src_r = tile.r + y * SOFT_TILE_PX;
+            const float *src_g = tile.g + y * SOFT_TILE_PX;
+            const float *src_b = tile.b + y * SOFT_TILE_PX;
+            for (int x = 0; x < tile.w; ++x) {
+                dst[x * 4 + 0] = (uint8_t)(soft_clamp01(src_r[x]) * 255.0f + 0.5f);
+                dst[x * 4 + 1] = (uint8_t)(soft_clamp01(src_g[x]) * 255.0f + 0.5f);
+                dst[x * 4 + 2] = (uint8_t)(soft_clamp01(src_b[x]) * 255.0f + 0.5f);
+                dst[x * 4 + 3] = 255u;
+            }
+        }
+    }
+}
+
+SoftRender *soft_render_create(const Params *params, int width, int height, JobPool *jobs) {
+    if (!params) {
+        LOG_ERROR("soft_render: null Params");
+        return NULL;
+    }
+    if (width <= 0 || height <= 0) {
+        width = params->window_width_px;
+        height = params->window_height_px;
+    }
+    if (width <= 0 || height <= 0) {
+        LOG_ERROR("soft_render: invalid target size %dx%d", width, height);
+        return NULL;
+    }
+
+    SoftRender *sr = (SoftRender *)mem_calloc(ALLOC_TAG_RENDER, 1, sizeof(SoftRender));
+    if (!sr) {
+        LOG_ERROR("soft_render: failed to allocate state");
+        return NULL;
+    }
+    sr->width = width;
+    sr->height = height;
+    sr->tiles_x = (width + SOFT_TILE_PX - 1) / SOFT_TILE_PX;
+    sr->tiles_y = (height + SOFT_TILE_PX - 1) / SOFT_TILE_PX;
+    sr->tile_count = (size_t)sr->tiles_x * (size_t)sr->tiles_y;
+    sr->jobs = jobs;
+    for (int i = 0; i < 3; ++i) {
+        sr->clear_color[i] = soft_clamp01(params->clear_color_rgba[i]);
+    }
+    sr->default_color_rgba = soft_pack_color(params->bee_color_rgba);
+    sr->default_radius = params->bee_radius_px > 0.0f ? params->bee_radius_px : 1.0f;
+    sr->cam_zoom = 1.0f;
+
+    sr->pixels = (uint8_t *)mem_alloc(ALLOC_TAG_RENDER, (size_t)width * (size_t)height * 4u);
+    sr->slice_cursor = (uint32_t *)mem_alloc(ALLOC_TAG_RENDER,
+                                             sizeof(uint32_t) * SOFT_BIN_SLICES * sr->tile_count);
+    sr->tile_start = (uint32_t *)mem_calloc(ALLOC_TAG_RENDER, sr->tile_count + 1u, sizeof(uint32_t));
+    if (!sr->pixels || !sr->slice_cursor || !sr->tile_start) {
+        LOG_ERROR("soft_render: failed to allocate %dx%d target", width, height);
+        soft_render_destroy(sr);
+        return NULL;
+    }
+    LOG_INFO("soft_render: %dx%d target tiles=%dx%d threads=%d",
+             width, height, sr->tiles_x, sr->tiles_y, jobs_thread_count(jobs));
+    return sr;
+}
+
+void soft_render_destroy(SoftRender *render) {
+    if (!render) {
+        return;
+    }
+    mem_free(ALLOC_TAG_RENDER, render->bins);
+    mem_free(ALLOC_TAG_RENDER, render->tile_start);
+    mem_free(ALLOC_TAG_RENDER, render->slice_cursor);
+    mem_free(ALLOC_TAG_RENDER, render->pixels);
+    mem_free(ALLOC_TAG_RENDER, render);
+}
+
+void soft_render_set_camera(SoftRender *render, const RenderCamera *camera) {
+    if (!render) {
+        return;
+    }
+    if (camera) {
+        render->cam_center[0] = camera->center_world[0];
+        render->cam_center[1] = camera->center_world[1];
+        render->cam_zoom = camera->zoom > 0.0f ? camera->zoom : 1.0f;
+    } else {
+        render->cam_center[0] = 0.0f;
+        render->cam_center[1] = 0.0f;
+        render->cam_zoom = 1.0f;
+    }
+}
+
+void soft_render_fit_camera(SoftRender *render, float world_w, float world_h) {
+    if (!render || world_w <= 0.0f || world_h <= 0.0f) {
+        return;
+    }
+    float fit_x = (float)render->width / world_w;
+    float fit_y = (float)render->height / world_h;
+    render->cam_center[0] = world_w * 0.5f;
+    render->cam_center[1] = world_h * 0.5f;
+    render->cam_zoom = fit_x < fit_y ? fit_x : fit_y;
+}
+
+void soft_render_set_clear_color(SoftRender *render, const float rgba[4]) {
+    if (!render || !rgba) {
+        return;
+    }
+    for (int i = 0; i < 3; ++i) {
+        render->clear_color[i] = soft_clamp01(rgba[i]);
+    }
+}
+
+static bool soft_ensure_bins(SoftRender *sr, size_t desired) {
+    if (desired <= sr->bin_capacity) {
+        return true;
+    }
+    size_t capacity = sr->bin_capacity ? sr->bin_capacity : 4096u;
+    while (capacity < desired) {
+        capacity *= 2u;
+    }
+    // Old contents are dead between frames, so free + alloc avoids a copy.
+    mem_free(ALLOC_TAG_RENDER, sr->bins);
+    sr->bins = (SoftDisc *)mem_alloc(ALLOC_TAG_RENDER, sizeof(SoftDisc) * capacity);
+    sr->bin_capacity = sr->bins ? capacity : 0;
+    if (!sr->bins) {
+        LOG_ERROR("soft_render: failed to grow tile bins to %zu discs", capacity);
+        return false;
+    }
+    return true;
+}
+
+bool soft_render_frame(SoftRender *render, const RenderView *view) {
+    if (!render || !view) {
+        return false;
+    }
+    SoftRender *sr = render;
+    sr->view = view;
+    sr->patch_count = view->patch_count;
+    if (!view->patch_positions_xy || !view->patch_radii_px || !view->patch_fill_rgba ||
+        !view->patch_ring_radii_px || !view->patch_ring_rgba) {
+        sr->patch_count = 0;
+    }
+    size_t bee_count = view->positions_xy ? view->count : 0;
+    sr->item_count = sr->patch_count * 2u + bee_count;
+    if (sr->item_count > UINT32_MAX) {
+        LOG_ERROR("soft_render: %zu items exceed the 32-bit bin index", sr->item_count);
+        sr->view = NULL;
+        return false;
+    }
+    sr->slice_items = (sr->item_count + SOFT_BIN_SLICES - 1u) / SOFT_BIN_SLICES;
+    size_t slice_count = sr->slice_items ? (sr->item_count + sr->slice_items - 1u) / sr->slice_items : 0;
+
+    TRACE_BEGIN("soft_bin");
+    JobCounter done = {0};
+    jobs_parallel_for(sr->jobs, slice_count, 1, soft_bin_count, sr, &done);
+    jobs_wait(sr->jobs, &done);
+
+    // Tile-major, slice-minor prefix sum: each tile's discs stay in draw order.
+    size_t total = 0;
+    for (size_t t = 0; t < sr->tile_count; ++t) {
+        sr->tile_start[t] = (uint32_t)total;
+        for (size_t s = 0; s < slice_count; ++s) {
+            uint32_t *cell = &sr->slice_cursor[s * sr->tile_count + t];
+            uint32_t count = *cell;
+            *cell = (uint32_t)total;
+            total += count;
+        }
+        if (total > UINT32_MAX) {
+            LOG_ERROR("soft_render: tile bins overflow (%zu discs)", total);
+            TRACE_END("soft_bin");
+            return false;
+        }
+    }
+    sr->tile_start[sr->tile_count] = (uint32_t)total;
+    if (!soft_ensure_bins(sr, total)) {
+        TRACE_END("soft_bin");
+        return false;
+    }
+    jobs_parallel_for(sr->jobs, slice_count, 1, soft_bin_scatter, sr, &done);
+    jobs_wait(sr->jobs, &done);
+    TRACE_END("soft_bin");
+
+    TRACE_BEGIN("soft_raster");
+    jobs_parallel_for(sr->jobs, sr->tile_count, 1, soft_raster_tiles, sr, &done);
+    jobs_wait(sr->jobs, &done);
+    TRACE_END("soft_raster");
+
+    sr->view = NULL;
+    return true;
+}
+
+const uint8_t *soft_render_pixels(const SoftRender *render, int *out_width, int *out_height) {
+    if (!render) {
+        return NULL;
+    }
+    if (out_width) {
+        *out_width = render->width;
+    }
+    if (out_height) {
+        *out_height = render->height;
+    }
+    return render->pixels;
+}
+
+bool soft_render_write(const SoftRender *render, const char *path) {
+    if (!render || !path) {
+        return false;
+    }
+    size_t len = strlen(path);
+    if (len >= 4 && strcmp(path + len - 4, ".ppm") == 0) {
+        return image_write_ppm(path, render->pixels, render->width, render->height);
+    }
+    return image_write_png(path, render->pixels, render->width, render->height);
+}
+
+void soft_render_memory_report(const SoftRender *render, MemReport *report) {
+    if (!render || !report) {
+        return;
+    }
+    size_t target = (size_t)render->width * (size_t)render->height * 4u;
+    size_t bins = sizeof(uint32_t) * (SOFT_BIN_SLICES * render->tile_count + render->tile_count + 1u);
+    mem_report_add(report, "soft_render", "target", target, MEM_REGION_CPU, false);
+    mem_report_add(report, "soft_render", "bins", bins, MEM_REGION_CPU, false);
+    mem_report_add(report, "soft_render", "tile_discs", sizeof(SoftDisc) * render->bin_capacity,
+                   MEM_REGION_CPU, true);
+}
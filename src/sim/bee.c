@@ -9,7 +9,7 @@ static float bee_rand_uniform01(uint64_t *state) {
     return (float)((x >> 11) * (1.0 / 9007199254740992.0));
 }
 
-BeeRole bee_pick_role(float age_days, uint64_t *rng_state) {
+BeeRole bee_role_for_roll(float age_days, float roll) {
     if (age_days < 6.0f) {
         return BEE_ROLE_NURSE;
     }
@@ -19,10 +19,6 @@ BeeRole bee_pick_role(float age_days, uint64_t *rng_state) {
     if (age_days < 18.0f) {
         return BEE_ROLE_STORAGE;
     }
-    if (!rng_state) {
-        return BEE_ROLE_FORAGER;
-    }
-    float roll = bee_rand_uniform01(rng_state);
     if (roll < 0.12f) {
         return BEE_ROLE_SCOUT;
     }
@@ -32,6 +28,13 @@ BeeRole bee_pick_role(float age_days, uint64_t *rng_state) {
     return BEE_ROLE_FORAGER;
 }
 
+BeeRole bee_pick_role(float age_days, uint64_t *rng_state) {
+    if (age_days < 18.0f || !rng_state) {
+        return bee_role_for_roll(age_days, 1.0f);
+    }
+    return bee_role_for_roll(age_days, bee_rand_uniform01(rng_state));
+}
+
 void bee_decide_next_action(const BeeDecisionContext *ctx, BeeDecisionOutput *out) {
     if (!out) {
         return;
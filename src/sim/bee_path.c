@@ -122,7 +122,8 @@ bool bee_path_plan(const SimState *state,
                    float target_x,
                    float target_y,
                    float arrive_tol,
-                   BeePathPlan *out_plan) {
+                   BeePathPlan *out_plan,
+                   SimStats *stats) {
     if (!state || index >= state->count || !out_plan) {
         return false;
     }
@@ -147,6 +148,9 @@ bool bee_path_plan(const SimState *state,
         *out_plan = plan;
         return false;
     }
+    if (stats) {
+        stats->path_plans += 1;
+    }
 
     bool inside_now = bee_path_point_inside_hive(state, px, py);
     bool target_inside = bee_path_point_inside_hive(state, target_x, target_y);
@@ -160,6 +164,9 @@ bool bee_path_plan(const SimState *state,
         plan.has_waypoint = 0;
         plan.valid = 1;
         *out_plan = plan;
+        if (stats) {
+            stats->path_los_hits += 1;
+        }
         return true;
     }
 
@@ -201,6 +208,9 @@ bool bee_path_plan(const SimState *state,
         plan.has_waypoint = plan_uses_entrance;
         plan.valid = 1;
         *out_plan = plan;
+        if (stats) {
+            stats->path_los_hits += 1;
+        }
         return true;
     }
 
@@ -236,6 +246,7 @@ bool bee_path_plan(const SimState *state,
     float best_probe_x = plan_target_x;
     float best_probe_y = plan_target_y;
     bool found = false;
+    uint64_t probe_rays = 0;
 
     float velocity_len = sqrtf(vx * vx + vy * vy);
     float vel_dir_x = 0.0f;
@@ -257,6 +268,7 @@ bool bee_path_plan(const SimState *state,
         }
         dir_x /= norm;
         dir_y /= norm;
+        ++probe_rays;
 
         float probe_x = px + dir_x * lookahead;
         float probe_y = py + dir_y * lookahead;
@@ -291,6 +303,9 @@ bool bee_path_plan(const SimState *state,
         }
     }
 
+    if (stats) {
+        stats->path_probe_rays += probe_rays;
+    }
     if (!found) {
         return false;
     }
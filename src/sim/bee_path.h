@@ -6,6 +6,7 @@
 #include <stdint.h>
 
 struct SimState;
+struct SimStats;
 
 typedef struct BeePathPlan {
     float dir_x;
@@ -23,6 +24,8 @@ bool bee_path_plan(const struct SimState *state,
                    float target_x,
                    float target_y,
                    float arrive_tol,
-                   BeePathPlan *out_plan);
+                   BeePathPlan *out_plan,
+                   struct SimStats *stats);
+// stats (optional) receives plan, line-of-sight and probe-ray counts.
 
 #endif  // SIM_BEE_PATH_H
@@ -0,0 +1,208 @@
+#include "checkpoint.h"
+
+#include <string.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "util/clock.h"
+#include "util/log.h"
+
+#include "sim_internal.h"
+
+void checkpoint_manager_init(CheckpointManager *manager, int max_concurrent) {
+    if (!manager) {
+        return;
+    }
+    memset(manager, 0, sizeof(*manager));
+    if (max_concurrent < 1) {
+        max_concurrent = 1;
+    }
+    if (max_concurrent > CHECKPOINT_MAX_CONCURRENT) {
+        max_concurrent = CHECKPOINT_MAX_CONCURRENT;
+    }
+    manager->max_concurrent = max_concurrent;
+}
+
+int checkpoint_active_count(const CheckpointManager *manager) {
+    if (!manager) {
+        return 0;
+    }
+    int active = 0;
+    for (int i = 0; i < CHECKPOINT_MAX_CONCURRENT; ++i) {
+        if (manager->slots[i].active) {
+            ++active;
+        }
+    }
+    return active;
+}
+
+#ifdef _WIN32
+
+bool checkpoint_request(CheckpointManager *manager, const SimState *state, const char *path_prefix) {
+    if (!manager || !state || !path_prefix || !path_prefix[0]) {
+        return false;
+    }
+    static bool warned = false;
+    if (!warned) {
+        LOG_WARN("checkpoint: fork() unavailable on this platform; writing synchronously");
+        warned = true;
+    }
+    manager->started += 1;
+    if (sim_write_tick_snapshot(state, path_prefix)) {
+        manager->completed += 1;
+        return true;
+    }
+    manager->failed += 1;
+    return false;
+}
+
+void checkpoint_poll(CheckpointManager *manager) {
+    (void)manager;
+}
+
+void checkpoint_manager_shutdown(CheckpointManager *manager) {
+    if (!manager) {
+        return;
+    }
+    LOG_INFO("checkpoint: started=%llu completed=%llu failed=%llu skipped=%llu",
+             (unsigned long long)manager->started,
+             (unsigned long long)manager->completed,
+             (unsigned long long)manager->failed,
+             (unsigned long long)manager->skipped);
+}
+
+#else
+
+static void checkpoint_finish(CheckpointManager *manager, CheckpointSlot *slot, int status) {
+    double elapsed_ms = clock_ns_to_ms(clock_now_ns() - slot->start_ns);
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+        manager->completed += 1;
+        LOG_INFO("checkpoint: pid=%ld wrote '%s' tick=%llu in %.1fms",
+                 slot->pid, slot->path, (unsigned long long)slot->tick, elapsed_ms);
+    } else {
+        manager->failed += 1;
+        LOG_ERROR("checkpoint: pid=%ld failed writing '%s' (status=0x%x)",
+                  slot->pid, slot->path, (unsigned)status);
+    }
+    slot->active = false;
+}
+
+bool checkpoint_request(CheckpointManager *manager, const SimState *state, const char *path_prefix) {
+    if (!manager || !state || !path_prefix || !path_prefix[0]) {
+        return false;
+    }
+    checkpoint_poll(manager);
+
+    CheckpointSlot *slot = NULL;
+    if (checkpoint_active_count(manager) < manager->max_concurrent) {
+        for (int i = 0; i < CHECKPOINT_MAX_CONCURRENT; ++i) {
+            if (!manager->slots[i].active) {
+                slot = &manager->slots[i];
+                break;
+            }
+        }
+    }
+    if (!slot) {
+        manager->skipped += 1;
+        LOG_WARN("checkpoint: skipping tick %llu; %d checkpoint(s) still writing",
+                 (unsigned long long)state->tick_index, manager->max_concurrent);
+        return false;
+    }
+    if (!sim_snapshot_format_path(state, path_prefix, slot->path, sizeof slot->path)) {
+        LOG_ERROR("checkpoint: path prefix too long");
+        return false;
+    }
+    // Formatted before fork(): the child may not call snprintf, since another
+    // thread could have held a libc lock at the moment of the fork.
+    SimSnapshotLayout layout;
+    if (!sim_snapshot_layout(state, &layout)) {
+        LOG_ERROR("checkpoint: snapshot schema exceeds %u bytes", SIM_SNAPSHOT_SCHEMA_CAP);
+        return false;
+    }
+
+    uint64_t fork_start_ns = clock_now_ns();
+    pid_t pid = fork();
+    if (pid < 0) {
+        LOG_ERROR("checkpoint: fork failed (errno=%d); writing synchronously", errno);
+        manager->started += 1;
+        if (sim_write_snapshot(state, slot->path)) {
+            manager->completed += 1;
+            return true;
+        }
+        manager->failed += 1;
+        return false;
+    }
+    if (pid == 0) {
+        // Child: only async-signal-safe work from here on. No logging, no
+        // stdio flush, no atexit handlers.
+        bool ok = sim_snapshot_write_layout(state, &layout, slot->path);
+        _exit(ok ? 0 : 1);
+    }
+
+    uint64_t now_ns = clock_now_ns();
+    slot->active = true;
+    slot->pid = (long)pid;
+    slot->tick = state->tick_index;
+    slot->start_ns = now_ns;
+    manager->started += 1;
+    LOG_INFO("checkpoint: forked pid=%ld tick=%llu (fork %.2fms, %d active)",
+             slot->pid, (unsigned long long)slot->tick,
+             clock_ns_to_ms(now_ns - fork_start_ns), checkpoint_active_count(manager));
+    return true;
+}
+
+void checkpoint_poll(CheckpointManager *manager) {
+    if (!manager) {
+        return;
+    }
+    for (int i = 0; i < CHECKPOINT_MAX_CONCURRENT; ++i) {
+        CheckpointSlot *slot = &manager->slots[i];
+        if (!slot->active) {
+            continue;
+        }
+        int status = 0;
+        pid_t done = waitpid((pid_t)slot->pid, &status, WNOHANG);
+        if (done == (pid_t)slot->pid) {
+            checkpoint_finish(manager, slot, status);
+        } else if (done < 0 && errno != EINTR) {
+            manager->failed += 1;
+            LOG_ERROR("checkpoint: lost track of pid=%ld (errno=%d)", slot->pid, errno);
+            slot->active = false;
+        }
+    }
+}
+
+void checkpoint_manager_shutdown(CheckpointManager *manager) {
+    if (!manager) {
+        return;
+    }
+    for (int i = 0; i < CHECKPOINT_MAX_CONCURRENT; ++i) {
+        CheckpointSlot *slot = &manager->slots[i];
+        if (!slot->active) {
+            continue;
+        }
+        int status = 0;
+        pid_t done = -1;
+        do {
+            done = waitpid((pid_t)slot->pid, &status, 0);
+        } while (done < 0 && errno == EINTR);
+        if (done == (pid_t)slot->pid) {
+            checkpoint_finish(manager, slot, status);
+        } else {
+            manager->failed += 1;
+            slot->active = false;
+        }
+    }
+    LOG_INFO("checkpoint: started=%llu completed=%llu failed=%llu skipped=%llu",
+             (unsigned long long)manager->started,
+             (unsigned long long)manager->completed,
+             (unsigned long long)manager->failed,
+             (unsigned long long)manager->skipped);
+}
+
+#endif
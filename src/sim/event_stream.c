@@ -0,0 +1,278 @@
+#include "event_stream.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "util/alloc.h"
+#include "util/log.h"
+#include "util/thread.h"
+#include "util/trace.h"
+
+#define EVENT_CHUNK_RECORDS 4096u
+#define EVENT_SPARE_CHUNKS 4u
+
+typedef struct EventChunk {
+    BeeEventRecord *records;
+    size_t count;
+} EventChunk;
+
+struct EventStream {
+    FILE *file;
+    uint32_t mask;
+    size_t producer_count;
+    EventProducer *producers;
+    size_t *producer_chunk;
+
+    EventChunk *chunks;
+    size_t chunk_count;
+    size_t *free_stack;
+    size_t free_count;
+    size_t *full_queue;
+    size_t full_head;
+    size_t full_count;
+
+    ThreadMutex lock;
+    ThreadCond work_ready;
+    ThreadCond chunk_freed;
+    ThreadHandle writer;
+    int writer_trace_slot;
+    bool writer_running;
+    bool stopping;
+    bool write_failed;
+
+    uint64_t records_written;
+    uint64_t producer_stalls;
+};
+
+static int event_stream_writer_main(void *user) {
+    EventStream *stream = (EventStream *)user;
+    trace_bind_thread(stream->writer_trace_slot);
+    thread_mutex_lock(&stream->lock);
+    for (;;) {
+        while (stream->full_count == 0 && !stream->stopping) {
+            thread_cond_wait(&stream->work_ready, &stream->lock);
+        }
+        if (stream->full_count == 0 && stream->stopping) {
+            break;
+        }
+        size_t chunk_index = stream->full_queue[stream->full_head];
+        stream->full_head = (stream->full_head + 1) % stream->chunk_count;
+        stream->full_count -= 1;
+        thread_mutex_unlock(&stream->lock);
+
+        EventChunk *chunk = &stream->chunks[chunk_index];
+        TRACE_BEGIN("events_write");
+        size_t written = fwrite(chunk->records, sizeof(BeeEventRecord), chunk->count, stream->file);
+        TRACE_END("events_write");
+
+        thread_mutex_lock(&stream->lock);
+        if (written != chunk->count) {
+            stream->write_failed = true;
+        }
+        stream->records_written += written;
+        chunk->count = 0;
+        stream->free_stack[stream->free_count++] = chunk_index;
+        thread_cond_signal(&stream->chunk_freed);
+    }
+    thread_mutex_unlock(&stream->lock);
+    return 0;
+}
+
+static void event_stream_release(EventStream *stream) {
+    if (!stream) {
+        return;
+    }
+    if (stream->chunks) {
+        for (size_t i = 0; i < stream->chunk_count; ++i) {
+            mem_free(ALLOC_TAG_IO, stream->chunks[i].records);
+        }
+    }
+    mem_free(ALLOC_TAG_IO, stream->chunks);
+    mem_free(ALLOC_TAG_IO, stream->free_stack);
+    mem_free(ALLOC_TAG_IO, stream->full_queue);
+    mem_free(ALLOC_TAG_IO, stream->producers);
+    mem_free(ALLOC_TAG_IO, stream->producer_chunk);
+    if (stream->file) {
+        fclose(stream->file);
+    }
+    mem_free(ALLOC_TAG_IO, stream);
+}
+
+EventStream *event_stream_open(const char *path,
+                               uint32_t mask,
+                               size_t producer_count,
+                               double tick_dt_sec,
+                               uint64_t seed) {
+    if (!path || !path[0] || producer_count == 0) {
+        LOG_ERROR("events: invalid open arguments");
+        return NULL;
+    }
+    const uint16_t byte_order_probe = 1u;
+    if (*(const uint8_t *)&byte_order_probe != 1u) {
+        LOG_ERROR("events: the file format is little-endian; this host is not");
+        return NULL;
+    }
+
+    EventStream *stream = (EventStream *)mem_calloc(ALLOC_TAG_IO, 1, sizeof(EventStream));
+    if (!stream) {
+        LOG_ERROR("events: failed to allocate stream");
+        return NULL;
+    }
+    stream->mask = mask & BEE_EVENT_MASK_ALL;
+    stream->producer_count = producer_count;
+    stream->chunk_count = producer_count + EVENT_SPARE_CHUNKS;
+    stream->producers = (EventProducer *)mem_calloc(ALLOC_TAG_IO, producer_count, sizeof(EventProducer));
+    stream->producer_chunk = (size_t *)mem_calloc(ALLOC_TAG_IO, producer_count, sizeof(size_t));
+    stream->chunks = (EventChunk *)mem_calloc(ALLOC_TAG_IO, stream->chunk_count, sizeof(EventChunk));
+    stream->free_stack = (size_t *)mem_calloc(ALLOC_TAG_IO, stream->chunk_count, sizeof(size_t));
+    stream->full_queue = (size_t *)mem_calloc(ALLOC_TAG_IO, stream->chunk_count, sizeof(size_t));
+    if (!stream->producers || !stream->producer_chunk || !stream->chunks ||
+        !stream->free_stack || !stream->full_queue) {
+        LOG_ERROR("events: failed to allocate stream bookkeeping");
+        event_stream_release(stream);
+        return NULL;
+    }
+    for (size_t i = 0; i < stream->chunk_count; ++i) {
+        stream->chunks[i].records = (BeeEventRecord *)mem_alloc(
+            ALLOC_TAG_IO, sizeof(BeeEventRecord) * EVENT_CHUNK_RECORDS);
+        if (!stream->chunks[i].records) {
+            LOG_ERROR("events: failed to allocate chunk buffers");
+            event_stream_release(stream);
+            return NULL;
+        }
+    }
+
+    stream->file = fopen(path, "wb");
+    if (!stream->file) {
+        LOG_ERROR("events: failed to open '%s' for writing", path);
+        event_stream_release(stream);
+        return NULL;
+    }
+
+    BeeEventFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BEE_EVENT_MAGIC, sizeof(BEE_EVENT_MAGIC));
+    header.version = BEE_EVENT_VERSION;
+    header.record_size = (uint32_t)sizeof(BeeEventRecord);
+    header.mask = stream->mask;
+    header.tick_dt_sec = tick_dt_sec;
+    header.seed = seed;
+    if (fwrite(&header, sizeof(header), 1, stream->file) != 1) {
+        LOG_ERROR("events: failed to write header to '%s'", path);
+        event_stream_release(stream);
+        return NULL;
+    }
+
+    // Producers own the first chunks; the rest start on the free stack.
+    for (size_t i = 0; i < producer_count; ++i) {
+        EventProducer *producer = &stream->producers[i];
+        producer->stream = stream;
+        producer->index = i;
+        producer->cursor = stream->chunks[i].records;
+        producer->end = producer->cursor + EVENT_CHUNK_RECORDS;
+        stream->producer_chunk[i] = i;
+    }
+    for (size_t i = producer_count; i < stream->chunk_count; ++i) {
+        stream->free_stack[stream->free_count++] = i;
+    }
+
+    // Reserved here so the trace buffer is allocated on the opening thread.
+    stream->writer_trace_slot = trace_reserve_thread("event_writer");
+    thread_mutex_init(&stream->lock);
+    thread_cond_init(&stream->work_ready);
+    thread_cond_init(&stream->chunk_freed);
+    if (!thread_create(&stream->writer, event_stream_writer_main, stream)) {
+        LOG_ERROR("events: failed to start writer thread");
+        thread_cond_destroy(&stream->chunk_freed);
+        thread_cond_destroy(&stream->work_ready);
+        thread_mutex_destroy(&stream->lock);
+        event_stream_release(stream);
+        return NULL;
+    }
+    stream->writer_running = true;
+
+    LOG_INFO("events: writing '%s' mask=0x%x record=%zu bytes producers=%zu",
+             path, stream->mask, sizeof(BeeEventRecord), producer_count);
+    return stream;
+}
+
+static void event_stream_enqueue_locked(EventStream *stream, size_t chunk_index, size_t count) {
+    stream->chunks[chunk_index].count = count;
+    size_t tail = (stream->full_head + stream->full_count) % stream->chunk_count;
+    stream->full_queue[tail] = chunk_index;
+    stream->full_count += 1;
+    thread_cond_signal(&stream->work_ready);
+}
+
+void event_producer_submit(EventProducer *producer) {
+    if (!producer || !producer->stream) {
+        return;
+    }
+    EventStream *stream = producer->stream;
+    size_t current = stream->producer_chunk[producer->index];
+    size_t count = (size_t)(producer->cursor - stream->chunks[current].records);
+
+    thread_mutex_lock(&stream->lock);
+    if (count > 0) {
+        event_stream_enqueue_locked(stream, current, count);
+        if (stream->free_count == 0) {
+            stream->producer_stalls += 1;
+        }
+        while (stream->free_count == 0) {
+            thread_cond_wait(&stream->chunk_freed, &stream->lock);
+        }
+        current = stream->free_stack[--stream->free_count];
+        stream->producer_chunk[producer->index] = current;
+    }
+    thread_mutex_unlock(&stream->lock);
+
+    producer->cursor = stream->chunks[current].records;
+    producer->end = producer->cursor + EVENT_CHUNK_RECORDS;
+}
+
+void event_stream_close(EventStream *stream) {
+    if (!stream) {
+        return;
+    }
+    if (stream->writer_running) {
+        thread_mutex_lock(&stream->lock);
+        for (size_t i = 0; i < stream->producer_count; ++i) {
+            EventProducer *producer = &stream->producers[i];
+            size_t current = stream->producer_chunk[i];
+            size_t count = (size_t)(producer->cursor - stream->chunks[current].records);
+            if (count > 0) {
+                event_stream_enqueue_locked(stream, current, count);
+            }
+            producer->cursor = NULL;
+            producer->end = NULL;
+        }
+        stream->stopping = true;
+        thread_cond_signal(&stream->work_ready);
+        thread_mutex_unlock(&stream->lock);
+        thread_join(&stream->writer);
+        stream->writer_running = false;
+        thread_cond_destroy(&stream->chunk_freed);
+        thread_cond_destroy(&stream->work_ready);
+        thread_mutex_destroy(&stream->lock);
+    }
+
+    if (stream->write_failed) {
+        LOG_ERROR("events: short write; stream is truncated");
+    }
+    LOG_INFO("events: closed records=%llu stalls=%llu",
+             (unsigned long long)stream->records_written,
+             (unsigned long long)stream->producer_stalls);
+    event_stream_release(stream);
+}
+
+uint32_t event_stream_mask(const EventStream *stream) {
+    return stream ? stream->mask : 0u;
+}
+
+EventProducer *event_stream_producer(EventStream *stream, size_t index) {
+    if (!stream || index >= stream->producer_count) {
+        return NULL;
+    }
+    return &stream->producers[index];
+}
@@ -5,6 +5,7 @@ static void hive_clear_segments(SimState *state) {
         return;
     }
     state->hive_segment_count = 0;
+    state->hive_entrance_valid = 0;
 }
 
 static void hive_add_segment(SimState *state,
@@ -76,6 +77,17 @@ void hive_build_segments(SimState *state) {
         gap_max = fminf(y + h, gap_center + gap_half);
     }
 
+    if (gap_max > gap_min && side >= 0 && side <= 3) {
+        HiveSegment *gap = &state->hive_entrance;
+        gap->ax = side <= 1 ? gap_min : (side == 2 ? x : x + w);
+        gap->bx = side <= 1 ? gap_max : gap->ax;
+        gap->ay = side >= 2 ? gap_min : (side == 0 ? y : y + h);
+        gap->by = side >= 2 ? gap_max : gap->ay;
+        gap->nx = 0.0f;
+        gap->ny = 0.0f;
+        state->hive_entrance_valid = 1;
+    }
+
     if (side == 0) {
         if (gap_min > x) {
             hive_add_segment(state, x, y, gap_min, y, 0.0f, -1.0f);
@@ -203,20 +215,31 @@ void hive_resolve_disc(const SimState *state,
                        float *x,
                        float *y,
                        float *vx,
-                       float *vy) {
+                       float *vy,
+                       SimStats *stats) {
     if (!state || !state->hive_enabled || state->hive_segment_count == 0) {
         return;
     }
     int max_iters = state->hive_max_iters > 0 ? state->hive_max_iters : 1;
+    uint64_t iters = 0;
+    uint64_t collisions = 0;
     for (int iter = 0; iter < max_iters; ++iter) {
         int collided = 0;
+        ++iters;
         for (size_t si = 0; si < state->hive_segment_count; ++si) {
-            collided |= hive_resolve_segment(state, &state->hive_segments[si], radius, x, y, vx, vy);
+            int hit = hive_resolve_segment(state, &state->hive_segments[si], radius, x, y, vx, vy);
+            collisions += (uint64_t)hit;
+            collided |= hit;
         }
         if (!collided) {
             break;
         }
     }
+    if (stats) {
+        stats->hive_resolve_iters += iters;
+        stats->hive_segment_tests += iters * state->hive_segment_count;
+        stats->hive_collisions += collisions;
+    }
 }
 
 void hive_compute_points(const SimState *state,
@@ -4,7 +4,9 @@
 #include "sim_internal.h"
 
 void hive_build_segments(SimState *state);
-void hive_resolve_disc(const SimState *state, float radius, float *x, float *y, float *vx, float *vy);
+void hive_resolve_disc(const SimState *state, float radius, float *x, float *y, float *vx, float *vy,
+                       SimStats *stats);
+// stats (optional) receives segment tests, collisions and iterations used.
 void hive_compute_points(const SimState *state, float *entrance_x, float *entrance_y, float *unload_x, float *unload_y);
 
 #endif  // SIM_HIVE_H
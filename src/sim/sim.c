@@ -5,45 +5,30 @@
 #include <stdlib.h>
 #include <string.h>
 
-#ifdef _MSC_VER
-#include <malloc.h>
-#endif
-
+#include "util/alloc.h"
+#include "util/clock.h"
 #include "util/log.h"
+#include "util/rng.h"
+#include "util/trace.h"
 
 #include "sim_internal.h"
 #include "bee_path.h"
 #include "hive.h"
 #include "plants.h"
+#include "trips.h"
+
+#define SIM_FILL_BLOCK 256
+#define SIM_FILL_CHUNK 16384
 
+// Not zeroed: fill_bee_chunks writes every element, so zeroing would only
+// double the setup stores. Any new per-bee column must therefore be written
+// in fill_bee_chunks.
 static void *alloc_aligned(size_t bytes) {
-    if (bytes == 0) {
-        return NULL;
-    }
-#if defined(_MSC_VER)
-    void *ptr = _aligned_malloc(bytes, 16);
-    if (ptr) {
-        memset(ptr, 0, bytes);
-    }
-    return ptr;
-#else
-    void *ptr = NULL;
-    if (posix_memalign(&ptr, 16, bytes) != 0) {
-        return NULL;
-    }
-    memset(ptr, 0, bytes);
-    return ptr;
-#endif
+    return mem_alloc_aligned(ALLOC_TAG_SIM, bytes, 16);
 }
 
 static void free_aligned(void *ptr) {
-#if defined(_MSC_VER)
-    if (ptr) {
-        _aligned_free(ptr);
-    }
-#else
-    free(ptr);
-#endif
+    mem_free_aligned(ALLOC_TAG_SIM, ptr);
 }
 
 static float clamp_positive(float value, float min_value) {
@@ -82,22 +67,6 @@ static uint32_t bee_color_for(uint8_t role, uint8_t mode) {
     return bee_mode_color(mode);
 }
 
-static float rand_angle(uint64_t *state) {
-    return rand_uniform01(state) * TWO_PI - (float)M_PI;
-}
-
-static float sample_gaussian(uint64_t *state, float mean, float stddev) {
-    if (stddev <= 0.0f) {
-        return mean;
-    }
-    float u1 = rand_uniform01(state);
-    float u2 = rand_uniform01(state);
-    u1 = u1 <= 1e-6f ? 1e-6f : u1;
-    float mag = stddev * sqrtf(-2.0f * logf(u1));
-    float z0 = mag * cosf(TWO_PI * u2);
-    return mean + z0;
-}
-
 static float wrap_angle(float angle) {
     angle = fmodf(angle + (float)M_PI, TWO_PI);
     if (angle < 0.0f) {
@@ -172,6 +141,122 @@ static void reset_log_stats(SimState *state) {
     state->log_speed_max = 0.0;
 }
 
+typedef struct FillContext {
+    SimState *state;
+    uint64_t stream_seed;
+    size_t cols;
+    float spacing;
+    float origin_x;
+    float origin_y;
+    float min_x;
+    float max_x;
+    float min_y;
+    float max_y;
+    float unload_x;
+    float unload_y;
+} FillContext;
+
+// Initializes bees in chunks [begin, end) of SIM_FILL_CHUNK. Every per-bee
+// array is written here. Each chunk draws from its own lane stream keyed by
+// chunk index, which keeps the colony identical for any thread count.
+// Chunks go to whichever worker steals them, and sim_tick runs every bee on
+// the calling thread, so on NUMA machines this scatters pages away from the
+// ticking thread rather than placing them near it; the parallel fill buys
+// setup time only.
+static void fill_bee_chunks(void *user, size_t begin, size_t end) {
+    const FillContext *ctx = (const FillContext *)user;
+    SimState *state = ctx->state;
+    const float bee_radius = state->default_radius;
+    const float jitter_extent = bee_radius * 0.25f;
+    float jitter_x_buf[SIM_FILL_BLOCK];
+    float jitter_y_buf[SIM_FILL_BLOCK];
+    float heading_buf[SIM_FILL_BLOCK];
+    float age_buf[SIM_FILL_BLOCK];
+    float roll_buf[SIM_FILL_BLOCK];
+
+    for (size_t chunk = begin; chunk < end; ++chunk) {
+        size_t chunk_begin = chunk * SIM_FILL_CHUNK;
+        size_t chunk_end = chunk_begin + SIM_FILL_CHUNK;
+        if (chunk_end > state->count) {
+            chunk_end = state->count;
+        }
+        RngLanes lanes;
+        rng_lanes_seed_stream(&lanes, ctx->stream_seed, (uint64_t)chunk);
+
+        for (size_t block = chunk_begin; block < chunk_end; block += SIM_FILL_BLOCK) {
+            size_t block_count = chunk_end - block;
+            if (block_count > SIM_FILL_BLOCK) {
+                block_count = SIM_FILL_BLOCK;
+            }
+            rng_fill_range(&lanes, jitter_x_buf, block_count, -jitter_extent, jitter_extent);
+            rng_fill_range(&lanes, jitter_y_buf, block_count, -jitter_extent, jitter_extent);
+            rng_fill_range(&lanes, heading_buf, block_count, -(float)M_PI, (float)M_PI);
+            rng_fill_range(&lanes, age_buf, block_count, 0.0f, 25.0f);
+            rng_fill_uniform01(&lanes, roll_buf, block_count);
+
+            for (size_t k = 0; k < block_count; ++k) {
+                size_t i = block + k;
+                size_t col = i % ctx->cols;
+                size_t row = i / ctx->cols;
+
+                float x = ctx->origin_x + (float)col * ctx->spacing + jitter_x_buf[k];
+                float y = ctx->origin_y + (float)row * ctx->spacing + jitter_y_buf[k];
+                if (i == 0 && state->hive_enabled) {
+                    x = ctx->unload_x;
+                    y = ctx->unload_y;
+                }
+                x = clampf(x, ctx->min_x, ctx->max_x);
+                y = clampf(y, ctx->min_y, ctx->max_y);
+
+                state->x[i] = x;
+                state->y[i] = y;
+                state->scratch_xy[2 * i + 0] = x;
+                state->scratch_xy[2 * i + 1] = y;
+                state->heading[i] = heading_buf[k];
+                state->vx[i] = 0.0f;
+                state->vy[i] = 0.0f;
+                state->radius[i] = bee_radius;
+
+                float age_days = age_buf[k];
+                state->age_days[i] = age_days;
+                state->t_state[i] = 0.0f;
+                state->energy[i] = 1.0f;
+                state->load_nectar[i] = 0.0f;
+                state->target_pos_x[i] = ctx->unload_x;
+                state->target_pos_y[i] = ctx->unload_y;
+                state->target_id[i] = -1;
+                state->topic_id[i] = -1;
+                state->topic_confidence[i] = 0;
+                state->capacity_uL[i] = state->bee_capacity_uL;
+                state->harvest_rate_uLps[i] = state->bee_harvest_rate_uLps;
+
+                BeeRole role = (i == 0) ? BEE_ROLE_QUEEN : bee_role_for_roll(age_days, roll_buf[k]);
+                state->role[i] = (uint8_t)role;
+
+                state->mode[i] = (uint8_t)BEE_MODE_IDLE;
+                state->intent[i] = (uint8_t)BEE_INTENT_REST;
+                state->color_rgba[i] = bee_color_for(state->role[i], state->mode[i]);
+
+                bool inside = state->hive_enabled &&
+                              x >= state->hive_rect_x &&
+                              x <= state->hive_rect_x + state->hive_rect_w &&
+                              y >= state->hive_rect_y &&
+                              y <= state->hive_rect_y + state->hive_rect_h;
+                state->inside_hive_flag[i] = inside ? 1u : 0u;
+                if (i == 0 && state->hive_enabled) {
+                    state->inside_hive_flag[i] = 1u;
+                }
+                state->path_valid[i] = 0u;
+                state->path_has_waypoint[i] = 0u;
+                state->path_waypoint_x[i] = ctx->unload_x;
+                state->path_waypoint_y[i] = ctx->unload_y;
+                state->hex_tile[i] = hex_grid_tile_at(&state->hex, x, y);
+            }
+        }
+        trips_reset_bees(state, chunk_begin, chunk_end);
+    }
+}
+
 static void fill_bees(SimState *state, const Params *params, uint64_t seed) {
     if (!state) {
         return;
@@ -186,6 +271,9 @@ static void fill_bees(SimState *state, const Params *params, uint64_t seed) {
     }
     state->seed = seed;
     state->rng_state = seed;
+    state->tick_index = 0;
+    state->sim_time_sec = 0.0;
+    memset(&state->last_stats, 0, sizeof(state->last_stats));
 
     float entrance_x = state->world_w * 0.5f;
     float entrance_y = state->world_h * 0.5f;
@@ -203,109 +291,48 @@ static void fill_bees(SimState *state, const Params *params, uint64_t seed) {
 
     const float grid_w = (float)(cols - 1) * spacing;
     const float grid_h = (float)(rows - 1) * spacing;
-    const float origin_x = state->world_w * 0.5f - grid_w * 0.5f;
-    const float origin_y = state->world_h * 0.5f - grid_h * 0.5f;
-    const float min_x_allowed = bee_radius + state->bounce_margin;
-    const float max_x_allowed = state->world_w - bee_radius - state->bounce_margin;
-    const float min_y_allowed = bee_radius + state->bounce_margin;
-    const float max_y_allowed = state->world_h - bee_radius - state->bounce_margin;
 
+    FillContext ctx;
+    ctx.state = state;
+    ctx.cols = cols;
+    ctx.spacing = spacing;
+    ctx.origin_x = state->world_w * 0.5f - grid_w * 0.5f;
+    ctx.origin_y = state->world_h * 0.5f - grid_h * 0.5f;
+    ctx.min_x = bee_radius + state->bounce_margin;
+    ctx.max_x = state->world_w - bee_radius - state->bounce_margin;
+    ctx.min_y = bee_radius + state->bounce_margin;
+    ctx.max_y = state->world_h - bee_radius - state->bounce_margin;
+    if (ctx.min_x > ctx.max_x) {
+        ctx.min_x = ctx.max_x = state->world_w * 0.5f;
+    }
+    if (ctx.min_y > ctx.max_y) {
+        ctx.min_y = ctx.max_y = state->world_h * 0.5f;
+    }
+    ctx.unload_x = unload_x;
+    ctx.unload_y = unload_y;
 
     uint64_t rng = state->rng_state;
 
     plants_generate(state, &rng);
 
-    for (size_t i = 0; i < state->count; ++i) {
-        size_t col = i % cols;
-        size_t row = i / cols;
-
-        float base_x = origin_x + (float)col * spacing;
-        float base_y = origin_y + (float)row * spacing;
-
-        float jitter_x = rand_symmetric(&rng) * bee_radius * 0.25f;
-        float jitter_y = rand_symmetric(&rng) * bee_radius * 0.25f;
-
-        float x = base_x + jitter_x;
-        float y = base_y + jitter_y;
-
-        if (i == 0 && state->hive_enabled) {
-            x = unload_x;
-            y = unload_y;
-        }
-
-        float clamped_min_x = min_x_allowed;
-        float clamped_max_x = max_x_allowed;
-        if (clamped_min_x > clamped_max_x) {
-            float mid = state->world_w * 0.5f;
-            clamped_min_x = clamped_max_x = mid;
-        }
-        float clamped_min_y = min_y_allowed;
-        float clamped_max_y = max_y_allowed;
-        if (clamped_min_y > clamped_max_y) {
-            float mid = state->world_h * 0.5f;
-            clamped_min_y = clamped_max_y = mid;
-        }
-
-        if (x < clamped_min_x) x = clamped_min_x;
-        if (x > clamped_max_x) x = clamped_max_x;
-        if (y < clamped_min_y) y = clamped_min_y;
-        if (y > clamped_max_y) y = clamped_max_y;
-
-        float heading = rand_angle(&rng);
-
-        state->x[i] = x;
-        state->y[i] = y;
-        state->heading[i] = heading;
-        state->vx[i] = 0.0f;
-        state->vy[i] = 0.0f;
-        state->radius[i] = bee_radius;
-
-        float age_days = rand_uniform01(&rng) * 25.0f;
-        state->age_days[i] = age_days;
-        state->t_state[i] = 0.0f;
-        state->energy[i] = 1.0f;
-        state->load_nectar[i] = 0.0f;
-        state->target_pos_x[i] = unload_x;
-        state->target_pos_y[i] = unload_y;
-        state->target_id[i] = -1;
-        state->topic_id[i] = -1;
-        state->topic_confidence[i] = 0;
-        state->capacity_uL[i] = state->bee_capacity_uL;
-        state->harvest_rate_uLps[i] = state->bee_harvest_rate_uLps;
-
-        BeeRole role = (i == 0) ? BEE_ROLE_QUEEN : bee_pick_role(age_days, &rng);
-        state->role[i] = (uint8_t)role;
-
-        state->mode[i] = (uint8_t)BEE_MODE_IDLE;
-        state->intent[i] = (uint8_t)BEE_INTENT_REST;
-        state->color_rgba[i] = bee_color_for(state->role[i], state->mode[i]);
-
-        bool inside = state->hive_enabled &&
-                      x >= state->hive_rect_x &&
-                      x <= state->hive_rect_x + state->hive_rect_w &&
-                      y >= state->hive_rect_y &&
-                      y <= state->hive_rect_y + state->hive_rect_h;
-        state->inside_hive_flag[i] = inside ? 1u : 0u;
-        if (i == 0 && state->hive_enabled) {
-            state->inside_hive_flag[i] = 1u;
-        }
-        if (state->path_valid) {
-            state->path_valid[i] = 0u;
-        }
-        if (state->path_has_waypoint) {
-            state->path_has_waypoint[i] = 0u;
-        }
-        if (state->path_waypoint_x) {
-            state->path_waypoint_x[i] = unload_x;
-        }
-        if (state->path_waypoint_y) {
-            state->path_waypoint_y[i] = unload_y;
-        }
-    }
+    // The scalar stream only keys the chunk streams, so it advances the same
+    // regardless of colony size or thread count.
+    ctx.stream_seed = xorshift64(&rng);
+    size_t chunk_count = (state->count + SIM_FILL_CHUNK - 1u) / SIM_FILL_CHUNK;
+    JobCounter done = {0};
+    jobs_parallel_for(state->jobs, chunk_count, 1, fill_bee_chunks, &ctx, &done);
+    jobs_wait(state->jobs, &done);
 
     state->rng_state = rng;
+    hex_grid_clear(&state->hex);
+    hex_grid_tally(&state->hex, state->hex_tile, state->mode, state->load_nectar, state->count);
+    trips_reset(state);
+    traffic_clear(state);
+    state->hive_nectar_uL = 0.0;
+    for (int m = 0; m < SIM_METRIC_COUNT; ++m) {
+        series_init(&state->metrics[m], SIM_METRIC_PERIOD_SEC);
+    }
     reset_log_stats(state);
-    update_scratch(state);
 }
 
 static void sim_release(SimState *state) {
@@ -339,10 +366,20 @@ static void sim_release(SimState *state) {
     free_aligned(state->path_waypoint_y);
     free_aligned(state->path_has_waypoint);
     free_aligned(state->path_valid);
-    free(state);
+    free_aligned(state->trip_time_sec);
+    free_aligned(state->trip_distance);
+    free_aligned(state->trip_patch);
+    free_aligned(state->hex_tile);
+    hex_grid_shutdown(&state->hex);
+    traffic_release(state);
+    mem_free(ALLOC_TAG_SIM, state);
 }
 
 bool sim_init(SimState **out_state, const Params *params) {
+    return sim_init_with_jobs(out_state, params, NULL);
+}
+
+bool sim_init_with_jobs(SimState **out_state, const Params *params, JobPool *jobs) {
     if (!out_state || *out_state || !params) {
         LOG_ERROR("sim_init: invalid arguments");
         return false;
@@ -353,14 +390,16 @@ bool sim_init(SimState **out_state, const Params *params) {
         return false;
     }
 
-    SimState *state = (SimState *)calloc(1, sizeof(SimState));
+    SimState *state = (SimState *)mem_calloc(ALLOC_TAG_SIM, 1, sizeof(SimState));
     if (!state) {
         LOG_ERROR("sim_init: failed to allocate SimState");
         return false;
     }
 
+    uint64_t init_start_ns = clock_now_ns();
     state->count = params->bee_count;
     state->capacity = params->bee_count;
+    state->jobs = jobs;
     state->seed = params->rng_seed ? params->rng_seed : UINT64_C(0xBEE);
     state->world_w = params->world_width_px > 0.0f ? params->world_width_px
                                                    : (float)params->window_width_px;
@@ -396,6 +435,10 @@ bool sim_init(SimState **out_state, const Params *params) {
     state->path_waypoint_y = (float *)alloc_aligned(sizeof(float) * count);
     state->path_has_waypoint = (uint8_t *)alloc_aligned(sizeof(uint8_t) * count);
     state->path_valid = (uint8_t *)alloc_aligned(sizeof(uint8_t) * count);
+    state->trip_time_sec = (float *)alloc_aligned(sizeof(float) * count);
+    state->trip_distance = (float *)alloc_aligned(sizeof(float) * count);
+    state->trip_patch = (int8_t *)alloc_aligned(sizeof(int8_t) * count);
+    state->hex_tile = (int32_t *)alloc_aligned(sizeof(int32_t) * count);
 
     if (!state->x || !state->y || !state->vx || !state->vy || !state->heading ||
         !state->radius || !state->color_rgba || !state->scratch_xy ||
@@ -404,22 +447,38 @@ bool sim_init(SimState **out_state, const Params *params) {
         !state->topic_id || !state->topic_confidence || !state->role ||
         !state->mode || !state->intent || !state->capacity_uL || !state->harvest_rate_uLps ||
         !state->inside_hive_flag || !state->path_waypoint_x || !state->path_waypoint_y ||
-        !state->path_has_waypoint || !state->path_valid) {
+        !state->path_has_waypoint || !state->path_valid || !state->trip_time_sec ||
+        !state->trip_distance || !state->trip_patch || !state->hex_tile) {
         LOG_ERROR("sim_init: allocation failure for bee buffers");
         sim_release(state);
         return false;
     }
+    if (!hex_grid_init(&state->hex, params->hex.tile_size_px, state->world_w, state->world_h)) {
+        sim_release(state);
+        return false;
+    }
+    if (!traffic_init(state, params->traffic.cell_world, params->traffic.decay_sec)) {
+        sim_release(state);
+        return false;
+    }
 
     fill_bees(state, params, state->seed);
 
     *out_state = state;
-    LOG_INFO("sim: initialized count=%zu capacity=%zu seed=0x%llx dt=%.5f max_speed=%.1f jitter=%.1fdeg/s",
+    LOG_INFO("sim: initialized count=%zu capacity=%zu seed=0x%llx dt=%.5f max_speed=%.1f jitter=%.1fdeg/s "
+             "hex=%dx%d traffic=%dx%d init=%.1fms threads=%d",
              state->count,
              state->capacity,
              (unsigned long long)state->seed,
              params->sim_fixed_dt,
              params->motion_max_speed,
-             params->motion_jitter_deg_per_sec);
+             params->motion_jitter_deg_per_sec,
+             state->hex.cols,
+             state->hex.rows,
+             state->traffic_cols,
+             state->traffic_rows,
+             clock_ns_to_ms(clock_now_ns() - init_start_ns),
+             jobs_thread_count(jobs));
     return true;
 }
 
@@ -431,6 +490,9 @@ void sim_tick(SimState *state, float dt_sec) {
         update_scratch(state);
         return;
     }
+    alloc_tick_begin();
+    TRACE_BEGIN("sim_tick");
+    const uint64_t tick_start_ns = clock_now_ns();
 
     plants_replenish(state, dt_sec);
 
@@ -453,6 +515,18 @@ void sim_tick(SimState *state, float dt_sec) {
     float speed_min_tick = FLT_MAX;
     float speed_max_tick = 0.0f;
     uint64_t bounce_counter = 0;
+    uint32_t foragers_out = 0;
+    double unloaded_tick = 0.0;
+    // Worker-local counters (the bee loop is the only worker today); folded
+    // into state->last_stats once after the loop, so no atomics are needed.
+    SimStats stats = {0};
+    const uint64_t tick = state->tick_index;
+    EventProducer *events = state->event_producer;
+    const uint32_t event_mask = events ? event_stream_mask(state->events) : 0u;
+    uint32_t *traffic = state->traffic_pending;
+    const float traffic_inv_cell = state->traffic_inv_cell;
+    const int traffic_cols = state->traffic_cols;
+    const int traffic_rows = state->traffic_rows;
     bool any_patch_available = false;
     for (size_t pi = 0; pi < state->patch_count; ++pi) {
         if (state->patches[pi].stock > 0.5f) {
@@ -470,10 +544,12 @@ void sim_tick(SimState *state, float dt_sec) {
         float radius = state->radius[i];
         float energy = state->energy[i];
         float load = state->load_nectar[i];
+        const int64_t prev_nectar_fx = hex_nectar_fixed(load);
         uint8_t prev_mode = state->mode[i];
         uint8_t prev_intent = state->intent[i];
         float prev_t_state = state->t_state[i];
-        int32_t target_id = state->target_id[i];
+        const int32_t prev_target_id = state->target_id[i];
+        int32_t target_id = prev_target_id;
         float target_x = state->target_pos_x[i];
         float target_y = state->target_pos_y[i];
         float capacity = state->capacity_uL[i] > 0.0f ? state->capacity_uL[i] : state->bee_capacity_uL;
@@ -541,6 +617,7 @@ void sim_tick(SimState *state, float dt_sec) {
         if (mode == BEE_MODE_OUTBOUND || mode == BEE_MODE_FORAGING) {
             if (target_id < 0 || !plants_get_patch_const(state, target_id)) {
                 target_id = plants_choose_patch(state, x, y, &rng);
+                stats.patch_choices += 1;
                 mode_changed = true;
             }
         }
@@ -597,7 +674,8 @@ void sim_tick(SimState *state, float dt_sec) {
                 float dir_x = 0.0f;
                 float dir_y = 0.0f;
                 BeePathPlan path_plan = {0};
-                bool have_plan = bee_path_plan(state, i, target_x, target_y, current_arrive_tol, &path_plan);
+                bool have_plan = bee_path_plan(state, i, target_x, target_y, current_arrive_tol,
+                                               &path_plan, &stats);
                 if (have_plan && path_plan.valid) {
                     dir_x = path_plan.dir_x;
                     dir_y = path_plan.dir_y;
@@ -689,7 +767,7 @@ void sim_tick(SimState *state, float dt_sec) {
             ++bounce_counter;
         }
 
-        hive_resolve_disc(state, radius, &new_x, &new_y, &vx, &vy);
+        hive_resolve_disc(state, radius, &new_x, &new_y, &vx, &vy, &stats);
 
         float speed_after = sqrtf(vx * vx + vy * vy);
         bool inside_after = state->hive_enabled &&
@@ -718,6 +796,8 @@ void sim_tick(SimState *state, float dt_sec) {
             energy += rest_recovery * dt_sec;
         }
 
+        float harvested = 0.0f;
+        float unloaded = 0.0f;
         if (mode == BEE_MODE_FORAGING) {
             FlowerPatch *patch_mut = plants_get_patch(state, target_id);
             if (patch_mut && patch_mut->stock > 0.0f) {
@@ -729,12 +809,14 @@ void sim_tick(SimState *state, float dt_sec) {
                 if (harvest > 0.0f) {
                     load += harvest;
                     patch_mut->stock -= harvest;
+                    harvested = harvest;
                 }
             }
         } else if (mode == BEE_MODE_UNLOADING) {
             float unload = state->bee_unload_rate_uLps * dt_sec;
             if (unload > load) unload = load;
             load -= unload;
+            unloaded = unload;
         }
 
         if (energy < 0.0f) energy = 0.0f;
@@ -746,6 +828,45 @@ void sim_tick(SimState *state, float dt_sec) {
             target_id = -1;
         }
 
+        if (event_mask != 0u) {
+            BeeEventRecord record = {
+                .tick = tick,
+                .bee = (uint32_t)i,
+                .role = state->role[i],
+                .patch_id = target_id,
+                .x = new_x,
+                .y = new_y,
+            };
+            if ((event_mask & BEE_EVENT_BIT(BEE_EVENT_MODE)) && mode != prev_mode) {
+                record.type = BEE_EVENT_MODE;
+                record.prev = prev_mode;
+                record.next = mode;
+                record.value = prev_t_state + dt_sec;
+                event_producer_push(events, &record);
+            }
+            if ((event_mask & BEE_EVENT_BIT(BEE_EVENT_TARGET)) && target_id != prev_target_id) {
+                record.type = BEE_EVENT_TARGET;
+                record.prev = prev_mode;
+                record.next = mode;
+                record.value = (float)prev_target_id;
+                event_producer_push(events, &record);
+            }
+            if ((event_mask & BEE_EVENT_BIT(BEE_EVENT_HARVEST)) && harvested > 0.0f) {
+                record.type = BEE_EVENT_HARVEST;
+                record.prev = mode;
+                record.next = mode;
+                record.value = harvested;
+                event_producer_push(events, &record);
+            }
+            if ((event_mask & BEE_EVENT_BIT(BEE_EVENT_UNLOAD)) && unloaded > 0.0f) {
+                record.type = BEE_EVENT_UNLOAD;
+                record.prev = mode;
+                record.next = mode;
+                record.value = unloaded;
+                event_producer_push(events, &record);
+            }
+        }
+
         state->x[i] = new_x;
         state->y[i] = new_y;
         state->vx[i] = vx;
@@ -767,6 +888,21 @@ void sim_tick(SimState *state, float dt_sec) {
         state->load_nectar[i] = load;
         state->intent[i] = intent;
         state->mode[i] = mode;
+        int32_t tile = hex_grid_tile_at(&state->hex, new_x, new_y);
+        hex_grid_move_bee(&state->hex, state->hex_tile[i], tile, prev_mode, mode, prev_nectar_fx,
+                          hex_nectar_fixed(load));
+        state->hex_tile[i] = tile;
+        if (traffic) {
+            int cell_x = (int)(new_x * traffic_inv_cell);
+            int cell_y = (int)(new_y * traffic_inv_cell);
+            cell_x = cell_x < 0 ? 0 : (cell_x < traffic_cols ? cell_x : traffic_cols - 1);
+            cell_y = cell_y < 0 ? 0 : (cell_y < traffic_rows ? cell_y : traffic_rows - 1);
+            traffic[(size_t)cell_y * (size_t)traffic_cols + (size_t)cell_x] += 1u;
+        }
+        stats.mode_transitions += (mode != prev_mode) ? 1u : 0u;
+        foragers_out += (mode == BEE_MODE_OUTBOUND || mode == BEE_MODE_FORAGING ||
+                         mode == BEE_MODE_RETURNING) ? 1u : 0u;
+        unloaded_tick += (double)unloaded;
         state->color_rgba[i] = bee_color_for(state->role[i], mode);
         if (state->path_valid) {
             state->path_valid[i] = path_valid;
@@ -784,6 +920,35 @@ void sim_tick(SimState *state, float dt_sec) {
         state->target_pos_y[i] = target_y;
         state->target_id[i] = target_id;
         state->t_state[i] = (mode == prev_mode) ? prev_t_state + dt_sec : 0.0f;
+
+        int8_t trip_patch = state->trip_patch[i];
+        if (trip_patch < 0 && mode == BEE_MODE_OUTBOUND && !inside_after && target_id >= 0) {
+            trip_patch = (int8_t)target_id;
+            state->trip_time_sec[i] = 0.0f;
+            state->trip_distance[i] = 0.0f;
+        }
+        if (trip_patch >= 0) {
+            float step_x = new_x - x;
+            float step_y = new_y - y;
+            float trip_time = state->trip_time_sec[i] + dt_sec;
+            float trip_distance = state->trip_distance[i] + sqrtf(step_x * step_x + step_y * step_y);
+            if (mode == BEE_MODE_FORAGING && target_id >= 0) {
+                trip_patch = (int8_t)target_id;
+            }
+            bool home_leg = (prev_mode == BEE_MODE_RETURNING || prev_mode == BEE_MODE_ENTERING);
+            if (home_leg && (mode == BEE_MODE_UNLOADING || mode == BEE_MODE_IDLE)) {
+                // Bees with nothing to unload go straight to IDLE; both close the
+                // trip. Nectar carried home is what was aboard before this tick's unload.
+                trips_record(state, trip_patch, trip_time, trip_distance, load + unloaded, energy);
+                trip_patch = -1;
+            } else if (mode == BEE_MODE_IDLE) {
+                trips_abandon(state, trip_patch);
+                trip_patch = -1;
+            }
+            state->trip_time_sec[i] = trip_time;
+            state->trip_distance[i] = trip_distance;
+            state->trip_patch[i] = trip_patch;
+        }
         state->age_days[i] += dt_sec / 86400.0f;
         float conf = (float)state->topic_confidence[i];
         conf -= dt_sec * 20.0f;
@@ -793,7 +958,26 @@ void sim_tick(SimState *state, float dt_sec) {
     }
 
     state->rng_state = rng;
+    state->tick_index += 1;
+    stats.tick = state->tick_index;
+    stats.wall_bounces = bounce_counter;
+    state->last_stats = stats;
+    state->sim_time_sec += (double)dt_sec;
     update_scratch(state);
+    if (traffic && state->tick_index - state->traffic_fold_tick >= SIM_TRAFFIC_FOLD_TICKS) {
+        traffic_fold(state, false);
+    }
+
+    state->hive_nectar_uL += unloaded_tick;
+    double patch_stock = 0.0;
+    for (size_t pi = 0; pi < state->patch_count; ++pi) {
+        patch_stock += (double)state->patches[pi].stock;
+    }
+    series_add(&state->metrics[SIM_METRIC_FORAGERS_OUT], (float)foragers_out, dt_sec);
+    series_add(&state->metrics[SIM_METRIC_HIVE_NECTAR], (float)state->hive_nectar_uL, dt_sec);
+    series_add(&state->metrics[SIM_METRIC_PATCH_STOCK], (float)patch_stock, dt_sec);
+    series_add(&state->metrics[SIM_METRIC_TICK_MS],
+               (float)clock_ns_to_ms(clock_now_ns() - tick_start_ns), dt_sec);
 
     state->log_accum_sec += dt_sec;
     state->log_bounce_count += bounce_counter;
@@ -827,6 +1011,16 @@ void sim_tick(SimState *state, float dt_sec) {
                  (unsigned long long)state->log_bounce_count);
         reset_log_stats(state);
     }
+    TRACE_END("sim_tick");
+    alloc_tick_end();
+}
+
+static void push_hive_wall(SimState *state, size_t index, const HiveSegment *seg, uint32_t color) {
+    state->hive_wall_xy[4 * index + 0] = seg->ax;
+    state->hive_wall_xy[4 * index + 1] = seg->ay;
+    state->hive_wall_xy[4 * index + 2] = seg->bx;
+    state->hive_wall_xy[4 * index + 3] = seg->by;
+    state->hive_wall_rgba[index] = color;
 }
 
 RenderView sim_build_view(SimState *state) {
@@ -844,6 +1038,29 @@ RenderView sim_build_view(SimState *state) {
     view.patch_ring_radii_px = state->patch_ring_radii_px;
     view.patch_ring_rgba = state->patch_ring_rgba;
     view.patch_count = state->patch_count;
+    view.hive_walls_xy = state->hive_wall_xy;
+    view.hive_wall_rgba = state->hive_wall_rgba;
+    view.hive_wall_count = 0;
+    view.path_waypoint_x = state->path_waypoint_x;
+    view.path_waypoint_y = state->path_waypoint_y;
+    view.path_target_x = state->target_pos_x;
+    view.path_target_y = state->target_pos_y;
+    view.path_valid = state->path_valid;
+    view.path_has_waypoint = state->path_has_waypoint;
+    view.path_count = state->count;
+
+    if (state->hive_enabled) {
+        const uint32_t wall_color = make_color(0.95f, 0.75f, 0.15f, 0.9f);
+        const uint32_t gap_color = make_color(0.2f, 0.85f, 0.35f, 0.9f);
+        size_t walls = 0;
+        for (size_t i = 0; i < state->hive_segment_count; ++i) {
+            push_hive_wall(state, walls++, &state->hive_segments[i], wall_color);
+        }
+        if (state->hive_entrance_valid) {
+            push_hive_wall(state, walls++, &state->hive_entrance, gap_color);
+        }
+        view.hive_wall_count = walls;
+    }
 
     for (size_t i = 0; i < state->patch_count && i < SIM_MAX_FLOWER_PATCHES; ++i) {
         const FlowerPatch *patch = &state->patches[i];
@@ -1000,7 +1217,10 @@ void sim_apply_runtime_params(SimState *state, const Params *params) {
 
         state->x[i] = x;
         state->y[i] = y;
+        state->hex_tile[i] = hex_grid_tile_at(&state->hex, x, y);
     }
+    // Clamping may move bees across tiles; a recount is cheaper than tracking it.
+    hex_grid_tally(&state->hex, state->hex_tile, state->mode, state->load_nectar, state->count);
 
     update_scratch(state);
     reset_log_stats(state);
@@ -1041,6 +1261,110 @@ size_t sim_find_bee_near(const SimState *state, float world_x, float world_y, fl
     return best_index;
 }
 
+void sim_memory_report(const SimState *state, MemReport *report) {
+    if (!state || !report) {
+        return;
+    }
+    report->bee_count = state->capacity;
+    for (size_t c = 0; c < SIM_COLUMN_COUNT; ++c) {
+        mem_report_add(report, "sim", g_sim_columns[c].name,
+                       (uint64_t)g_sim_columns[c].elem_size * state->capacity,
+                       MEM_REGION_CPU, true);
+    }
+    mem_report_add(report, "sim", "scratch_xy",
+                   (uint64_t)sizeof(float) * 2u * state->capacity, MEM_REGION_CPU, true);
+    mem_report_add(report, "sim", "hex_tile",
+                   (uint64_t)sizeof(int32_t) * state->capacity, MEM_REGION_CPU, true);
+    mem_report_add(report, "sim", "hex_tiles",
+                   (uint64_t)sizeof(HexTile) * state->hex.tile_count, MEM_REGION_CPU, false);
+    if (state->traffic_pending) {
+        mem_report_add(report, "sim", "traffic", traffic_memory_bytes(state), MEM_REGION_CPU, false);
+    }
+
+    uint64_t patch_bytes = sizeof(state->patches) + sizeof(state->patch_positions_xy) +
+                           sizeof(state->patch_radii_px) + sizeof(state->patch_fill_rgba) +
+                           sizeof(state->patch_ring_radii_px) + sizeof(state->patch_ring_rgba);
+    mem_report_add(report, "sim", "patches", patch_bytes, MEM_REGION_CPU, false);
+    mem_report_add(report, "sim", "trip_sketches", sizeof(state->trip_stats), MEM_REGION_CPU, false);
+    mem_report_add(report, "sim", "metric_series", sizeof(state->metrics), MEM_REGION_CPU, false);
+    mem_report_add(report, "sim", "state",
+                   sizeof(SimState) - patch_bytes - sizeof(state->trip_stats) - sizeof(state->metrics),
+                   MEM_REGION_CPU, false);
+}
+
+const HexGrid *sim_hex_grid(const SimState *state) {
+    return state ? &state->hex : NULL;
+}
+
+const char *sim_metric_name(SimMetric metric) {
+    switch (metric) {
+        case SIM_METRIC_FORAGERS_OUT: return "FORAGERS OUT";
+        case SIM_METRIC_HIVE_NECTAR: return "HIVE NECTAR (UL)";
+        case SIM_METRIC_PATCH_STOCK: return "PATCH STOCK (UL)";
+        case SIM_METRIC_TICK_MS: return "TICK (MS)";
+        default: return "UNKNOWN";
+    }
+}
+
+const TimeSeries *sim_metric_series(const SimState *state, SimMetric metric) {
+    if (!state || (int)metric < 0 || metric >= SIM_METRIC_COUNT) {
+        return NULL;
+    }
+    return &state->metrics[metric];
+}
+
+uint64_t sim_tick_index(const SimState *state) {
+    return state ? state->tick_index : 0;
+}
+
+uint64_t sim_seed(const SimState *state) {
+    return state ? state->seed : 0;
+}
+
+bool sim_get_stats(const SimState *state, SimStats *out_stats) {
+    if (!state || !out_stats) {
+        return false;
+    }
+    *out_stats = state->last_stats;
+    return true;
+}
+
+size_t sim_patch_count(const SimState *state) {
+    return state ? state->patch_count : 0;
+}
+
+static SimQuantiles sim_sketch_quantiles(const DDSketch *sketch) {
+    SimQuantiles q;
+    q.p50 = (float)ddsketch_quantile(sketch, 0.50);
+    q.p90 = (float)ddsketch_quantile(sketch, 0.90);
+    q.p99 = (float)ddsketch_quantile(sketch, 0.99);
+    q.mean = (float)ddsketch_mean(sketch);
+    q.max = sketch->count > 0 ? (float)sketch->max : 0.0f;
+    return q;
+}
+
+bool sim_get_trip_summary(const SimState *state, size_t patch_index, SimTripSummary *out_summary) {
+    if (!state || !out_summary || patch_index >= state->patch_count) {
+        return false;
+    }
+    const TripPatchStats *stats = &state->trip_stats[patch_index];
+    out_summary->trips = stats->duration_sec.count;
+    out_summary->abandoned = stats->abandoned;
+    out_summary->duration_sec = sim_sketch_quantiles(&stats->duration_sec);
+    out_summary->distance_world = sim_sketch_quantiles(&stats->distance_world);
+    out_summary->nectar_uL = sim_sketch_quantiles(&stats->nectar_uL);
+    out_summary->energy = sim_sketch_quantiles(&stats->energy);
+    return true;
+}
+
+void sim_set_event_stream(SimState *state, EventStream *stream) {
+    if (!state) {
+        return;
+    }
+    state->events = stream;
+    state->event_producer = event_stream_producer(stream, 0);
+}
+
 bool sim_get_bee_info(const SimState *state, size_t index, BeeDebugInfo *out_info) {
     if (!state || !out_info || index >= state->count) {
         return false;
@@ -0,0 +1,36 @@
+#include "sim_internal.h"
+
+#define SIM_COLUMN(field, dtype) \
+    {#field, offsetof(SimState, field), sizeof(*((SimState *)0)->field), dtype}
+
+const SimColumn g_sim_columns[] = {
+    SIM_COLUMN(x, "<f4"),
+    SIM_COLUMN(y, "<f4"),
+    SIM_COLUMN(vx, "<f4"),
+    SIM_COLUMN(vy, "<f4"),
+    SIM_COLUMN(heading, "<f4"),
+    SIM_COLUMN(radius, "<f4"),
+    SIM_COLUMN(color_rgba, "<u4"),
+    SIM_COLUMN(age_days, "<f4"),
+    SIM_COLUMN(t_state, "<f4"),
+    SIM_COLUMN(energy, "<f4"),
+    SIM_COLUMN(load_nectar, "<f4"),
+    SIM_COLUMN(target_pos_x, "<f4"),
+    SIM_COLUMN(target_pos_y, "<f4"),
+    SIM_COLUMN(target_id, "<i4"),
+    SIM_COLUMN(topic_id, "<i2"),
+    SIM_COLUMN(topic_confidence, "|u1"),
+    SIM_COLUMN(role, "|u1"),
+    SIM_COLUMN(mode, "|u1"),
+    SIM_COLUMN(intent, "|u1"),
+    SIM_COLUMN(capacity_uL, "<f4"),
+    SIM_COLUMN(harvest_rate_uLps, "<f4"),
+    SIM_COLUMN(inside_hive_flag, "|u1"),
+    SIM_COLUMN(path_waypoint_x, "<f4"),
+    SIM_COLUMN(path_waypoint_y, "<f4"),
+    SIM_COLUMN(path_has_waypoint, "|u1"),
+    SIM_COLUMN(path_valid, "|u1"),
+    SIM_COLUMN(trip_time_sec, "<f4"),
+    SIM_COLUMN(trip_distance, "<f4"),
+    SIM_COLUMN(trip_patch, "|i1"),
+};
@@ -6,12 +6,19 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "event_stream.h"
+#include "hex.h"
+#include "sim.h"
+#include "snapshot.h"
+#include "util/ddsketch.h"
+
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
 #define TWO_PI (2.0f * (float)M_PI)
 #define SIM_MAX_FLOWER_PATCHES 8
+#define SIM_MAX_HIVE_SEGMENTS 8
 
 typedef struct HiveSegment {
     float ax;
@@ -33,6 +40,14 @@ typedef struct FlowerPatch {
     float initial_stock;
 } FlowerPatch;
 
+typedef struct TripPatchStats {
+    DDSketch duration_sec;
+    DDSketch distance_world;
+    DDSketch nectar_uL;
+    DDSketch energy;
+    uint64_t abandoned;  // trips that ended without returning to unload
+} TripPatchStats;
+
 typedef struct SimState {
     size_t count;
     size_t capacity;
@@ -75,7 +90,18 @@ typedef struct SimState {
     float *path_waypoint_y;
     uint8_t *path_has_waypoint;
     uint8_t *path_valid;
+    float *trip_time_sec;
+    float *trip_distance;
+    int8_t *trip_patch;  // patch of the open trip, -1 when no trip is open
+    int32_t *hex_tile;   // derived: tile of (x, y) as counted in hex
+    HexGrid hex;
     uint64_t rng_state;
+    uint64_t tick_index;
+    double sim_time_sec;
+    JobPool *jobs;  // borrowed; used by fill_bees and traffic_fold
+    EventStream *events;
+    EventProducer *event_producer;
+    SimStats last_stats;
     double log_accum_sec;
     uint64_t log_bounce_count;
     uint64_t log_sample_count;
@@ -95,8 +121,10 @@ typedef struct SimState {
     float hive_tangent_damp;
     int hive_max_iters;
     float hive_safety_margin;
-    HiveSegment hive_segments[8];
+    HiveSegment hive_segments[SIM_MAX_HIVE_SEGMENTS];
     size_t hive_segment_count;
+    HiveSegment hive_entrance;  // gap in the entrance wall; drawn, never collided
+    int hive_entrance_valid;
 
     size_t patch_count;
     FlowerPatch patches[SIM_MAX_FLOWER_PATCHES];
@@ -112,8 +140,97 @@ typedef struct SimState {
     uint32_t patch_fill_rgba[SIM_MAX_FLOWER_PATCHES];
     float patch_ring_radii_px[SIM_MAX_FLOWER_PATCHES];
     uint32_t patch_ring_rgba[SIM_MAX_FLOWER_PATCHES];
+    float hive_wall_xy[(SIM_MAX_HIVE_SEGMENTS + 1) * 4];  // walls plus the entrance
+    uint32_t hive_wall_rgba[SIM_MAX_HIVE_SEGMENTS + 1];
+    TripPatchStats trip_stats[SIM_MAX_FLOWER_PATCHES];
+    double hive_nectar_uL;  // unloaded since reset; feeds SIM_METRIC_HIVE_NECTAR
+    TimeSeries metrics[SIM_METRIC_COUNT];
+
+    // Traffic heatmap (traffic.c); all grids are traffic_cols * traffic_rows.
+    float traffic_cell;            // world units per cell; 0 when disabled (grids null)
+    float traffic_inv_cell;
+    float traffic_decay_sec;       // 0 = the decayed grid never decays
+    int traffic_cols;
+    int traffic_rows;
+    uint32_t *traffic_pending;     // visits since the last fold; one add per bee per tick
+    uint64_t *traffic_total;       // cumulative visits since reset
+    float *traffic_recent;         // exponentially decayed visits
+    uint8_t *traffic_intensity;    // traffic_recent log-scaled to 0-255 for the view
+    float *traffic_chunk_max;      // per fold chunk, reduced into traffic_max
+    float traffic_max;             // largest traffic_recent at the last fold
+    uint64_t traffic_fold_tick;    // tick_index at the last fold
+    uint64_t traffic_view_tick;    // tick_index traffic_intensity reflects
+    double traffic_fold_time_sec;  // sim_time_sec at the last fold
+    uint64_t traffic_version;      // bumped whenever traffic_intensity changes
 } SimState;
 
+// Per-bee SoA arrays that persist across ticks (scratch_xy and hex_tile are
+// derived and excluded). Shared by the snapshot writer and the memory report.
+#define SIM_COLUMN_COUNT 29
+
+typedef struct SimColumn {
+    const char *name;
+    size_t field_offset;  // offsetof the array pointer inside SimState
+    size_t elem_size;
+    const char *dtype;    // numpy type string
+} SimColumn;
+
+extern const SimColumn g_sim_columns[SIM_COLUMN_COUNT];
+
+static inline const void *sim_column_data(const SimState *state, const SimColumn *column) {
+    const void *const *field = (const void *const *)((const char *)state + column->field_offset);
+    return *field;
+}
+
+#define SIM_SNAPSHOT_PATH_CAP 1024
+#define SIM_SNAPSHOT_SCHEMA_CAP 8192u
+
+// Everything in a .beesnap besides the column data itself, formatted ahead
+// of the write so the write can run where snprintf is off limits.
+typedef struct SimSnapshotLayout {
+    BeeSnapshotPreamble preamble;
+    char schema[SIM_SNAPSHOT_SCHEMA_CAP];  // JSON, space-padded to schema_bytes
+    size_t schema_bytes;
+    uint64_t offsets[SIM_COLUMN_COUNT];
+    uint64_t file_bytes;
+} SimSnapshotLayout;
+
+bool sim_snapshot_layout(const SimState *state, SimSnapshotLayout *out);
+// Formats the preamble, schema and column offsets for the current state.
+// False when the schema does not fit. Does not log or allocate.
+
+bool sim_snapshot_write_layout(const SimState *state, const SimSnapshotLayout *layout, const char *path);
+// Writes the preamble, schema and columns with open/writev/close only, so it
+// is async-signal-safe and can run in a forked child. layout must come from
+// sim_snapshot_layout on the same state.
+
+bool sim_snapshot_format_path(const SimState *state, const char *path_prefix, char *buf, size_t cap);
+// Formats "<path_prefix>_<tick>.beesnap"; false when it does not fit.
+
+// Folds run at least this often so traffic_pending (uint32) cannot overflow
+// for any colony up to PARAMS_MAX_BEE_COUNT, even in headless runs that never
+// build a view.
+#define SIM_TRAFFIC_FOLD_TICKS 256u
+#define SIM_TRAFFIC_MAX_CELLS (1u << 22)
+
+bool traffic_init(SimState *state, float cell_world, float decay_sec);
+// Sizes the grids to cover the world (ALLOC_TAG_SIM). cell_world 0 leaves
+// the heatmap disabled; the cell grows when the grid would exceed
+// SIM_TRAFFIC_MAX_CELLS. False (logged) on allocation failure.
+
+void traffic_clear(SimState *state);
+// Zeroes every grid (sim_reset).
+
+void traffic_fold(SimState *state, bool normalize);
+// Adds traffic_pending into traffic_total, decays traffic_recent by the sim
+// time since the last fold before adding it there too, and clears pending;
+// with normalize also rewrites traffic_intensity. Runs in fixed chunks on
+// state->jobs and never allocates.
+
+void traffic_release(SimState *state);
+
+uint64_t traffic_memory_bytes(const SimState *state);
+
 static inline float clampf(float v, float lo, float hi) {
     if (v < lo) {
         return lo;
@@ -0,0 +1,176 @@
+#include "sim.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "snapshot.h"
+#include "util/clock.h"
+#include "util/file_io.h"
+#include "util/log.h"
+
+#include "sim_internal.h"
+
+static const uint8_t k_snapshot_zero_pad[BEE_SNAPSHOT_ALIGN] = {0};
+
+static uint64_t snapshot_align(uint64_t value) {
+    return (value + (BEE_SNAPSHOT_ALIGN - 1u)) & ~(uint64_t)(BEE_SNAPSHOT_ALIGN - 1u);
+}
+
+static int snapshot_format_schema(char *buf,
+                                  size_t cap,
+                                  const SimState *state,
+                                  const uint64_t *offsets) {
+    size_t used = 0;
+    int n = snprintf(buf, cap,
+                     "{\"format\":\"beesnap\",\"version\":%u,\"bee_count\":%zu,"
+                     "\"tick\":%" PRIu64 ",\"sim_time_sec\":%.6f,\"seed\":%" PRIu64 ","
+                     "\"rng_state\":%" PRIu64 ",\"world\":[%.3f,%.3f],\"patch_stock\":[",
+                     BEE_SNAPSHOT_VERSION, state->count, state->tick_index,
+                     state->sim_time_sec, state->seed, state->rng_state,
+                     (double)state->world_w, (double)state->world_h);
+    if (n < 0 || (size_t)n >= cap) {
+        return -1;
+    }
+    used = (size_t)n;
+    for (size_t p = 0; p < state->patch_count; ++p) {
+        n = snprintf(buf + used, cap - used, "%s%.6g", p > 0 ? "," : "",
+                     (double)state->patches[p].stock);
+        if (n < 0 || (size_t)n >= cap - used) {
+            return -1;
+        }
+        used += (size_t)n;
+    }
+    n = snprintf(buf + used, cap - used, "],\"columns\":[");
+    if (n < 0 || (size_t)n >= cap - used) {
+        return -1;
+    }
+    used += (size_t)n;
+    for (size_t c = 0; c < SIM_COLUMN_COUNT; ++c) {
+        const SimColumn *column = &g_sim_columns[c];
+        n = snprintf(buf + used, cap - used,
+                     "%s{\"name\":\"%s\",\"dtype\":\"%s\",\"offset\":%" PRIu64 ",\"bytes\":%zu}",
+                     c > 0 ? "," : "", column->name, column->dtype, offsets[c],
+                     column->elem_size * state->count);
+        if (n < 0 || (size_t)n >= cap - used) {
+            return -1;
+        }
+        used += (size_t)n;
+    }
+    n = snprintf(buf + used, cap - used, "]}\n");
+    if (n < 0 || (size_t)n >= cap - used) {
+        return -1;
+    }
+    return (int)(used + (size_t)n);
+}
+
+bool sim_snapshot_layout(const SimState *state, SimSnapshotLayout *out) {
+    char *schema = out->schema;
+    uint64_t *offsets = out->offsets;
+    uint64_t file_bytes = 0;
+    size_t schema_bytes = 0;
+    int schema_len = -1;
+
+    // Offsets depend on the schema length and vice versa; this settles after
+    // at most a couple of passes since padding absorbs small digit changes.
+    for (int pass = 0; pass < 4; ++pass) {
+        uint64_t cursor = sizeof(BeeSnapshotPreamble) + schema_bytes;
+        for (size_t c = 0; c < SIM_COLUMN_COUNT; ++c) {
+            offsets[c] = cursor;
+            cursor = snapshot_align(cursor + g_sim_columns[c].elem_size * state->count);
+        }
+        file_bytes = cursor;
+        schema_len = snapshot_format_schema(schema, sizeof(out->schema), state, offsets);
+        if (schema_len < 0) {
+            return false;
+        }
+        size_t padded = (size_t)snapshot_align((uint64_t)schema_len);
+        if (padded == schema_bytes) {
+            break;
+        }
+        schema_bytes = padded;
+    }
+    if (schema_bytes != (size_t)snapshot_align((uint64_t)schema_len) ||
+        schema_bytes > sizeof(out->schema)) {
+        return false;
+    }
+    memset(schema + schema_len, ' ', schema_bytes - (size_t)schema_len);
+    out->schema_bytes = schema_bytes;
+    out->file_bytes = file_bytes;
+
+    BeeSnapshotPreamble *preamble = &out->preamble;
+    memset(preamble, 0, sizeof(*preamble));
+    memcpy(preamble->magic, BEE_SNAPSHOT_MAGIC, sizeof(BEE_SNAPSHOT_MAGIC));
+    preamble->version = BEE_SNAPSHOT_VERSION;
+    preamble->schema_bytes = (uint32_t)schema_bytes;
+    preamble->bee_count = state->count;
+    preamble->tick = state->tick_index;
+    preamble->seed = state->seed;
+    preamble->sim_time_sec = state->sim_time_sec;
+    preamble->world_w = state->world_w;
+    preamble->world_h = state->world_h;
+    preamble->column_count = (uint32_t)SIM_COLUMN_COUNT;
+    return true;
+}
+
+bool sim_snapshot_write_layout(const SimState *state, const SimSnapshotLayout *layout, const char *path) {
+    FileSlice slices[2 + SIM_COLUMN_COUNT * 2];
+    size_t slice_count = 0;
+    slices[slice_count++] = (FileSlice){&layout->preamble, sizeof(layout->preamble)};
+    slices[slice_count++] = (FileSlice){layout->schema, layout->schema_bytes};
+    for (size_t c = 0; c < SIM_COLUMN_COUNT; ++c) {
+        size_t bytes = g_sim_columns[c].elem_size * state->count;
+        uint64_t end = layout->offsets[c] + bytes;
+        uint64_t next = (c + 1 < SIM_COLUMN_COUNT) ? layout->offsets[c + 1] : layout->file_bytes;
+        slices[slice_count++] = (FileSlice){sim_column_data(state, &g_sim_columns[c]), bytes};
+        if (next > end) {
+            slices[slice_count++] = (FileSlice){k_snapshot_zero_pad, (size_t)(next - end)};
+        }
+    }
+    return file_write_slices(path, slices, slice_count);
+}
+
+bool sim_write_tick_snapshot(const SimState *state, const char *path_prefix) {
+    if (!state || !path_prefix || !path_prefix[0]) {
+        LOG_ERROR("snapshot: invalid arguments");
+        return false;
+    }
+    char path[SIM_SNAPSHOT_PATH_CAP];
+    if (!sim_snapshot_format_path(state, path_prefix, path, sizeof path)) {
+        LOG_ERROR("snapshot: path prefix too long");
+        return false;
+    }
+    return sim_write_snapshot(state, path);
+}
+
+bool sim_snapshot_format_path(const SimState *state, const char *path_prefix, char *buf, size_t cap) {
+    int n = snprintf(buf, cap, "%s_%08llu.beesnap",
+                     path_prefix, (unsigned long long)state->tick_index);
+    return n >= 0 && (size_t)n < cap;
+}
+
+bool sim_write_snapshot(const SimState *state, const char *path) {
+    if (!state || !path || !path[0]) {
+        LOG_ERROR("snapshot: invalid arguments");
+        return false;
+    }
+    uint64_t start_ns = clock_now_ns();
+    SimSnapshotLayout layout;
+    if (!sim_snapshot_layout(state, &layout)) {
+        LOG_ERROR("snapshot: schema for '%s' exceeds %u bytes", path, SIM_SNAPSHOT_SCHEMA_CAP);
+        return false;
+    }
+    if (!sim_snapshot_write_layout(state, &layout, path)) {
+        LOG_ERROR("snapshot: failed to write '%s'", path);
+        return false;
+    }
+    uint64_t bytes = layout.file_bytes;
+    double elapsed_ms = clock_ns_to_ms(clock_now_ns() - start_ns);
+    LOG_INFO("snapshot: wrote '%s' tick=%llu bees=%zu bytes=%llu in %.2fms",
+             path,
+             (unsigned long long)state->tick_index,
+             state->count,
+             (unsigned long long)bytes,
+             elapsed_ms);
+    return true;
+}
@@ -0,0 +1,266 @@
+#include "sim.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "traffic.h"
+#include "util/alloc.h"
+#include "util/clock.h"
+#include "util/file_io.h"
+#include "util/image_write.h"
+#include "util/log.h"
+
+#include "sim_internal.h"
+
+#define TRAFFIC_FOLD_CHUNK 16384
+// Decayed cells below this are flushed to zero: they would draw as nothing,
+// and letting them sink into denormals makes every later fold slow.
+#define TRAFFIC_RECENT_FLOOR 1e-3f
+
+typedef struct TrafficFoldJob {
+    SimState *state;
+    float decay;
+    float scale;  // 255 / log1p(previous max); 0 until a visit was folded
+    bool normalize;
+} TrafficFoldJob;
+
+static size_t traffic_cell_count(const SimState *state) {
+    return (size_t)state->traffic_cols * (size_t)state->traffic_rows;
+}
+
+static size_t traffic_chunk_count(const SimState *state) {
+    return (traffic_cell_count(state) + TRAFFIC_FOLD_CHUNK - 1u) / TRAFFIC_FOLD_CHUNK;
+}
+
+bool traffic_init(SimState *state, float cell_world, float decay_sec) {
+    if (!state || cell_world <= 0.0f) {
+        return true;
+    }
+    double cols = ceil((double)state->world_w / (double)cell_world);
+    double rows = ceil((double)state->world_h / (double)cell_world);
+    if (cols * rows > (double)SIM_TRAFFIC_MAX_CELLS) {
+        float fitted = (float)sqrt((double)state->world_w * (double)state->world_h / (double)SIM_TRAFFIC_MAX_CELLS);
+        LOG_WARN("traffic: cell %.2f needs %.0f cells; using %.2f", cell_world, cols * rows, fitted * 1.01f);
+        cell_world = fitted * 1.01f;
+        cols = ceil((double)state->world_w / (double)cell_world);
+        rows = ceil((double)state->world_h / (double)cell_world);
+    }
+    state->traffic_cell = cell_world;
+    state->traffic_inv_cell = 1.0f / cell_world;
+    state->traffic_decay_sec = decay_sec > 0.0f ? decay_sec : 0.0f;
+    state->traffic_cols = cols > 1.0 ? (int)cols : 1;
+    state->traffic_rows = rows > 1.0 ? (int)rows : 1;
+
+    size_t cells = traffic_cell_count(state);
+    state->traffic_pending = (uint32_t *)mem_calloc(ALLOC_TAG_SIM, cells, sizeof(uint32_t));
+    state->traffic_total = (uint64_t *)mem_calloc(ALLOC_TAG_SIM, cells, sizeof(uint64_t));
+    state->traffic_recent = (float *)mem_calloc(ALLOC_TAG_SIM, cells, sizeof(float));
+    state->traffic_intensity = (uint8_t *)mem_calloc(ALLOC_TAG_SIM, cells, sizeof(uint8_t));
+    state->traffic_chunk_max = (float *)mem_calloc(ALLOC_TAG_SIM, traffic_chunk_count(state), sizeof(float));
+    if (!state->traffic_pending || !state->traffic_total || !state->traffic_recent ||
+        !state->traffic_intensity || !state->traffic_chunk_max) {
+        LOG_ERROR("traffic: failed to allocate a %dx%d grid", state->traffic_cols, state->traffic_rows);
+        traffic_release(state);
+        return false;
+    }
+    return true;
+}
+
+void traffic_clear(SimState *state) {
+    if (!state || !state->traffic_pending) {
+        return;
+    }
+    size_t cells = traffic_cell_count(state);
+    memset(state->traffic_pending, 0, cells * sizeof(uint32_t));
+    memset(state->traffic_total, 0, cells * sizeof(uint64_t));
+    memset(state->traffic_recent, 0, cells * sizeof(float));
+    memset(state->traffic_intensity, 0, cells * sizeof(uint8_t));
+    state->traffic_max = 0.0f;
+    state->traffic_fold_tick = state->tick_index;
+    state->traffic_view_tick = state->tick_index;
+    state->traffic_fold_time_sec = state->sim_time_sec;
+    state->traffic_version += 1;
+}
+
+// Folds cells [chunk * TRAFFIC_FOLD_CHUNK, ...) for each chunk in
+// [chunk_begin, chunk_end). Chunks own disjoint cells and their own max slot.
+static void traffic_fold_chunks(void *user, size_t chunk_begin, size_t chunk_end) {
+    const TrafficFoldJob *job = (const TrafficFoldJob *)user;
+    SimState *state = job->state;
+    const size_t cells = traffic_cell_count(state);
+    uint32_t *restrict pending = state->traffic_pending;
+    uint64_t *restrict total = state->traffic_total;
+    float *restrict recent = state->traffic_recent;
+    uint8_t *restrict intensity = state->traffic_intensity;
+    for (size_t chunk = chunk_begin; chunk < chunk_end; ++chunk) {
+        size_t begin = chunk * TRAFFIC_FOLD_CHUNK;
+        size_t end = begin + TRAFFIC_FOLD_CHUNK < cells ? begin + TRAFFIC_FOLD_CHUNK : cells;
+        float chunk_max = 0.0f;
+        for (size_t c = begin; c < end; ++c) {
+            uint32_t visits = pending[c];
+            float value = recent[c] * job->decay + (float)visits;
+            value = value < TRAFFIC_RECENT_FLOOR ? 0.0f : value;
+            total[c] += visits;
+            pending[c] = 0u;
+            recent[c] = value;
+            chunk_max = value > chunk_max ? value : chunk_max;
+        }
+        if (job->normalize) {
+            for (size_t c = begin; c < end; ++c) {
+                float level = recent[c] > 0.0f ? log1pf(recent[c]) * job->scale : 0.0f;
+                intensity[c] = (uint8_t)(level < 255.0f ? level + 0.5f : 255.0f);
+            }
+        }
+        state->traffic_chunk_max[chunk] = chunk_max;
+    }
+}
+
+void traffic_fold(SimState *state, bool normalize) {
+    if (!state || !state->traffic_pending) {
+        return;
+    }
+    double elapsed = state->sim_time_sec - state->traffic_fold_time_sec;
+    TrafficFoldJob job;
+    job.state = state;
+    job.decay = state->traffic_decay_sec > 0.0f ? (float)exp(-elapsed / (double)state->traffic_decay_sec) : 1.0f;
+    // Scaling by the previous fold's max keeps this a single pass; the map is
+    // at most one fold behind, and cells that outgrew it clamp to 255.
+    job.scale = state->traffic_max > 0.0f ? 255.0f / log1pf(state->traffic_max) : 0.0f;
+    job.normalize = normalize;
+
+    size_t chunk_count = traffic_chunk_count(state);
+    JobCounter done = {0};
+    jobs_parallel_for(state->jobs, chunk_count, 1, traffic_fold_chunks, &job, &done);
+    jobs_wait(state->jobs, &done);
+
+    float max_value = 0.0f;
+    for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+        if (state->traffic_chunk_max[chunk] > max_value) {
+            max_value = state->traffic_chunk_max[chunk];
+        }
+    }
+    state->traffic_max = max_value;
+    state->traffic_fold_tick = state->tick_index;
+    state->traffic_fold_time_sec = state->sim_time_sec;
+    if (normalize) {
+        state->traffic_view_tick = state->tick_index;
+        state->traffic_version += 1;
+    }
+}
+
+void traffic_release(SimState *state) {
+    if (!state) {
+        return;
+    }
+    mem_free(ALLOC_TAG_SIM, state->traffic_pending);
+    mem_free(ALLOC_TAG_SIM, state->traffic_total);
+    mem_free(ALLOC_TAG_SIM, state->traffic_recent);
+    mem_free(ALLOC_TAG_SIM, state->traffic_intensity);
+    mem_free(ALLOC_TAG_SIM, state->traffic_chunk_max);
+    state->traffic_pending = NULL;
+    state->traffic_total = NULL;
+    state->traffic_recent = NULL;
+    state->traffic_intensity = NULL;
+    state->traffic_chunk_max = NULL;
+    state->traffic_cell = 0.0f;
+}
+
+uint64_t traffic_memory_bytes(const SimState *state) {
+    if (!state || !state->traffic_pending) {
+        return 0;
+    }
+    return (uint64_t)traffic_cell_count(state) *
+               (sizeof(uint32_t) + sizeof(uint64_t) + sizeof(float) + sizeof(uint8_t)) +
+           (uint64_t)traffic_chunk_count(state) * sizeof(float);
+}
+
+void sim_traffic_view(SimState *state, RenderView *view) {
+    if (!state || !view || !state->traffic_intensity) {
+        return;
+    }
+    if (state->traffic_view_tick != state->tick_index) {
+        traffic_fold(state, true);
+    }
+    view->traffic_intensity = state->traffic_intensity;
+    view->traffic_cols = state->traffic_cols;
+    view->traffic_rows = state->traffic_rows;
+    view->traffic_cell_world = state->traffic_cell;
+    view->traffic_version = state->traffic_version;
+}
+
+static bool traffic_write_png(const SimState *state, const char *path) {
+    size_t cells = traffic_cell_count(state);
+    uint8_t *rgba = (uint8_t *)mem_alloc(ALLOC_TAG_IO, cells * 4u);
+    if (!rgba) {
+        LOG_ERROR("traffic: failed to allocate a %dx%d image", state->traffic_cols, state->traffic_rows);
+        return false;
+    }
+    uint64_t max_visits = 0;
+    for (size_t c = 0; c < cells; ++c) {
+        max_visits = state->traffic_total[c] > max_visits ? state->traffic_total[c] : max_visits;
+    }
+    double scale = max_visits > 0 ? 255.0 / log1p((double)max_visits) : 0.0;
+    for (size_t c = 0; c < cells; ++c) {
+        uint8_t level = (uint8_t)(log1p((double)state->traffic_total[c]) * scale + 0.5);
+        rgba[4 * c + 0] = level;
+        rgba[4 * c + 1] = level;
+        rgba[4 * c + 2] = level;
+        rgba[4 * c + 3] = 255u;
+    }
+    bool ok = image_write_png(path, rgba, state->traffic_cols, state->traffic_rows);
+    mem_free(ALLOC_TAG_IO, rgba);
+    return ok;
+}
+
+static bool traffic_format_path(const SimState *state, const char *path_prefix, const char *extension,
+                                char *buf, size_t cap) {
+    int n = snprintf(buf, cap, "%s_%08llu.%s", path_prefix, (unsigned long long)state->tick_index, extension);
+    return n >= 0 && (size_t)n < cap;
+}
+
+bool sim_write_traffic(SimState *state, const char *path_prefix) {
+    if (!state || !path_prefix || !path_prefix[0]) {
+        LOG_ERROR("traffic: invalid arguments");
+        return false;
+    }
+    if (!state->traffic_total) {
+        LOG_WARN("traffic: heatmap disabled (cell size 0); nothing to export");
+        return false;
+    }
+    char path[SIM_SNAPSHOT_PATH_CAP];
+    char png_path[SIM_SNAPSHOT_PATH_CAP];
+    if (!traffic_format_path(state, path_prefix, "beetraffic", path, sizeof path) ||
+        !traffic_format_path(state, path_prefix, "png", png_path, sizeof png_path)) {
+        LOG_ERROR("traffic: path prefix too long");
+        return false;
+    }
+    uint64_t start_ns = clock_now_ns();
+    traffic_fold(state, false);
+
+    BeeTrafficPreamble preamble;
+    memset(&preamble, 0, sizeof(preamble));
+    memcpy(preamble.magic, BEE_TRAFFIC_MAGIC, sizeof(BEE_TRAFFIC_MAGIC));
+    preamble.version = BEE_TRAFFIC_VERSION;
+    preamble.cols = (uint32_t)state->traffic_cols;
+    preamble.rows = (uint32_t)state->traffic_rows;
+    preamble.cell_world = state->traffic_cell;
+    preamble.tick = state->tick_index;
+    preamble.seed = state->seed;
+    preamble.sim_time_sec = state->sim_time_sec;
+    preamble.bee_count = (uint64_t)state->count;
+    preamble.world_w = state->world_w;
+    preamble.world_h = state->world_h;
+    FileSlice slices[2] = {
+        {&preamble, sizeof(preamble)},
+        {state->traffic_total, traffic_cell_count(state) * sizeof(uint64_t)},
+    };
+    if (!file_write_slices(path, slices, 2)) {
+        LOG_ERROR("traffic: failed to write %s", path);
+        return false;
+    }
+    bool ok = traffic_write_png(state, png_path);
+    LOG_INFO("traffic: wrote %s (%dx%d cells of %.2f) and its PNG in %.1fms", path, state->traffic_cols,
+             state->traffic_rows, state->traffic_cell, clock_ns_to_ms(clock_now_ns() - start_ns));
+    return ok;
+}
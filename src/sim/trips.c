@@ -0,0 +1,46 @@
+#include "trips.h"
+
+#include <string.h>
+
+void trips_reset(SimState *state) {
+    if (!state) {
+        return;
+    }
+    for (size_t p = 0; p < SIM_MAX_FLOWER_PATCHES; ++p) {
+        TripPatchStats *stats = &state->trip_stats[p];
+        ddsketch_init(&stats->duration_sec, DDSKETCH_DEFAULT_ACCURACY);
+        ddsketch_init(&stats->distance_world, DDSKETCH_DEFAULT_ACCURACY);
+        ddsketch_init(&stats->nectar_uL, DDSKETCH_DEFAULT_ACCURACY);
+        ddsketch_init(&stats->energy, DDSKETCH_DEFAULT_ACCURACY);
+        stats->abandoned = 0;
+    }
+}
+
+void trips_reset_bees(SimState *state, size_t begin, size_t end) {
+    if (!state || begin >= end) {
+        return;
+    }
+    size_t n = end - begin;
+    memset(state->trip_patch + begin, 0xFF, sizeof(int8_t) * n);
+    memset(state->trip_time_sec + begin, 0, sizeof(float) * n);
+    memset(state->trip_distance + begin, 0, sizeof(float) * n);
+}
+
+void trips_record(SimState *state, int32_t patch_id, float duration_sec, float distance_world,
+                  float nectar_uL, float energy) {
+    if (!state || patch_id < 0 || (size_t)patch_id >= SIM_MAX_FLOWER_PATCHES) {
+        return;
+    }
+    TripPatchStats *stats = &state->trip_stats[patch_id];
+    ddsketch_add(&stats->duration_sec, duration_sec);
+    ddsketch_add(&stats->distance_world, distance_world);
+    ddsketch_add(&stats->nectar_uL, nectar_uL);
+    ddsketch_add(&stats->energy, energy);
+}
+
+void trips_abandon(SimState *state, int32_t patch_id) {
+    if (!state || patch_id < 0 || (size_t)patch_id >= SIM_MAX_FLOWER_PATCHES) {
+        return;
+    }
+    state->trip_stats[patch_id].abandoned += 1;
+}
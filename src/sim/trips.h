@@ -0,0 +1,21 @@
+#ifndef SIM_TRIPS_H
+#define SIM_TRIPS_H
+
+#include "sim_internal.h"
+
+// Foraging-trip analytics. A trip opens on the first tick an OUTBOUND bee is
+// outside the hive (departures cancelled inside the hive do not count), tracks
+// elapsed time and distance flown in per-bee accumulators, is attributed to
+// the patch the bee last foraged, and closes when the return leg ends in
+// UNLOADING (or IDLE when nothing was carried). Closed trips feed per-patch
+// DDSketches; trips that fall back to IDLE before heading home are abandoned.
+
+void trips_reset(SimState *state);
+// Clears the per-patch sketches.
+void trips_reset_bees(SimState *state, size_t begin, size_t end);
+// Closes any open trip for bees [begin, end); safe to call from job workers.
+void trips_record(SimState *state, int32_t patch_id, float duration_sec, float distance_world,
+                  float nectar_uL, float energy);
+void trips_abandon(SimState *state, int32_t patch_id);
+
+#endif  // SIM_TRIPS_H
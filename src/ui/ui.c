@@ -2,12 +2,16 @@
 
 #include <glad/glad.h>
 
+#include <ctype.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "shader_cache.h"
+#include "util/alloc.h"
 #include "util/log.h"
+#include "util/trace.h"
 
 #define UI_PANEL_WIDTH 320.0f
 #define UI_PANEL_MARGIN 16.0f
@@ -37,6 +41,7 @@ typedef struct {
 } SliderSpec;
 
 static bool ui_rect_contains(const UiRect *rect, float px, float py);
+static void ui_widget_begin(uint32_t id);
 static size_t ui_add_rect(float x, float y, float w, float h, UiColor color);
 static float ui_measure_text(const char *text);
 static void ui_draw_text(float x, float y, const char *text, UiColor color);
@@ -53,14 +58,90 @@ static float ui_clampf(float v, float lo, float hi) {
 
 typedef struct {
     float x, y;
-    float r, g, b, a;
+    uint16_t u, v;  // normalized glyph atlas coordinates
+    uint8_t rgba[4];
 } UiVertex;
 
+// Glyph atlas. The 5x7 patterns are baked at ui_init into one R8 texture:
+// UI_ATLAS_COLUMNS cells per row, each glyph in the top-left 5x7 texels of
+// a 6x8 cell so that nearest sampling never bleeds into a neighbor. The last
+// cell is solid; rects sample its center, so rects and text share a vertex
+// format and one program, and a widget draws as a single range.
+#define UI_ATLAS_COLUMNS 16
+#define UI_ATLAS_ROWS 4
+#define UI_ATLAS_CELL_W 6
+#define UI_ATLAS_CELL_H 8
+#define UI_ATLAS_WIDTH (UI_ATLAS_COLUMNS * UI_ATLAS_CELL_W)
+#define UI_ATLAS_HEIGHT (UI_ATLAS_ROWS * UI_ATLAS_CELL_H)
+#define UI_ATLAS_SOLID_CELL (UI_ATLAS_COLUMNS * UI_ATLAS_ROWS - 1)
+
 typedef struct {
     char ch;
     unsigned char rows[7];
+    unsigned char pixel_count;
+    uint16_t uv[4];  // u0, v0, u1, v1
 } UiGlyph;
 
+// Retained geometry. Drawing calls record one UiCmd per rect or text run,
+// grouped into widgets. When a frame's build is done, each widget's commands
+// are hashed, and only widgets whose hash changed are expanded into
+// vertices. Each widget owns a slot in a persistent vertex buffer (mirrored
+// in g_ui.vertices), so:
+//   - an unchanged widget costs only its hash;
+//   - a rewritten widget uploads only its own slot;
+//   - ui_render draws this frame's slots in build order with one
+//     glMultiDrawArrays.
+
+#define UI_MAX_WIDGETS 64
+#define UI_COMPACT_MIN_VERTICES 4096
+
+typedef enum {
+    UI_W_LOOSE = 0,
+    UI_W_HAMBURGER,
+    UI_W_PANEL_FRAME,
+    UI_W_SIM_HEADER,
+    UI_W_FORAGE_HEADER,
+    UI_W_SPAWN_MODE,
+    UI_W_BEE_COUNT,
+    UI_W_WORLD_SIZE,
+    UI_W_PAUSE_STEP,
+    UI_W_QUEEN,
+    UI_W_APPLY_RESET,
+    UI_W_SELECTED_BEE,
+    UI_W_MEMORY,
+    UI_W_CHARTS,
+    UI_W_CHART_BASE = 128,   // + chart index
+    UI_W_SLIDER_BASE = 256,  // + SliderSpec.id
+} UiWidgetId;
+
+typedef enum {
+    UI_CMD_RECT = 0,
+    UI_CMD_TEXT = 1,
+} UiCmdType;
+
+typedef struct {
+    uint32_t type;
+    uint8_t rgba[4];
+    float x, y, w, h;      // text: origin in x/y, w/h unused
+    uint32_t text_offset;  // into g_ui.text; not part of the widget hash
+    uint32_t text_len;
+} UiCmd;
+
+typedef struct {
+    uint32_t id;
+    uint32_t first_cmd;
+    uint32_t cmd_count;
+} UiWidgetFrame;
+
+typedef struct {
+    uint32_t id;
+    uint64_t hash;  // 0 = never written
+    uint32_t first_vertex;
+    uint32_t vertex_count;
+    uint32_t vertex_capacity;
+    bool upload;    // rewritten since the last ui_render
+} UiWidgetSlot;
+
 typedef struct {
     bool panel_open;
     bool mouse_over_panel;
@@ -76,9 +157,24 @@ typedef struct {
     Params baseline;
     Params *runtime;
 
+    UiCmd *cmds;
+    size_t cmd_count;
+    size_t cmd_capacity;
+    char *text;
+    size_t text_used;
+    size_t text_capacity;
+    UiWidgetFrame widgets[UI_MAX_WIDGETS];
+    size_t widget_count;
+
+    UiWidgetSlot slots[UI_MAX_WIDGETS];
+    size_t slot_count;
     UiVertex *vertices;
-    size_t vert_count;
+    size_t vert_used;      // end of the last slot
+    size_t vert_garbage;   // vertices in slots abandoned by growing widgets
     size_t vert_capacity;
+    GLint draw_first[UI_MAX_WIDGETS];
+    GLsizei draw_count[UI_MAX_WIDGETS];
+    size_t draw_ranges;
 
     bool wants_mouse;
     bool wants_keyboard;
@@ -93,9 +189,10 @@ typedef struct {
     GLuint program;
     GLuint vao;
     GLuint vbo;
+    GLuint atlas_texture;
     GLint resolution_uniform;
+    GLint atlas_uniform;
 
-    bool show_hive_overlay;
     bool has_camera;
     float cam_center_x;
     float cam_center_y;
@@ -109,6 +206,16 @@ typedef struct {
     float panel_content_height;
     float panel_visible_height;
     float panel_last_width;
+    size_t gpu_vertex_capacity;
+    bool memory_panel_open;
+    bool memory_valid;
+    MemReport memory;
+    bool charts_panel_open;
+    size_t chart_window_index;
+    UiChartData charts[UI_MAX_CHARTS];
+    size_t chart_count;
+    char chart_labels[UI_MAX_CHARTS][32];
+    SeriesPoint chart_buckets[UI_MAX_CHARTS][UI_CHART_BUCKETS];
 } UiState;
 
 static UiState g_ui;
@@ -117,20 +224,25 @@ static const char *const UI_VERTEX_SHADER =
     "#version 330 core\n"
     "layout(location = 0) in vec2 a_pos;\n"
     "layout(location = 1) in vec4 a_color;\n"
+    "layout(location = 2) in vec2 a_uv;\n"
     "out vec4 v_color;\n"
+    "out vec2 v_uv;\n"
     "uniform vec2 u_resolution;\n"
     "void main(){\n"
     "    vec2 ndc = vec2((a_pos.x / u_resolution.x)*2.0 - 1.0, 1.0 - (a_pos.y / u_resolution.y)*2.0);\n"
     "    gl_Position = vec4(ndc, 0.0, 1.0);\n"
     "    v_color = a_color;\n"
+    "    v_uv = a_uv;\n"
     "}\n";
 
 static const char *const UI_FRAGMENT_SHADER =
     "#version 330 core\n"
     "in vec4 v_color;\n"
+    "in vec2 v_uv;\n"
     "out vec4 frag_color;\n"
+    "uniform sampler2D u_atlas;\n"
     "void main(){\n"
-    "    frag_color = v_color;\n"
+    "    frag_color = vec4(v_color.rgb, v_color.a * texture(u_atlas, v_uv).r);\n"
     "}\n";
 
 static UiColor ui_color_rgba(float r, float g, float b, float a) {
@@ -154,6 +266,7 @@ static float ui_draw_slider_group(const SliderSpec *sliders,
                                   float view_bottom) {
     for (size_t i = 0; i < slider_count; ++i) {
         const SliderSpec *spec = &sliders[i];
+        ui_widget_begin(UI_W_SLIDER_BASE + (uint32_t)spec->id);
         float label_y = cursor_y - scroll;
         if (ui_range_intersects(label_y, UI_CHAR_HEIGHT, view_top, view_bottom)) {
             ui_draw_text(text_x, label_y, spec->label, text_color);
@@ -260,71 +373,97 @@ static bool ui_range_intersects(float y, float h, float top, float bottom) {
     return max_y >= top && min_y <= bottom;
 }
 
-static void ui_reserve_vertices(size_t additional) {
-    if (g_ui.vert_count + additional <= g_ui.vert_capacity) {
-        return;
-    }
-    size_t new_capacity = g_ui.vert_capacity ? g_ui.vert_capacity : 1024;
-    while (g_ui.vert_count + additional > new_capacity) {
-        new_capacity *= 2;
-    }
-    UiVertex *new_vertices = (UiVertex *)realloc(g_ui.vertices, new_capacity * sizeof(UiVertex));
-    if (!new_vertices) {
-        LOG_ERROR("ui: failed to grow vertex buffer");
-        return;
+static void ui_pack_color(UiColor color, uint8_t out[4]) {
+    const float c[4] = {color.r, color.g, color.b, color.a};
+    for (int i = 0; i < 4; ++i) {
+        out[i] = (uint8_t)(ui_clampf(c[i], 0.0f, 1.0f) * 255.0f + 0.5f);
     }
-    g_ui.vertices = new_vertices;
-    g_ui.vert_capacity = new_capacity;
 }
 
-static void ui_push_vertex(float x, float y, UiColor color) {
-    ui_reserve_vertices(1);
-    if (!g_ui.vertices) {
+static void ui_widget_begin(uint32_t id) {
+    if (g_ui.widget_count >= UI_MAX_WIDGETS) {
+        // Out of widget slots: further commands join the last widget.
         return;
     }
-    UiVertex *v = &g_ui.vertices[g_ui.vert_count++];
-    v->x = x;
-    v->y = y;
-    v->r = color.r;
-    v->g = color.g;
-    v->b = color.b;
-    v->a = color.a;
+    UiWidgetFrame *widget = &g_ui.widgets[g_ui.widget_count++];
+    widget->id = id;
+    widget->first_cmd = (uint32_t)g_ui.cmd_count;
+    widget->cmd_count = 0;
+}
+
+static UiCmd *ui_push_cmd(UiCmdType type, UiColor color) {
+    if (g_ui.cmd_count == g_ui.cmd_capacity) {
+        size_t new_capacity = g_ui.cmd_capacity ? g_ui.cmd_capacity * 2 : 256;
+        UiCmd *new_cmds = (UiCmd *)mem_realloc(ALLOC_TAG_UI, g_ui.cmds, new_capacity * sizeof(UiCmd));
+        if (!new_cmds) {
+            LOG_ERROR("ui: failed to grow command buffer");
+            return NULL;
+        }
+        g_ui.cmds = new_cmds;
+        g_ui.cmd_capacity = new_capacity;
+    }
+    if (g_ui.widget_count == 0) {
+        ui_widget_begin(UI_W_LOOSE);
+    }
+    UiCmd *cmd = &g_ui.cmds[g_ui.cmd_count++];
+    memset(cmd, 0, sizeof(*cmd));
+    cmd->type = (uint32_t)type;
+    ui_pack_color(color, cmd->rgba);
+    g_ui.widgets[g_ui.widget_count - 1].cmd_count += 1;
+    return cmd;
 }
 
 static size_t ui_add_rect(float x, float y, float w, float h, UiColor color) {
-    ui_reserve_vertices(6);
-    if (!g_ui.vertices) {
-        return g_ui.vert_count;
-    }
-    size_t start = g_ui.vert_count;
-    ui_push_vertex(x, y, color);
-    ui_push_vertex(x + w, y, color);
-    ui_push_vertex(x + w, y + h, color);
-
-    ui_push_vertex(x, y, color);
-    ui_push_vertex(x + w, y + h, color);
-    ui_push_vertex(x, y + h, color);
-    return start;
+    UiCmd *cmd = ui_push_cmd(UI_CMD_RECT, color);
+    if (!cmd) {
+        return (size_t)-1;
+    }
+    cmd->x = x;
+    cmd->y = y;
+    cmd->w = w;
+    cmd->h = h;
+    return g_ui.cmd_count - 1;
 }
 
-static void ui_update_rect(size_t start, float x, float y, float w, float h) {
-    if (!g_ui.vertices || start + 6 > g_ui.vert_count) {
+static void ui_update_rect(size_t cmd_index, float x, float y, float w, float h) {
+    if (cmd_index >= g_ui.cmd_count || g_ui.cmds[cmd_index].type != UI_CMD_RECT) {
         return;
     }
-    UiVertex *verts = &g_ui.vertices[start];
-    verts[0].x = x;
-    verts[0].y = y;
-    verts[1].x = x + w;
-    verts[1].y = y;
-    verts[2].x = x + w;
-    verts[2].y = y + h;
-
-    verts[3].x = x;
-    verts[3].y = y;
-    verts[4].x = x + w;
-    verts[4].y = y + h;
-    verts[5].x = x;
-    verts[5].y = y + h;
+    UiCmd *cmd = &g_ui.cmds[cmd_index];
+    cmd->x = x;
+    cmd->y = y;
+    cmd->w = w;
+    cmd->h = h;
+}
+
+static void ui_draw_text(float x, float y, const char *text, UiColor color) {
+    size_t len = strlen(text);
+    if (len == 0) {
+        return;
+    }
+    if (g_ui.text_used + len > g_ui.text_capacity) {
+        size_t new_capacity = g_ui.text_capacity ? g_ui.text_capacity : 2048;
+        while (g_ui.text_used + len > new_capacity) {
+            new_capacity *= 2;
+        }
+        char *new_text = (char *)mem_realloc(ALLOC_TAG_UI, g_ui.text, new_capacity);
+        if (!new_text) {
+            LOG_ERROR("ui: failed to grow text buffer");
+            return;
+        }
+        g_ui.text = new_text;
+        g_ui.text_capacity = new_capacity;
+    }
+    UiCmd *cmd = ui_push_cmd(UI_CMD_TEXT, color);
+    if (!cmd) {
+        return;
+    }
+    memcpy(g_ui.text + g_ui.text_used, text, len);
+    cmd->x = x;
+    cmd->y = y;
+    cmd->text_offset = (uint32_t)g_ui.text_used;
+    cmd->text_len = (uint32_t)len;
+    g_ui.text_used += len;
 }
 
 static float ui_measure_text(const char *text) {
@@ -387,144 +526,6 @@ static const char *ui_intent_name(uint8_t intent) {
     }
 }
 
-static void ui_world_to_screen(float wx, float wy, float *sx, float *sy) {
-    float zoom = g_ui.cam_zoom > 0.0f ? g_ui.cam_zoom : 1.0f;
-    float cx = g_ui.cam_center_x;
-    float cy = g_ui.cam_center_y;
-    *sx = (wx - cx) * zoom + 0.5f * (float)g_ui.fb_width;
-    *sy = (wy - cy) * zoom + 0.5f * (float)g_ui.fb_height;
-}
-
-static void ui_draw_hive_segment_horizontal(float ax, float bx, float y_world, UiColor color, float thickness) {
-    if (fabsf(bx - ax) < 1e-4f) {
-        return;
-    }
-    float sx0, sy0, sx1, sy1;
-    ui_world_to_screen(ax, y_world, &sx0, &sy0);
-    ui_world_to_screen(bx, y_world, &sx1, &sy1);
-    float width = fabsf(sx1 - sx0);
-    if (width < 1.0f) {
-        return;
-    }
-    float x = fminf(sx0, sx1);
-    float y = sy0 - 0.5f * thickness;
-    ui_add_rect(x, y, width, thickness, color);
-}
-
-static void ui_draw_hive_segment_vertical(float ay, float by, float x_world, UiColor color, float thickness) {
-    if (fabsf(by - ay) < 1e-4f) {
-        return;
-    }
-    float sx0, sy0, sx1, sy1;
-    ui_world_to_screen(x_world, ay, &sx0, &sy0);
-    ui_world_to_screen(x_world, by, &sx1, &sy1);
-    float height = fabsf(sy1 - sy0);
-    if (height < 1.0f) {
-        return;
-    }
-    float y = fminf(sy0, sy1);
-    float x = sx0 - 0.5f * thickness;
-    ui_add_rect(x, y, thickness, height, color);
-}
-
-static void ui_draw_hive_overlay(void) {
-    if (!g_ui.show_hive_overlay || !g_ui.runtime || !g_ui.has_camera) {
-        return;
-    }
-    if (g_ui.fb_width <= 0 || g_ui.fb_height <= 0) {
-        return;
-    }
-    const Params *p = g_ui.runtime;
-    if (p->hive.rect_w <= 0.0f || p->hive.rect_h <= 0.0f) {
-        return;
-    }
-
-    const float x = p->hive.rect_x;
-    const float y = p->hive.rect_y;
-    const float w = p->hive.rect_w;
-    const float h = p->hive.rect_h;
-
-    const int side = p->hive.entrance_side;
-    const float half_gap = p->hive.entrance_width * 0.5f;
-    float gap_min = 0.0f;
-    float gap_max = 0.0f;
-    if (side == 0 || side == 1) {
-        float gap_center = x + p->hive.entrance_t * w;
-        gap_min = fmaxf(x, gap_center - half_gap);
-        gap_max = fminf(x + w, gap_center + half_gap);
-    } else {
-        float gap_center = y + p->hive.entrance_t * h;
-        gap_min = fmaxf(y, gap_center - half_gap);
-        gap_max = fminf(y + h, gap_center + half_gap);
-    }
-
-    UiColor wall_color = ui_color_rgba(0.95f, 0.75f, 0.15f, 0.9f);
-    UiColor gap_color = ui_color_rgba(0.2f, 0.85f, 0.35f, 0.9f);
-    float thickness = fmaxf(2.0f, g_ui.cam_zoom * 0.8f);
-
-    // Top
-    if (side == 0) {
-        if (gap_min - x > 1e-4f) {
-            ui_draw_hive_segment_horizontal(x, gap_min, y, wall_color, thickness);
-        }
-        if (x + w - gap_max > 1e-4f) {
-            ui_draw_hive_segment_horizontal(gap_max, x + w, y, wall_color, thickness);
-        }
-        if (gap_max > gap_min) {
-            ui_draw_hive_segment_horizontal(gap_min, gap_max, y, gap_color, thickness);
-        }
-    } else {
-        ui_draw_hive_segment_horizontal(x, x + w, y, wall_color, thickness);
-    }
-
-    // Bottom
-    float y_bottom = y + h;
-    if (side == 1) {
-        if (gap_min - x > 1e-4f) {
-            ui_draw_hive_segment_horizontal(x, gap_min, y_bottom, wall_color, thickness);
-        }
-        if (x + w - gap_max > 1e-4f) {
-            ui_draw_hive_segment_horizontal(gap_max, x + w, y_bottom, wall_color, thickness);
-        }
-        if (gap_max > gap_min) {
-            ui_draw_hive_segment_horizontal(gap_min, gap_max, y_bottom, gap_color, thickness);
-        }
-    } else {
-        ui_draw_hive_segment_horizontal(x, x + w, y_bottom, wall_color, thickness);
-    }
-
-    // Left
-    if (side == 2) {
-        if (gap_min - y > 1e-4f) {
-            ui_draw_hive_segment_vertical(y, gap_min, x, wall_color, thickness);
-        }
-        if (y + h - gap_max > 1e-4f) {
-            ui_draw_hive_segment_vertical(gap_max, y + h, x, wall_color, thickness);
-        }
-        if (gap_max > gap_min) {
-            ui_draw_hive_segment_vertical(gap_min, gap_max, x, gap_color, thickness);
-        }
-    } else {
-        ui_draw_hive_segment_vertical(y, y + h, x, wall_color, thickness);
-    }
-
-    // Right
-    float x_right = x + w;
-    if (side == 3) {
-        if (gap_min - y > 1e-4f) {
-            ui_draw_hive_segment_vertical(y, gap_min, x_right, wall_color, thickness);
-        }
-        if (y + h - gap_max > 1e-4f) {
-            ui_draw_hive_segment_vertical(gap_max, y + h, x_right, wall_color, thickness);
-        }
-        if (gap_max > gap_min) {
-            ui_draw_hive_segment_vertical(gap_min, gap_max, x_right, gap_color, thickness);
-        }
-    } else {
-        ui_draw_hive_segment_vertical(y, y + h, x_right, wall_color, thickness);
-    }
-}
-
 void ui_set_viewport(const RenderCamera *camera, int framebuffer_width, int framebuffer_height) {
     g_ui.fb_width = framebuffer_width;
     g_ui.fb_height = framebuffer_height;
@@ -538,10 +539,6 @@ void ui_set_viewport(const RenderCamera *camera, int framebuffer_width, int fram
     g_ui.has_camera = true;
 }
 
-void ui_enable_hive_overlay(bool enabled) {
-    g_ui.show_hive_overlay = enabled;
-}
-
 void ui_set_selected_bee(const BeeDebugInfo *info, bool valid) {
     if (valid && info) {
         g_ui.selected_bee = *info;
@@ -622,6 +619,17 @@ static const UiGlyphPattern g_glyph_patterns[] = {
 static UiGlyph g_glyphs[sizeof(g_glyph_patterns) / sizeof(g_glyph_patterns[0])];
 static size_t g_glyph_count = 0;
 static bool g_glyphs_ready = false;
+static unsigned char g_glyph_lookup[128];  // ASCII -> g_glyphs index, 0 (space) if missing
+static uint16_t g_solid_uv[2];
+
+static uint16_t ui_atlas_coord(float texel, float size) {
+    return (uint16_t)(texel / size * 65535.0f + 0.5f);
+}
+
+static void ui_atlas_cell_origin(size_t cell, int *out_x, int *out_y) {
+    *out_x = (int)(cell % UI_ATLAS_COLUMNS) * UI_ATLAS_CELL_W;
+    *out_y = (int)(cell / UI_ATLAS_COLUMNS) * UI_ATLAS_CELL_H;
+}
 
 static void ui_build_glyph_cache(void) {
     if (g_glyphs_ready) {
@@ -633,7 +641,31 @@ static void ui_build_glyph_cache(void) {
         for (int row = 0; row < 7; ++row) {
             g_glyphs[i].rows[row] = ui_row_bits_from_pattern(g_glyph_patterns[i].rows[row]);
         }
-    }
+        unsigned char pixels = 0;
+        for (int row = 0; row < 7; ++row) {
+            for (unsigned char bits = g_glyphs[i].rows[row]; bits; bits &= (unsigned char)(bits - 1)) {
+                ++pixels;
+            }
+        }
+        g_glyphs[i].pixel_count = pixels;
+
+        int cx = 0;
+        int cy = 0;
+        ui_atlas_cell_origin(i, &cx, &cy);
+        g_glyphs[i].uv[0] = ui_atlas_coord((float)cx, (float)UI_ATLAS_WIDTH);
+        g_glyphs[i].uv[1] = ui_atlas_coord((float)cy, (float)UI_ATLAS_HEIGHT);
+        g_glyphs[i].uv[2] = ui_atlas_coord((float)(cx + 5), (float)UI_ATLAS_WIDTH);
+        g_glyphs[i].uv[3] = ui_atlas_coord((float)(cy + 7), (float)UI_ATLAS_HEIGHT);
+    }
+    memset(g_glyph_lookup, 0, sizeof(g_glyph_lookup));
+    for (size_t i = g_glyph_count; i-- > 0;) {
+        g_glyph_lookup[(unsigned char)g_glyphs[i].ch & 127u] = (unsigned char)i;
+    }
+    int sx = 0;
+    int sy = 0;
+    ui_atlas_cell_origin(UI_ATLAS_SOLID_CELL, &sx, &sy);
+    g_solid_uv[0] = ui_atlas_coord((float)sx + 2.5f, (float)UI_ATLAS_WIDTH);
+    g_solid_uv[1] = ui_atlas_coord((float)sy + 3.5f, (float)UI_ATLAS_HEIGHT);
     g_glyphs_ready = true;
 }
 
@@ -641,37 +673,228 @@ static const UiGlyph *ui_find_glyph(char ch) {
     if (!g_glyphs_ready) {
         ui_build_glyph_cache();
     }
-    for (size_t i = 0; i < g_glyph_count; ++i) {
-        if (g_glyphs[i].ch == ch) {
-            return &g_glyphs[i];
+    unsigned char c = (unsigned char)ch;
+    return &g_glyphs[c < 128u ? g_glyph_lookup[c] : 0];
+}
+
+static GLuint ui_create_glyph_atlas(void) {
+    ui_build_glyph_cache();
+    if (g_glyph_count > UI_ATLAS_SOLID_CELL) {
+        LOG_ERROR("ui: %zu glyphs do not fit the %dx%d atlas", g_glyph_count, UI_ATLAS_COLUMNS,
+                  UI_ATLAS_ROWS);
+        return 0;
+    }
+    static unsigned char texels[UI_ATLAS_HEIGHT][UI_ATLAS_WIDTH];
+    memset(texels, 0, sizeof(texels));
+    for (size_t i = 0; i <= g_glyph_count; ++i) {
+        size_t cell = i < g_glyph_count ? i : UI_ATLAS_SOLID_CELL;
+        int cx = 0;
+        int cy = 0;
+        ui_atlas_cell_origin(cell, &cx, &cy);
+        for (int row = 0; row < 7; ++row) {
+            unsigned char bits = i < g_glyph_count ? g_glyphs[i].rows[row] : 0x1Fu;
+            for (int col = 0; col < 5; ++col) {
+                if (bits & (1 << (4 - col))) {
+                    texels[cy + row][cx + col] = 255;
+                }
+            }
         }
     }
-    return &g_glyphs[0];
+
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, UI_ATLAS_WIDTH, UI_ATLAS_HEIGHT, 0, GL_RED, GL_UNSIGNED_BYTE,
+                 texels);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
 }
 
-static void ui_draw_text(float x, float y, const char *text, UiColor color) {
-    float cursor_x = x;
-    float cursor_y = y;
-    while (*text) {
-        char ch = *text++;
+static uint64_t ui_hash_bytes(uint64_t hash, const void *data, size_t len) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static uint64_t ui_widget_hash(const UiWidgetFrame *widget) {
+    uint64_t hash = 14695981039346656037ull;
+    for (uint32_t c = 0; c < widget->cmd_count; ++c) {
+        const UiCmd *cmd = &g_ui.cmds[widget->first_cmd + c];
+        hash = ui_hash_bytes(hash, cmd, offsetof(UiCmd, text_offset));
+        hash = ui_hash_bytes(hash, &cmd->text_len, sizeof(cmd->text_len));
+        if (cmd->type == UI_CMD_TEXT) {
+            hash = ui_hash_bytes(hash, g_ui.text + cmd->text_offset, cmd->text_len);
+        }
+    }
+    return hash ? hash : 1u;
+}
+
+static size_t ui_cmd_vertex_count(const UiCmd *cmd) {
+    if (cmd->type == UI_CMD_RECT) {
+        return 6;
+    }
+    size_t quads = 0;
+    const char *text = g_ui.text + cmd->text_offset;
+    for (uint32_t i = 0; i < cmd->text_len; ++i) {
+        if (text[i] != '\n' && ui_find_glyph(text[i])->pixel_count > 0) {
+            ++quads;
+        }
+    }
+    return quads * 6;
+}
+
+static UiVertex *ui_emit_quad(UiVertex *out,
+                              float x,
+                              float y,
+                              float w,
+                              float h,
+                              const uint16_t uv[4],
+                              const uint8_t rgba[4]) {
+    const float xs[6] = {x, x + w, x + w, x, x + w, x};
+    const float ys[6] = {y, y, y + h, y, y + h, y + h};
+    const uint16_t us[6] = {uv[0], uv[2], uv[2], uv[0], uv[2], uv[0]};
+    const uint16_t vs[6] = {uv[1], uv[1], uv[3], uv[1], uv[3], uv[3]};
+    for (int i = 0; i < 6; ++i) {
+        out[i].x = xs[i];
+        out[i].y = ys[i];
+        out[i].u = us[i];
+        out[i].v = vs[i];
+        memcpy(out[i].rgba, rgba, sizeof(out[i].rgba));
+    }
+    return out + 6;
+}
+
+static UiVertex *ui_emit_rect(UiVertex *out, float x, float y, float w, float h, const uint8_t rgba[4]) {
+    const uint16_t uv[4] = {g_solid_uv[0], g_solid_uv[1], g_solid_uv[0], g_solid_uv[1]};
+    return ui_emit_quad(out, x, y, w, h, uv, rgba);
+}
+
+static UiVertex *ui_emit_text(UiVertex *out, const UiCmd *cmd) {
+    const char *text = g_ui.text + cmd->text_offset;
+    float cursor_x = cmd->x;
+    float cursor_y = cmd->y;
+    for (uint32_t i = 0; i < cmd->text_len; ++i) {
+        char ch = text[i];
         if (ch == '\n') {
-            cursor_x = x;
+            cursor_x = cmd->x;
             cursor_y += UI_CHAR_HEIGHT + UI_FONT_SCALE;
             continue;
         }
         const UiGlyph *glyph = ui_find_glyph(ch);
-        for (int row = 0; row < 7; ++row) {
-            unsigned char bits = glyph->rows[row];
-            for (int col = 0; col < 5; ++col) {
-                if (bits & (1 << (4 - col))) {
-                    float px = cursor_x + col * UI_FONT_SCALE;
-                    float py = cursor_y + row * UI_FONT_SCALE;
-                    ui_add_rect(px, py, UI_FONT_SCALE, UI_FONT_SCALE, color);
-                }
-            }
+        if (glyph->pixel_count > 0) {
+            out = ui_emit_quad(out, cursor_x, cursor_y, UI_CHAR_WIDTH, UI_CHAR_HEIGHT, glyph->uv, cmd->rgba);
         }
         cursor_x += UI_CHAR_ADVANCE;
     }
+    return out;
+}
+
+static bool ui_reserve_vertices(size_t total) {
+    if (total <= g_ui.vert_capacity) {
+        return true;
+    }
+    size_t new_capacity = g_ui.vert_capacity ? g_ui.vert_capacity : 2048;
+    while (total > new_capacity) {
+        new_capacity *= 2;
+    }
+    UiVertex *new_vertices = (UiVertex *)mem_realloc(ALLOC_TAG_UI, g_ui.vertices,
+                                                      new_capacity * sizeof(UiVertex));
+    if (!new_vertices) {
+        LOG_ERROR("ui: failed to grow vertex buffer");
+        return false;
+    }
+    g_ui.vertices = new_vertices;
+    g_ui.vert_capacity = new_capacity;
+    return true;
+}
+
+static UiWidgetSlot *ui_slot_for(uint32_t id) {
+    for (size_t i = 0; i < g_ui.slot_count; ++i) {
+        if (g_ui.slots[i].id == id) {
+            return &g_ui.slots[i];
+        }
+    }
+    if (g_ui.slot_count == UI_MAX_WIDGETS) {
+        return NULL;
+    }
+    UiWidgetSlot *slot = &g_ui.slots[g_ui.slot_count++];
+    memset(slot, 0, sizeof(*slot));
+    slot->id = id;
+    return slot;
+}
+
+static bool ui_write_widget(UiWidgetSlot *slot, const UiWidgetFrame *widget, uint64_t hash) {
+    size_t needed = 0;
+    for (uint32_t c = 0; c < widget->cmd_count; ++c) {
+        needed += ui_cmd_vertex_count(&g_ui.cmds[widget->first_cmd + c]);
+    }
+    if (needed > slot->vertex_capacity) {
+        // Move to a fresh slot at the end, with headroom so a value that
+        // gains a digit next frame still fits in place.
+        size_t capacity = needed + needed / 4 + 64;
+        if (!ui_reserve_vertices(g_ui.vert_used + capacity)) {
+            return false;
+        }
+        g_ui.vert_garbage += slot->vertex_capacity;
+        slot->first_vertex = (uint32_t)g_ui.vert_used;
+        slot->vertex_capacity = (uint32_t)capacity;
+        g_ui.vert_used += capacity;
+    }
+    UiVertex *out = &g_ui.vertices[slot->first_vertex];
+    for (uint32_t c = 0; c < widget->cmd_count; ++c) {
+        const UiCmd *cmd = &g_ui.cmds[widget->first_cmd + c];
+        if (cmd->type == UI_CMD_RECT) {
+            out = ui_emit_rect(out, cmd->x, cmd->y, cmd->w, cmd->h, cmd->rgba);
+        } else {
+            out = ui_emit_text(out, cmd);
+        }
+    }
+    slot->vertex_count = (uint32_t)needed;
+    slot->hash = hash;
+    slot->upload = true;
+    return true;
+}
+
+static void ui_commit_widgets(void) {
+    if (g_ui.vert_garbage > UI_COMPACT_MIN_VERTICES && g_ui.vert_garbage * 2 > g_ui.vert_used) {
+        // Drop every slot; this frame's widgets are rewritten back to back.
+        g_ui.slot_count = 0;
+        g_ui.vert_used = 0;
+        g_ui.vert_garbage = 0;
+    }
+    g_ui.draw_ranges = 0;
+    for (size_t w = 0; w < g_ui.widget_count; ++w) {
+        const UiWidgetFrame *widget = &g_ui.widgets[w];
+        UiWidgetSlot *slot = ui_slot_for(widget->id);
+        if (!slot) {
+            continue;
+        }
+        uint64_t hash = ui_widget_hash(widget);
+        if (hash != slot->hash && !ui_write_widget(slot, widget, hash)) {
+            continue;
+        }
+        if (slot->vertex_count == 0) {
+            continue;
+        }
+        // Adjacent slots that are full merge into one draw range.
+        size_t last = g_ui.draw_ranges;
+        if (last > 0 &&
+            (size_t)g_ui.draw_first[last - 1] + (size_t)g_ui.draw_count[last - 1] == slot->first_vertex) {
+            g_ui.draw_count[last - 1] += (GLsizei)slot->vertex_count;
+        } else {
+            g_ui.draw_first[last] = (GLint)slot->first_vertex;
+            g_ui.draw_count[last] = (GLsizei)slot->vertex_count;
+            g_ui.draw_ranges += 1;
+        }
+    }
 }
 
 static void ui_draw_selected_bee_panel(void) {
@@ -764,6 +987,7 @@ static void ui_draw_selected_bee_panel(void) {
     float text_x = origin_x + padding;
     float cursor_y = origin_y + 18.0f;
 
+    ui_widget_begin(UI_W_SELECTED_BEE);
     size_t bg_idx = ui_add_rect(origin_x, origin_y, panel_width, 1.0f, bg);
 
     for (size_t i = 0; i < line_count; ++i) {
@@ -774,51 +998,270 @@ static void ui_draw_selected_bee_panel(void) {
     float panel_h = (cursor_y + 12.0f) - origin_y;
     ui_update_rect(bg_idx, origin_x, origin_y, panel_width, panel_h);
 }
-static GLuint ui_create_shader(const char *vs_src, const char *fs_src) {
-    GLuint vs = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vs, 1, &vs_src, NULL);
-    glCompileShader(vs);
-    GLint compiled = 0;
-    glGetShaderiv(vs, GL_COMPILE_STATUS, &compiled);
-    if (!compiled) {
-        char log[512];
-        glGetShaderInfoLog(vs, (GLsizei)sizeof(log), NULL, log);
-        LOG_ERROR("ui: vertex shader compile error: %s", log);
-    }
-
-    GLuint fs = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fs, 1, &fs_src, NULL);
-    glCompileShader(fs);
-    glGetShaderiv(fs, GL_COMPILE_STATUS, &compiled);
-    if (!compiled) {
-        char log[512];
-        glGetShaderInfoLog(fs, (GLsizei)sizeof(log), NULL, log);
-        LOG_ERROR("ui: fragment shader compile error: %s", log);
-    }
-
-    GLuint program = glCreateProgram();
-    glAttachShader(program, vs);
-    glAttachShader(program, fs);
-    glLinkProgram(program);
-    GLint linked = 0;
-    glGetProgramiv(program, GL_LINK_STATUS, &linked);
-    if (!linked) {
-        char log[512];
-        glGetProgramInfoLog(program, (GLsizei)sizeof(log), NULL, log);
-        LOG_ERROR("ui: shader link error: %s", log);
-    }
-
-    glDeleteShader(vs);
-    glDeleteShader(fs);
-    return program;
+static double ui_mib(uint64_t bytes) {
+    return (double)bytes / (1024.0 * 1024.0);
+}
+
+static void ui_draw_memory_panel(void) {
+    if (!g_ui.memory_panel_open || !g_ui.memory_valid) {
+        return;
+    }
+    if (g_ui.fb_width <= 0 || g_ui.fb_height <= 0) {
+        return;
+    }
+
+    const MemReport *report = &g_ui.memory;
+    const float padding = 16.0f;
+    const float line_step = 18.0f;
+    UiColor bg = ui_color_rgba(0.10f, 0.10f, 0.14f, 0.94f);
+    UiColor header = ui_color_rgba(0.95f, 0.95f, 0.98f, 1.0f);
+    UiColor text_color = ui_color_rgba(0.85f, 0.88f, 0.92f, 1.0f);
+    UiColor accent = ui_color_rgba(0.30f, 0.65f, 0.95f, 1.0f);
+
+    char lines[8][96];
+    UiColor colors[8];
+    size_t line_count = 0;
+
+    snprintf(lines[line_count], sizeof lines[0], "MEMORY (M)");
+    colors[line_count++] = header;
+    snprintf(lines[line_count], sizeof lines[0], "CPU %.1f MB  GPU %.1f MB",
+             ui_mib(mem_report_total(report, NULL, MEM_REGION_CPU)),
+             ui_mib(mem_report_total(report, NULL, MEM_REGION_GPU)));
+    colors[line_count++] = accent;
+    snprintf(lines[line_count], sizeof lines[0], "%zu BEES  %.0f B/BEE (+%.0f PER BEE)",
+             report->bee_count,
+             mem_report_bytes_per_bee(report, false),
+             mem_report_bytes_per_bee(report, true));
+    colors[line_count++] = accent;
+
+    for (size_t i = 0; i < report->count && line_count < 8; ++i) {
+        const char *subsystem = report->entries[i].subsystem;
+        bool seen = false;
+        for (size_t j = 0; j < i; ++j) {
+            if (strcmp(report->entries[j].subsystem, subsystem) == 0) {
+                seen = true;
+                break;
+            }
+        }
+        if (seen) {
+            continue;
+        }
+        char name[16];
+        size_t n = 0;
+        for (; subsystem[n] && n + 1 < sizeof name; ++n) {
+            name[n] = (char)toupper((unsigned char)subsystem[n]);
+        }
+        name[n] = '\0';
+        snprintf(lines[line_count], sizeof lines[0], "%s  CPU %.2f MB  GPU %.2f MB", name,
+                 ui_mib(mem_report_total(report, subsystem, MEM_REGION_CPU)),
+                 ui_mib(mem_report_total(report, subsystem, MEM_REGION_GPU)));
+        colors[line_count++] = text_color;
+    }
+
+    float max_width = 0.0f;
+    for (size_t i = 0; i < line_count; ++i) {
+        max_width = fmaxf(max_width, ui_measure_text(lines[i]));
+    }
+    float panel_w = max_width + padding * 2.0f;
+    float panel_h = padding * 2.0f + line_step * (float)line_count;
+    float origin_x = fmaxf(UI_PANEL_MARGIN, (float)g_ui.fb_width - panel_w - UI_PANEL_MARGIN);
+    float origin_y = fmaxf(UI_PANEL_MARGIN, (float)g_ui.fb_height - panel_h - UI_PANEL_MARGIN);
+
+    ui_widget_begin(UI_W_MEMORY);
+    ui_add_rect(origin_x, origin_y, panel_w, panel_h, bg);
+    float cursor_y = origin_y + padding;
+    for (size_t i = 0; i < line_count; ++i) {
+        ui_draw_text(origin_x + padding, cursor_y, lines[i], colors[i]);
+        cursor_y += line_step;
+    }
+}
+
+void ui_toggle_memory_panel(void) {
+    g_ui.memory_panel_open = !g_ui.memory_panel_open;
+}
+
+bool ui_memory_panel_open(void) {
+    return g_ui.memory_panel_open;
+}
+
+void ui_set_memory_report(const MemReport *report) {
+    if (!report) {
+        g_ui.memory_valid = false;
+        return;
+    }
+    g_ui.memory = *report;
+    g_ui.memory_valid = true;
+}
+
+void ui_memory_report(MemReport *report) {
+    if (!report) {
+        return;
+    }
+    mem_report_add(report, "ui", "commands",
+                   (uint64_t)g_ui.cmd_capacity * sizeof(UiCmd) + (uint64_t)g_ui.text_capacity,
+                   MEM_REGION_CPU, false);
+    mem_report_add(report, "ui", "vertices", (uint64_t)g_ui.vert_capacity * sizeof(UiVertex),
+                   MEM_REGION_CPU, false);
+    mem_report_add(report, "ui", "vertices", (uint64_t)g_ui.gpu_vertex_capacity * sizeof(UiVertex),
+                   MEM_REGION_GPU, false);
+    mem_report_add(report, "ui", "glyph_atlas",
+                   g_ui.atlas_texture ? (uint64_t)UI_ATLAS_WIDTH * UI_ATLAS_HEIGHT : 0u, MEM_REGION_GPU,
+                   false);
+}
+
+// Windows the charts overlay cycles through; the default is ten minutes.
+static const double kChartWindowsSec[] = {60.0, 600.0, 3600.0, 21600.0};
+static const char *const kChartWindowNames[] = {"1 MIN", "10 MIN", "1 H", "6 H"};
+#define UI_CHART_WINDOW_COUNT (sizeof(kChartWindowsSec) / sizeof(kChartWindowsSec[0]))
+#define UI_CHART_DEFAULT_WINDOW 1
+
+// Bottom-left overlay with one min/max envelope per chart. Each bucket is a
+// dim bar spanning its min and max and a bright bar joining the previous
+// bucket's mean to its own, so the means read as a connected line. The
+// title and labels sit in one widget and each plot in its own, so the
+// per-frame label changes leave the bars (which change once per closed
+// point) retained. Returns true when the mouse is over the overlay.
+static bool ui_draw_charts_panel(bool mouse_pressed) {
+    if (!g_ui.charts_panel_open || g_ui.chart_count == 0) {
+        return false;
+    }
+    if (g_ui.fb_width <= 0 || g_ui.fb_height <= 0) {
+        return false;
+    }
+
+    const float padding = 12.0f;
+    const float line_step = 18.0f;
+    const float plot_h = 44.0f;
+    const float chart_gap = 8.0f;
+    const float panel_w = 360.0f;
+    UiColor bg = ui_color_rgba(0.10f, 0.10f, 0.14f, 0.94f);
+    UiColor header = ui_color_rgba(0.95f, 0.95f, 0.98f, 1.0f);
+    UiColor text_color = ui_color_rgba(0.85f, 0.88f, 0.92f, 1.0f);
+    UiColor plot_bg = ui_color_rgba(0.05f, 0.05f, 0.07f, 1.0f);
+    UiColor envelope = ui_color_rgba(0.30f, 0.65f, 0.95f, 0.35f);
+    UiColor mean_color = ui_color_rgba(0.30f, 0.65f, 0.95f, 1.0f);
+
+    float panel_h = padding * 2.0f + line_step +
+                    (line_step + plot_h + chart_gap) * (float)g_ui.chart_count - chart_gap;
+    float origin_x = UI_PANEL_MARGIN;
+    if (g_ui.panel_open) {
+        origin_x += g_ui.panel_last_width + UI_PANEL_MARGIN;
+    }
+    float origin_y = fmaxf(UI_PANEL_MARGIN, (float)g_ui.fb_height - panel_h - UI_PANEL_MARGIN);
+    UiRect panel = {origin_x, origin_y, panel_w, panel_h};
+    bool hover = ui_rect_contains(&panel, g_ui.mouse_x, g_ui.mouse_y);
+    if (hover && mouse_pressed) {
+        g_ui.chart_window_index = (g_ui.chart_window_index + 1) % UI_CHART_WINDOW_COUNT;
+    }
+
+    char line[64];
+    ui_widget_begin(UI_W_CHARTS);
+    ui_add_rect(panel.x, panel.y, panel.w, panel.h, bg);
+    snprintf(line, sizeof line, "CHARTS (C)  LAST %s", kChartWindowNames[g_ui.chart_window_index]);
+    ui_draw_text(origin_x + padding, origin_y + padding, line, header);
+    float cursor_y = origin_y + padding + line_step;
+    for (size_t c = 0; c < g_ui.chart_count; ++c) {
+        const UiChartData *chart = &g_ui.charts[c];
+        float latest = chart->latest;
+        snprintf(line, sizeof line, fabsf(latest) < 10.0f ? "%s  %.2f" : "%s  %.0f", chart->label,
+                 (double)latest);
+        ui_draw_text(origin_x + padding, cursor_y, line, text_color);
+        cursor_y += line_step + plot_h + chart_gap;
+    }
+
+    float plot_x = origin_x + padding;
+    float plot_w = panel_w - padding * 2.0f;
+    cursor_y = origin_y + padding + line_step;
+    for (size_t c = 0; c < g_ui.chart_count; ++c) {
+        const UiChartData *chart = &g_ui.charts[c];
+        float plot_y = cursor_y + line_step;
+        cursor_y += line_step + plot_h + chart_gap;
+        ui_widget_begin(UI_W_CHART_BASE + (uint32_t)c);
+        ui_add_rect(plot_x, plot_y, plot_w, plot_h, plot_bg);
+        if (chart->bucket_count == 0 || chart->slot_count == 0) {
+            continue;
+        }
+
+        float lo = chart->buckets[0].min;
+        float hi = chart->buckets[0].max;
+        for (size_t b = 1; b < chart->bucket_count; ++b) {
+            lo = fminf(lo, chart->buckets[b].min);
+            hi = fmaxf(hi, chart->buckets[b].max);
+        }
+        if (hi - lo < 1e-6f) {
+            float pad = fmaxf(fabsf(hi) * 0.5f, 0.5f);
+            lo -= pad;
+            hi += pad;
+        }
+        float scale = (plot_h - 2.0f) / (hi - lo);
+        float bar_w = plot_w / (float)chart->slot_count;
+        size_t first_slot = chart->slot_count - chart->bucket_count;
+        float prev_mean = chart->buckets[0].mean;
+        for (size_t b = 0; b < chart->bucket_count; ++b) {
+            const SeriesPoint *point = &chart->buckets[b];
+            float x = plot_x + (float)(first_slot + b) * bar_w;
+            float y_max = plot_y + 1.0f + (hi - point->max) * scale;
+            float y_min = plot_y + 1.0f + (hi - point->min) * scale;
+            ui_add_rect(x, y_max, fmaxf(bar_w, 1.0f), fmaxf(y_min - y_max, 1.0f), envelope);
+            float y_mean = plot_y + 1.0f + (hi - point->mean) * scale;
+            float y_prev = plot_y + 1.0f + (hi - prev_mean) * scale;
+            float top = fminf(y_mean, y_prev) - 1.0f;
+            float bottom = fmaxf(y_mean, y_prev) + 1.0f;
+            ui_add_rect(x, top, fmaxf(bar_w, 1.0f), bottom - top, mean_color);
+            prev_mean = point->mean;
+        }
+    }
+    return hover;
+}
+
+void ui_toggle_charts_panel(void) {
+    g_ui.charts_panel_open = !g_ui.charts_panel_open;
+}
+
+bool ui_charts_panel_open(void) {
+    return g_ui.charts_panel_open;
+}
+
+double ui_chart_window_sec(void) {
+    return kChartWindowsSec[g_ui.chart_window_index];
+}
+
+void ui_set_charts(const UiChartData *charts, size_t count) {
+    if (!charts) {
+        count = 0;
+    }
+    if (count > UI_MAX_CHARTS) {
+        count = UI_MAX_CHARTS;
+    }
+    for (size_t c = 0; c < count; ++c) {
+        UiChartData *dst = &g_ui.charts[c];
+        size_t buckets = charts[c].bucket_count < UI_CHART_BUCKETS ? charts[c].bucket_count : UI_CHART_BUCKETS;
+        snprintf(g_ui.chart_labels[c], sizeof g_ui.chart_labels[c], "%s",
+                 charts[c].label ? charts[c].label : "");
+        if (buckets > 0 && charts[c].buckets) {
+            memcpy(g_ui.chart_buckets[c], charts[c].buckets, buckets * sizeof(SeriesPoint));
+        } else {
+            buckets = 0;
+        }
+        dst->label = g_ui.chart_labels[c];
+        dst->buckets = g_ui.chart_buckets[c];
+        dst->bucket_count = buckets;
+        dst->slot_count = charts[c].slot_count < buckets ? buckets : charts[c].slot_count;
+        if (dst->slot_count > UI_CHART_BUCKETS) {
+            dst->slot_count = UI_CHART_BUCKETS;
+        }
+        dst->latest = charts[c].latest;
+    }
+    g_ui.chart_count = count;
 }
 
 void ui_init(void) {
     memset(&g_ui, 0, sizeof(g_ui));
-    ui_build_glyph_cache();
-    g_ui.program = ui_create_shader(UI_VERTEX_SHADER, UI_FRAGMENT_SHADER);
+    g_ui.chart_window_index = UI_CHART_DEFAULT_WINDOW;
+    g_ui.atlas_texture = ui_create_glyph_atlas();
+    g_ui.program = shader_program_build("ui", UI_VERTEX_SHADER, UI_FRAGMENT_SHADER);
     g_ui.resolution_uniform = glGetUniformLocation(g_ui.program, "u_resolution");
-    g_ui.show_hive_overlay = true;
+    g_ui.atlas_uniform = glGetUniformLocation(g_ui.program, "u_atlas");
     g_ui.has_camera = false;
     g_ui.cam_zoom = 1.0f;
     g_ui.selected_valid = false;
@@ -832,23 +1275,32 @@ void ui_init(void) {
     glGenBuffers(1, &g_ui.vbo);
     glBindVertexArray(g_ui.vao);
     glBindBuffer(GL_ARRAY_BUFFER, g_ui.vbo);
-    glBufferData(GL_ARRAY_BUFFER, 0, NULL, GL_STREAM_DRAW);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(UiVertex), (void *)offsetof(UiVertex, x));
     glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(UiVertex), (void *)offsetof(UiVertex, r));
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(UiVertex), (void *)offsetof(UiVertex, rgba));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(UiVertex), (void *)offsetof(UiVertex, u));
     glBindVertexArray(0);
 
-    g_ui.vert_capacity = 2048;
-    g_ui.vertices = (UiVertex *)malloc(g_ui.vert_capacity * sizeof(UiVertex));
+    // The VBO is specified on the first ui_render, sized to the mirror.
+    ui_reserve_vertices(2048);
     g_ui.active_slider = -1;
 }
 
 void ui_shutdown(void) {
-    free(g_ui.vertices);
+    mem_free(ALLOC_TAG_UI, g_ui.vertices);
+    mem_free(ALLOC_TAG_UI, g_ui.cmds);
+    mem_free(ALLOC_TAG_UI, g_ui.text);
     g_ui.vertices = NULL;
+    g_ui.cmds = NULL;
+    g_ui.text = NULL;
     g_ui.vert_capacity = 0;
-    g_ui.vert_count = 0;
+    g_ui.vert_used = 0;
+    g_ui.cmd_capacity = 0;
+    g_ui.text_capacity = 0;
+    g_ui.slot_count = 0;
+    g_ui.draw_ranges = 0;
     g_glyphs_ready = false;
     g_glyph_count = 0;
 
@@ -864,6 +1316,10 @@ void ui_shutdown(void) {
         glDeleteProgram(g_ui.program);
         g_ui.program = 0;
     }
+    if (g_ui.atlas_texture) {
+        glDeleteTextures(1, &g_ui.atlas_texture);
+        g_ui.atlas_texture = 0;
+    }
 }
 
 void ui_sync_to_params(const Params *baseline, Params *runtime) {
@@ -880,7 +1336,9 @@ void ui_sync_to_params(const Params *baseline, Params *runtime) {
 }
 
 static void ui_begin_frame(const Input *input) {
-    g_ui.vert_count = 0;
+    g_ui.cmd_count = 0;
+    g_ui.text_used = 0;
+    g_ui.widget_count = 0;
     g_ui.action_toggle_pause = false;
     g_ui.action_step = false;
     g_ui.action_apply = false;
@@ -904,11 +1362,10 @@ static void ui_begin_frame(const Input *input) {
     UiColor border = ui_color_rgba(0.2f, 0.2f, 0.2f, 1.0f);
     UiColor text = ui_color_rgba(1.0f, 1.0f, 1.0f, 1.0f);
 
-    ui_draw_hive_overlay();
-
     UiRect hamburger = {UI_PANEL_MARGIN, UI_PANEL_MARGIN, UI_HAMBURGER_SIZE, UI_HAMBURGER_SIZE};
     bool hamburger_hover = ui_rect_contains(&hamburger, g_ui.mouse_x, g_ui.mouse_y);
     UiColor burger_col = hamburger_hover ? accent : ui_color_rgba(0.9f, 0.9f, 0.9f, 1.0f);
+    ui_widget_begin(UI_W_HAMBURGER);
     ui_add_rect(hamburger.x, hamburger.y, hamburger.w, hamburger.h, ui_color_rgba(0.15f, 0.15f, 0.18f, 0.95f));
     float line_padding = 6.0f;
     for (int i = 0; i < 3; ++i) {
@@ -929,6 +1386,10 @@ static void ui_begin_frame(const Input *input) {
         g_ui.panel_scroll = 0.0f;
         g_ui.panel_content_height = 0.0f;
         ui_draw_selected_bee_panel();
+        ui_draw_memory_panel();
+        if (ui_draw_charts_panel(mouse_pressed)) {
+            g_ui.wants_mouse = true;
+        }
         return;
     }
 
@@ -965,10 +1426,12 @@ static void ui_begin_frame(const Input *input) {
     float content_width = UI_PANEL_WIDTH - 40.0f;
     float panel_max_x = panel_rect.x + UI_PANEL_WIDTH;
 
+    ui_widget_begin(UI_W_PANEL_FRAME);
     size_t panel_bg_start = ui_add_rect(panel_rect.x, panel_rect.y, UI_PANEL_WIDTH, view_height, panel_bg);
     size_t panel_border_start = ui_add_rect(panel_rect.x, panel_rect.y, UI_PANEL_WIDTH, view_height, border);
 
     float text_x = panel_rect.x + 20.0f;
+    ui_widget_begin(UI_W_SIM_HEADER);
     if (ui_range_intersects(cursor_y - scroll, UI_CHAR_HEIGHT, view_top, view_bottom)) {
         ui_draw_text(text_x, cursor_y - scroll, "SIM CONTROLS", text);
     }
@@ -1006,6 +1469,7 @@ static void ui_begin_frame(const Input *input) {
                                     view_top,
                                     view_bottom);
 
+    ui_widget_begin(UI_W_FORAGE_HEADER);
     if (ui_range_intersects(cursor_y - scroll, UI_CHAR_HEIGHT, view_top, view_bottom)) {
         ui_draw_text(text_x, cursor_y - scroll, "FORAGING", text);
     }
@@ -1056,6 +1520,7 @@ static void ui_begin_frame(const Input *input) {
         g_ui.runtime->motion_spawn_speed_std = 0.0f;
     }
 
+    ui_widget_begin(UI_W_SPAWN_MODE);
     if (ui_range_intersects(cursor_y - scroll, UI_CHAR_HEIGHT, view_top, view_bottom)) {
         ui_draw_text(text_x, cursor_y - scroll, "SPAWN MODE", text);
     }
@@ -1092,6 +1557,7 @@ static void ui_begin_frame(const Input *input) {
     }
     cursor_y += 40.0f;
 
+    ui_widget_begin(UI_W_BEE_COUNT);
     if (ui_range_intersects(cursor_y - scroll, UI_CHAR_HEIGHT, view_top, view_bottom)) {
         ui_draw_text(text_x, cursor_y - scroll, "BEE COUNT", text);
     }
@@ -1136,6 +1602,7 @@ static void ui_begin_frame(const Input *input) {
     panel_max_x = fmaxf(panel_max_x, text_x + 40.0f + ui_measure_text(bee_buf));
     cursor_y += 36.0f;
 
+    ui_widget_begin(UI_W_WORLD_SIZE);
     if (ui_range_intersects(cursor_y - scroll, UI_CHAR_HEIGHT, view_top, view_bottom)) {
         ui_draw_text(text_x, cursor_y - scroll, "WORLD SIZE", text);
     }
@@ -1209,6 +1676,7 @@ static void ui_begin_frame(const Input *input) {
     UiRect step_rect = {text_x + pause_rect.w + 10.0f, cursor_y - scroll, pause_rect.w, 28.0f};
     bool pause_visible = ui_range_intersects(pause_rect.y, pause_rect.h, view_top, view_bottom);
     bool step_visible = ui_range_intersects(step_rect.y, step_rect.h, view_top, view_bottom);
+    ui_widget_begin(UI_W_PAUSE_STEP);
     if (pause_visible) {
         ui_add_rect(pause_rect.x, pause_rect.y, pause_rect.w, pause_rect.h, accent);
     }
@@ -1233,6 +1701,7 @@ static void ui_begin_frame(const Input *input) {
     UiRect queen_rect = {text_x, cursor_y - scroll, content_width, 28.0f};
     bool queen_visible = ui_range_intersects(queen_rect.y, queen_rect.h, view_top, view_bottom);
     UiColor queen_button = ui_color_rgba(0.95f, 0.30f, 0.85f, 1.0f);
+    ui_widget_begin(UI_W_QUEEN);
     if (queen_visible) {
         ui_add_rect(queen_rect.x, queen_rect.y, queen_rect.w, queen_rect.h, queen_button);
     }
@@ -1279,6 +1748,7 @@ static void ui_begin_frame(const Input *input) {
     bool apply_visible = ui_range_intersects(apply_rect.y, apply_rect.h, view_top, view_bottom);
     bool reset_visible = ui_range_intersects(reset_rect.y, reset_rect.h, view_top, view_bottom);
     UiColor apply_color = g_ui.dirty ? accent : ui_color_rgba(0.3f, 0.3f, 0.35f, 1.0f);
+    ui_widget_begin(UI_W_APPLY_RESET);
     if (apply_visible) {
         ui_add_rect(apply_rect.x, apply_rect.y, apply_rect.w, apply_rect.h, apply_color);
     }
@@ -1328,6 +1798,10 @@ static void ui_begin_frame(const Input *input) {
     g_ui.panel_scroll = ui_clampf(g_ui.panel_scroll, 0.0f, max_scroll);
 
     ui_draw_selected_bee_panel();
+    ui_draw_memory_panel();
+    if (ui_draw_charts_panel(mouse_pressed)) {
+        g_ui.wants_mouse = true;
+    }
 
     if (g_ui.active_slider >= 0 && !mouse_down) {
         g_ui.active_slider = -1;
@@ -1342,7 +1816,10 @@ UiActions ui_update(const Input *input, bool sim_paused, float dt_sec) {
     g_ui.sim_paused = sim_paused;
 
     UiActions actions = {0};
+    TRACE_BEGIN("ui_build");
     ui_begin_frame(input);
+    ui_commit_widgets();
+    TRACE_END("ui_build");
 
     if (!g_ui.has_params || !g_ui.runtime) {
         return actions;
@@ -1369,12 +1846,15 @@ UiActions ui_update(const Input *input, bool sim_paused, float dt_sec) {
 }
 
 void ui_render(int framebuffer_width, int framebuffer_height) {
-    if (!g_ui.vertices || g_ui.vert_count == 0 || !g_ui.program) {
+    if (!g_ui.vertices || g_ui.draw_ranges == 0 || !g_ui.program || !g_ui.atlas_texture) {
         return;
     }
 
     glUseProgram(g_ui.program);
     glUniform2f(g_ui.resolution_uniform, (float)framebuffer_width, (float)framebuffer_height);
+    glUniform1i(g_ui.atlas_uniform, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, g_ui.atlas_texture);
 
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -1382,9 +1862,25 @@ void ui_render(int framebuffer_width, int framebuffer_height) {
 
     glBindVertexArray(g_ui.vao);
     glBindBuffer(GL_ARRAY_BUFFER, g_ui.vbo);
-    glBufferData(GL_ARRAY_BUFFER, g_ui.vert_count * sizeof(UiVertex), g_ui.vertices, GL_STREAM_DRAW);
-    glDrawArrays(GL_TRIANGLES, 0, (GLint)g_ui.vert_count);
+    bool respecified = g_ui.gpu_vertex_capacity != g_ui.vert_capacity;
+    if (respecified) {
+        // The mirror grew: respecify the VBO and resend every slot.
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(g_ui.vert_capacity * sizeof(UiVertex)), NULL,
+                     GL_DYNAMIC_DRAW);
+        g_ui.gpu_vertex_capacity = g_ui.vert_capacity;
+    }
+    for (size_t i = 0; i < g_ui.slot_count; ++i) {
+        UiWidgetSlot *slot = &g_ui.slots[i];
+        if ((slot->upload || respecified) && slot->vertex_count > 0) {
+            glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)(slot->first_vertex * sizeof(UiVertex)),
+                            (GLsizeiptr)(slot->vertex_count * sizeof(UiVertex)),
+                            g_ui.vertices + slot->first_vertex);
+        }
+        slot->upload = false;
+    }
+    glMultiDrawArrays(GL_TRIANGLES, g_ui.draw_first, g_ui.draw_count, (GLsizei)g_ui.draw_ranges);
     glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
 
     glDisable(GL_BLEND);
     glUseProgram(0);
@@ -0,0 +1,219 @@
+#include "util/alloc.h"
+
+#ifdef BEE_ALLOC_TRACKING
+
+#include <assert.h>
+
+#include "util/log.h"
+
+#define ALLOC_HEADER_BYTES 16u
+#define ALLOC_MAX_FRAME_WARNINGS 8u
+
+typedef struct AllocHeader {
+    uint64_t size;
+    uint32_t tag;
+    uint32_t offset;  // distance from the raw malloc block to the user pointer
+} AllocHeader;
+
+typedef struct AllocTracker {
+    AllocStats stats;
+    bool in_frame;
+    bool in_tick;
+    uint64_t frame_allocs;
+    uint64_t frame_bytes;
+    uint64_t frame_index;
+    unsigned frame_warnings;
+} AllocTracker;
+
+static AllocTracker g_alloc = {0};
+
+static AllocHeader *alloc_header(void *user) {
+    return (AllocHeader *)((unsigned char *)user - ALLOC_HEADER_BYTES);
+}
+
+static void alloc_note(AllocTag tag, uint64_t bytes) {
+    AllocTagStats *tag_stats = &g_alloc.stats.tags[tag];
+    tag_stats->alloc_count += 1;
+    tag_stats->live_bytes += bytes;
+    if (tag_stats->live_bytes > tag_stats->peak_bytes) {
+        tag_stats->peak_bytes = tag_stats->live_bytes;
+    }
+    if (g_alloc.in_frame) {
+        g_alloc.frame_allocs += 1;
+        g_alloc.frame_bytes += bytes;
+    }
+    if (g_alloc.in_tick) {
+        g_alloc.stats.tick_allocs += 1;
+        g_alloc.stats.tick_bytes += bytes;
+        LOG_ERROR("alloc: %llu bytes (%s) allocated inside sim_tick",
+                  (unsigned long long)bytes, alloc_tag_name(tag));
+        assert(!"allocation inside sim_tick");
+    }
+}
+
+static void alloc_release(AllocTag tag, uint64_t bytes) {
+    AllocTagStats *tag_stats = &g_alloc.stats.tags[tag];
+    tag_stats->live_bytes = tag_stats->live_bytes >= bytes ? tag_stats->live_bytes - bytes : 0;
+}
+
+static void *alloc_wrap(void *raw, AllocTag tag, size_t bytes, size_t offset) {
+    unsigned char *user = (unsigned char *)raw + offset;
+    AllocHeader *header = alloc_header(user);
+    header->size = bytes;
+    header->tag = (uint32_t)tag;
+    header->offset = (uint32_t)offset;
+    alloc_note(tag, bytes);
+    return user;
+}
+
+void *mem_alloc(AllocTag tag, size_t bytes) {
+    if (bytes > SIZE_MAX - ALLOC_HEADER_BYTES) {
+        return NULL;
+    }
+    void *raw = malloc(bytes + ALLOC_HEADER_BYTES);
+    if (!raw) {
+        return NULL;
+    }
+    return alloc_wrap(raw, tag, bytes, ALLOC_HEADER_BYTES);
+}
+
+void *mem_calloc(AllocTag tag, size_t count, size_t size) {
+    if (size != 0 && count > (SIZE_MAX - ALLOC_HEADER_BYTES) / size) {
+        return NULL;
+    }
+    size_t bytes = count * size;
+    void *raw = calloc(1, bytes + ALLOC_HEADER_BYTES);
+    if (!raw) {
+        return NULL;
+    }
+    return alloc_wrap(raw, tag, bytes, ALLOC_HEADER_BYTES);
+}
+
+void *mem_realloc(AllocTag tag, void *ptr, size_t bytes) {
+    if (!ptr) {
+        return mem_alloc(tag, bytes);
+    }
+    if (bytes > SIZE_MAX - ALLOC_HEADER_BYTES) {
+        return NULL;
+    }
+    AllocHeader *header = alloc_header(ptr);
+    assert(header->offset == ALLOC_HEADER_BYTES && "mem_realloc on an aligned block");
+    AllocTag old_tag = (AllocTag)header->tag;
+    uint64_t old_size = header->size;
+    void *raw = realloc(header, bytes + ALLOC_HEADER_BYTES);
+    if (!raw) {
+        return NULL;
+    }
+    alloc_release(old_tag, old_size);
+    return alloc_wrap(raw, tag, bytes, ALLOC_HEADER_BYTES);
+}
+
+void mem_free(AllocTag tag, void *ptr) {
+    (void)tag;
+    if (!ptr) {
+        return;
+    }
+    AllocHeader *header = alloc_header(ptr);
+    alloc_release((AllocTag)header->tag, header->size);
+    free((unsigned char *)ptr - header->offset);
+}
+
+void *mem_alloc_aligned(AllocTag tag, size_t bytes, size_t align) {
+    if (bytes == 0) {
+        return NULL;
+    }
+    if (align < ALLOC_HEADER_BYTES) {
+        align = ALLOC_HEADER_BYTES;
+    }
+    if (bytes > SIZE_MAX - align - ALLOC_HEADER_BYTES) {
+        return NULL;
+    }
+    unsigned char *raw = (unsigned char *)malloc(bytes + align + ALLOC_HEADER_BYTES);
+    if (!raw) {
+        return NULL;
+    }
+    uintptr_t first = (uintptr_t)raw + ALLOC_HEADER_BYTES;
+    uintptr_t aligned = (first + (align - 1u)) & ~(uintptr_t)(align - 1u);
+    return alloc_wrap(raw, tag, bytes, (size_t)(aligned - (uintptr_t)raw));
+}
+
+void mem_free_aligned(AllocTag tag, void *ptr) {
+    mem_free(tag, ptr);
+}
+
+void alloc_frame_begin(void) {
+    g_alloc.in_frame = true;
+    g_alloc.frame_allocs = 0;
+    g_alloc.frame_bytes = 0;
+}
+
+void alloc_frame_end(void) {
+    if (!g_alloc.in_frame) {
+        return;
+    }
+    g_alloc.in_frame = false;
+    AllocStats *stats = &g_alloc.stats;
+    stats->frame_allocs = g_alloc.frame_allocs;
+    stats->frame_bytes = g_alloc.frame_bytes;
+    if (g_alloc.frame_allocs > stats->peak_frame_allocs) {
+        stats->peak_frame_allocs = g_alloc.frame_allocs;
+    }
+    if (g_alloc.frame_bytes > stats->peak_frame_bytes) {
+        stats->peak_frame_bytes = g_alloc.frame_bytes;
+    }
+    if (g_alloc.frame_allocs > 0) {
+        stats->frames_with_allocs += 1;
+        if (g_alloc.frame_warnings < ALLOC_MAX_FRAME_WARNINGS) {
+            g_alloc.frame_warnings += 1;
+            LOG_WARN("alloc: frame %llu made %llu allocations (%llu bytes)%s",
+                     (unsigned long long)g_alloc.frame_index,
+                     (unsigned long long)g_alloc.frame_allocs,
+                     (unsigned long long)g_alloc.frame_bytes,
+                     g_alloc.frame_warnings == ALLOC_MAX_FRAME_WARNINGS
+                         ? "; further frames counted silently"
+                         : "");
+        }
+    }
+    g_alloc.frame_index += 1;
+}
+
+void alloc_tick_begin(void) {
+    g_alloc.in_tick = true;
+}
+
+void alloc_tick_end(void) {
+    g_alloc.in_tick = false;
+}
+
+bool alloc_get_stats(AllocStats *out_stats) {
+    if (!out_stats) {
+        return false;
+    }
+    *out_stats = g_alloc.stats;
+    return true;
+}
+
+void alloc_report(void) {
+    const AllocStats *stats = &g_alloc.stats;
+    for (int tag = 0; tag < ALLOC_TAG_COUNT; ++tag) {
+        const AllocTagStats *tag_stats = &stats->tags[tag];
+        LOG_INFO("alloc: %-8s live=%llu peak=%llu allocs=%llu",
+                 alloc_tag_name((AllocTag)tag),
+                 (unsigned long long)tag_stats->live_bytes,
+                 (unsigned long long)tag_stats->peak_bytes,
+                 (unsigned long long)tag_stats->alloc_count);
+    }
+    LOG_INFO("alloc: frames=%llu with_allocs=%llu peak_frame_allocs=%llu peak_frame_bytes=%llu "
+             "tick_allocs=%llu",
+             (unsigned long long)g_alloc.frame_index,
+             (unsigned long long)stats->frames_with_allocs,
+             (unsigned long long)stats->peak_frame_allocs,
+             (unsigned long long)stats->peak_frame_bytes,
+             (unsigned long long)stats->tick_allocs);
+}
+
+#else
+
+typedef int alloc_tracking_disabled;  // keep the translation unit non-empty
+
+#endif  // BEE_ALLOC_TRACKING
@@ -0,0 +1,97 @@
+#include "util/clock.h"
+
+#include "util/atomic.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+// Waitable timers fire within ~0.5 ms; plain Sleep only to the scheduler
+// tick (1 ms once SDL has raised the timer resolution).
+#define CLOCK_SPIN_NS_TIMER UINT64_C(500000)
+#define CLOCK_SPIN_NS_SLEEP UINT64_C(2000000)
+#else
+#include <errno.h>
+#include <time.h>
+// Covers the default 50 us timer slack plus wakeup latency.
+#define CLOCK_SPIN_NS UINT64_C(200000)
+#endif
+
+uint64_t clock_now_ns(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER frequency = {0};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    uint64_t seconds = (uint64_t)(counter.QuadPart / frequency.QuadPart);
+    uint64_t remainder = (uint64_t)(counter.QuadPart % frequency.QuadPart);
+    return seconds * UINT64_C(1000000000) +
+           remainder * UINT64_C(1000000000) / (uint64_t)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * UINT64_C(1000000000) + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+#ifdef _WIN32
+static HANDLE clock_sleep_timer(void) {
+    static HANDLE timer = NULL;
+    static bool attempted = false;
+    if (!attempted) {
+        attempted = true;
+        timer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
+                                       TIMER_ALL_ACCESS);
+    }
+    return timer;
+}
+#endif
+
+void clock_sleep_until_ns(uint64_t deadline_ns) {
+    uint64_t now = clock_now_ns();
+    if (now >= deadline_ns) {
+        return;
+    }
+#ifdef _WIN32
+    HANDLE timer = clock_sleep_timer();
+    uint64_t spin_ns = timer ? CLOCK_SPIN_NS_TIMER : CLOCK_SPIN_NS_SLEEP;
+    if (deadline_ns - now > spin_ns) {
+        uint64_t sleep_ns = deadline_ns - now - spin_ns;
+        if (timer) {
+            LARGE_INTEGER due;
+            due.QuadPart = -(LONGLONG)(sleep_ns / 100u);  // relative, 100 ns units
+            if (SetWaitableTimer(timer, &due, 0, NULL, NULL, FALSE)) {
+                WaitForSingleObject(timer, INFINITE);
+            }
+        } else {
+            Sleep((DWORD)(sleep_ns / UINT64_C(1000000)));
+        }
+    }
+#else
+    if (deadline_ns - now > CLOCK_SPIN_NS) {
+#if defined(__APPLE__)
+        // No clock_nanosleep; a relative sleep is close enough before the spin.
+        uint64_t sleep_ns = deadline_ns - now - CLOCK_SPIN_NS;
+        struct timespec ts;
+        ts.tv_sec = (time_t)(sleep_ns / UINT64_C(1000000000));
+        ts.tv_nsec = (long)(sleep_ns % UINT64_C(1000000000));
+        while (nanosleep(&ts, &ts) == -1 && errno == EINTR) {
+        }
+#else
+        uint64_t wake_ns = deadline_ns - CLOCK_SPIN_NS;
+        struct timespec ts;
+        ts.tv_sec = (time_t)(wake_ns / UINT64_C(1000000000));
+        ts.tv_nsec = (long)(wake_ns % UINT64_C(1000000000));
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+        }
+#endif
+    }
+#endif
+    while (clock_now_ns() < deadline_ns) {
+        atomic_cpu_relax();
+    }
+}
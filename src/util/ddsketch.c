@@ -0,0 +1,161 @@
+#include "util/ddsketch.h"
+
+#include <math.h>
+#include <string.h>
+
+void ddsketch_init(DDSketch *sketch, double relative_accuracy) {
+    if (!sketch) {
+        return;
+    }
+    if (!(relative_accuracy > 0.0 && relative_accuracy < 1.0)) {
+        relative_accuracy = DDSKETCH_DEFAULT_ACCURACY;
+    }
+    memset(sketch, 0, sizeof(*sketch));
+    sketch->gamma = (1.0 + relative_accuracy) / (1.0 - relative_accuracy);
+    sketch->inv_log_gamma = 1.0 / log(sketch->gamma);
+}
+
+static int32_t ddsketch_index(const DDSketch *sketch, double value) {
+    return (int32_t)ceil(log(value) * sketch->inv_log_gamma);
+}
+
+// Moves the bin window so that `index` is representable. Growing upward
+// collapses the lowest bins into the new bins[0]; growing downward only
+// happens while the occupied range still fits, otherwise the caller clamps.
+static void ddsketch_shift(DDSketch *sketch, int32_t new_offset) {
+    int32_t shift = new_offset - sketch->bin_offset;
+    if (shift == 0) {
+        return;
+    }
+    if (shift > 0) {
+        if (shift >= DDSKETCH_MAX_BINS) {
+            uint64_t total = 0;
+            for (int i = 0; i < DDSKETCH_MAX_BINS; ++i) {
+                total += sketch->bins[i];
+            }
+            memset(sketch->bins, 0, sizeof(sketch->bins));
+            sketch->bins[0] = (uint32_t)(total > UINT32_MAX ? UINT32_MAX : total);
+        } else {
+            uint64_t folded = 0;
+            for (int32_t i = 0; i <= shift; ++i) {
+                folded += sketch->bins[i];
+            }
+            memmove(&sketch->bins[0], &sketch->bins[shift],
+                    sizeof(uint32_t) * (size_t)(DDSKETCH_MAX_BINS - shift));
+            memset(&sketch->bins[DDSKETCH_MAX_BINS - shift], 0, sizeof(uint32_t) * (size_t)shift);
+            sketch->bins[0] = (uint32_t)(folded > UINT32_MAX ? UINT32_MAX : folded);
+        }
+    } else {
+        int32_t down = -shift;
+        memmove(&sketch->bins[down], &sketch->bins[0],
+                sizeof(uint32_t) * (size_t)(DDSKETCH_MAX_BINS - down));
+        memset(&sketch->bins[0], 0, sizeof(uint32_t) * (size_t)down);
+    }
+    sketch->bin_offset = new_offset;
+}
+
+static int32_t ddsketch_highest_used(const DDSketch *sketch) {
+    for (int32_t i = DDSKETCH_MAX_BINS - 1; i >= 0; --i) {
+        if (sketch->bins[i] != 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void ddsketch_add_index(DDSketch *sketch, int32_t index, uint32_t weight) {
+    uint64_t positive = sketch->count - sketch->zero_count;
+    if (positive == 0) {
+        // First positive sample: centre the window on it.
+        sketch->bin_offset = index - DDSKETCH_MAX_BINS / 2;
+    } else if (index >= sketch->bin_offset + DDSKETCH_MAX_BINS) {
+        ddsketch_shift(sketch, index - DDSKETCH_MAX_BINS + 1);
+        sketch->collapses += 1;
+    } else if (index < sketch->bin_offset) {
+        int32_t highest = ddsketch_highest_used(sketch);
+        int32_t needed = sketch->bin_offset - index;
+        if (highest < 0 || highest + needed < DDSKETCH_MAX_BINS) {
+            ddsketch_shift(sketch, index);
+        } else {
+            index = sketch->bin_offset;
+            sketch->collapses += 1;
+        }
+    }
+    uint32_t *bin = &sketch->bins[index - sketch->bin_offset];
+    *bin = (*bin > UINT32_MAX - weight) ? UINT32_MAX : *bin + weight;
+}
+
+void ddsketch_add(DDSketch *sketch, double value) {
+    if (!sketch || sketch->gamma <= 1.0 || value != value) {
+        return;
+    }
+    if (sketch->count == 0) {
+        sketch->min = value;
+        sketch->max = value;
+    } else {
+        if (value < sketch->min) sketch->min = value;
+        if (value > sketch->max) sketch->max = value;
+    }
+    sketch->sum += value;
+    if (value <= DDSKETCH_MIN_VALUE) {
+        sketch->zero_count += 1;
+        sketch->count += 1;
+        return;
+    }
+    ddsketch_add_index(sketch, ddsketch_index(sketch, value), 1u);
+    sketch->count += 1;
+}
+
+double ddsketch_quantile(const DDSketch *sketch, double q) {
+    if (!sketch || sketch->count == 0) {
+        return 0.0;
+    }
+    if (q <= 0.0) {
+        return sketch->min;
+    }
+    if (q >= 1.0) {
+        return sketch->max;
+    }
+    double rank = q * (double)(sketch->count - 1);
+    double seen = (double)sketch->zero_count;
+    double value = sketch->max;
+    if (rank < seen) {
+        value = 0.0;
+    } else {
+        for (int32_t i = 0; i < DDSKETCH_MAX_BINS; ++i) {
+            seen += (double)sketch->bins[i];
+            if (seen > rank) {
+                // Midpoint of (gamma^(k-1), gamma^k] in the relative sense.
+                int32_t k = sketch->bin_offset + i;
+                value = 2.0 * pow(sketch->gamma, (double)k) / (1.0 + sketch->gamma);
+                break;
+            }
+        }
+    }
+    if (value < sketch->min) value = sketch->min;
+    if (value > sketch->max) value = sketch->max;
+    return value;
+}
+
+void ddsketch_merge(DDSketch *dst, const DDSketch *src) {
+    if (!dst || !src || src->count == 0) {
+        return;
+    }
+    if (dst->count == 0) {
+        dst->min = src->min;
+        dst->max = src->max;
+    } else {
+        if (src->min < dst->min) dst->min = src->min;
+        if (src->max > dst->max) dst->max = src->max;
+    }
+    dst->sum += src->sum;
+    dst->zero_count += src->zero_count;
+    dst->count += src->zero_count;
+    dst->collapses += src->collapses;
+    for (int32_t i = 0; i < DDSKETCH_MAX_BINS; ++i) {
+        if (src->bins[i] != 0) {
+            ddsketch_add_index(dst, src->bin_offset + i, src->bins[i]);
+            dst->count += src->bins[i];
+        }
+    }
+}
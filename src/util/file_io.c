@@ -0,0 +1,101 @@
+#include "util/file_io.h"
+
+#include <errno.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#define FILE_IO_BATCH 64
+
+#ifdef _WIN32
+
+bool file_write_slices(const char *path, const FileSlice *slices, size_t count) {
+    if (!path || (!slices && count > 0)) {
+        return false;
+    }
+    int fd = _open(path, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = true;
+    for (size_t i = 0; i < count && ok; ++i) {
+        const char *cursor = (const char *)slices[i].data;
+        size_t remaining = slices[i].size;
+        while (remaining > 0) {
+            unsigned int chunk = remaining > (1u << 30) ? (1u << 30) : (unsigned int)remaining;
+            int written = _write(fd, cursor, chunk);
+            if (written <= 0) {
+                ok = false;
+                break;
+            }
+            cursor += written;
+            remaining -= (size_t)written;
+        }
+    }
+    if (_close(fd) != 0) {
+        ok = false;
+    }
+    return ok;
+}
+
+#else
+
+bool file_write_slices(const char *path, const FileSlice *slices, size_t count) {
+    if (!path || (!slices && count > 0)) {
+        return false;
+    }
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    bool ok = true;
+    struct iovec iov[FILE_IO_BATCH];
+    size_t next = 0;
+    while (ok && next < count) {
+        int batch = 0;
+        while (batch < FILE_IO_BATCH && next < count) {
+            iov[batch].iov_base = (void *)(uintptr_t)slices[next].data;
+            iov[batch].iov_len = slices[next].size;
+            ++batch;
+            ++next;
+        }
+        struct iovec *cursor = iov;
+        int remaining = batch;
+        while (remaining > 0) {
+            ssize_t written = writev(fd, cursor, remaining);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                ok = false;
+                break;
+            }
+            size_t advance = (size_t)written;
+            while (remaining > 0 && advance >= cursor->iov_len) {
+                advance -= cursor->iov_len;
+                ++cursor;
+                --remaining;
+            }
+            if (remaining > 0) {
+                cursor->iov_base = (char *)cursor->iov_base + advance;
+                cursor->iov_len -= advance;
+            }
+        }
+    }
+
+    if (close(fd) != 0) {
+        ok = false;
+    }
+    return ok;
+}
+
+#endif
@@ -0,0 +1,432 @@
+#include "util/image_write.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "util/alloc.h"
+#include "util/file_io.h"
+#include "util/log.h"
+
+#define DEFLATE_WINDOW 32768
+#define DEFLATE_MIN_MATCH 3
+#define DEFLATE_MAX_MATCH 258
+#define DEFLATE_HASH_BITS 15
+
+static const uint16_t kLengthBase[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258,
+};
+static const uint8_t kLengthExtra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0,
+};
+static const uint16_t kDistBase[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577,
+};
+static const uint8_t kDistExtra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13,
+};
+
+typedef struct BitWriter {
+    uint8_t *out;
+    size_t len;
+    uint64_t bits;
+    int bit_count;
+} BitWriter;
+
+static void bits_put(BitWriter *bw, uint32_t value, int count) {
+    bw->bits |= (uint64_t)value << bw->bit_count;
+    bw->bit_count += count;
+    while (bw->bit_count >= 8) {
+        bw->out[bw->len++] = (uint8_t)(bw->bits & 0xFFu);
+        bw->bits >>= 8;
+        bw->bit_count -= 8;
+    }
+}
+
+static void bits_flush(BitWriter *bw) {
+    if (bw->bit_count > 0) {
+        bw->out[bw->len++] = (uint8_t)(bw->bits & 0xFFu);
+        bw->bits = 0;
+        bw->bit_count = 0;
+    }
+}
+
+// Huffman codes are defined MSB-first but deflate packs bits LSB-first.
+static void bits_put_code(BitWriter *bw, uint32_t code, int count) {
+    uint32_t reversed = 0;
+    for (int i = 0; i < count; ++i) {
+        reversed = (reversed << 1) | ((code >> i) & 1u);
+    }
+    bits_put(bw, reversed, count);
+}
+
+static void deflate_put_symbol(BitWriter *bw, uint32_t symbol) {
+    if (symbol < 144) {
+        bits_put_code(bw, 0x30u + symbol, 8);
+    } else if (symbol < 256) {
+        bits_put_code(bw, 0x190u + (symbol - 144u), 9);
+    } else if (symbol < 280) {
+        bits_put_code(bw, symbol - 256u, 7);
+    } else {
+        bits_put_code(bw, 0xC0u + (symbol - 280u), 8);
+    }
+}
+
+static void deflate_put_match(BitWriter *bw, size_t length, size_t distance) {
+    int li = 28;
+    while (kLengthBase[li] > length) {
+        --li;
+    }
+    deflate_put_symbol(bw, 257u + (uint32_t)li);
+    if (kLengthExtra[li]) {
+        bits_put(bw, (uint32_t)(length - kLengthBase[li]), kLengthExtra[li]);
+    }
+    int di = 29;
+    while (kDistBase[di] > distance) {
+        --di;
+    }
+    bits_put_code(bw, (uint32_t)di, 5);
+    if (kDistExtra[di]) {
+        bits_put(bw, (uint32_t)(distance - kDistBase[di]), kDistExtra[di]);
+    }
+}
+
+static inline uint32_t deflate_hash(const uint8_t *p) {
+    uint32_t v = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | (uint32_t)p[2];
+    return (v * 2654435761u) >> (32 - DEFLATE_HASH_BITS);
+}
+
+// Single fixed-Huffman block. out must hold deflate_bound(n) bytes.
+static size_t deflate_fixed(const uint8_t *data, size_t n, uint8_t *out, int32_t *head) {
+    BitWriter bw = {out, 0, 0, 0};
+    bits_put(&bw, 1u, 1);  // BFINAL
+    bits_put(&bw, 1u, 2);  // BTYPE = fixed Huffman
+    for (size_t h = 0; h < ((size_t)1 << DEFLATE_HASH_BITS); ++h) {
+        head[h] = -1;
+    }
+
+    size_t i = 0;
+    while (i < n) {
+        size_t best_len = 0;
+        size_t best_dist = 0;
+        if (i + DEFLATE_MIN_MATCH <= n) {
+            uint32_t h = deflate_hash(data + i);
+            int32_t candidate = head[h];
+            head[h] = (int32_t)i;
+            if (candidate >= 0 && i - (size_t)candidate <= DEFLATE_WINDOW) {
+                size_t limit = n - i < DEFLATE_MAX_MATCH ? n - i : DEFLATE_MAX_MATCH;
+                const uint8_t *a = data + candidate;
+                const uint8_t *b = data + i;
+                size_t len = 0;
+                while (len < limit && a[len] == b[len]) {
+                    ++len;
+                }
+                if (len >= DEFLATE_MIN_MATCH) {
+                    best_len = len;
+                    best_dist = i - (size_t)candidate;
+                }
+            }
+        }
+        if (best_len) {
+            deflate_put_match(&bw, best_len, best_dist);
+            for (size_t k = 1; k < best_len && i + k + DEFLATE_MIN_MATCH <= n; ++k) {
+                head[deflate_hash(data + i + k)] = (int32_t)(i + k);
+            }
+            i += best_len;
+        } else {
+            deflate_put_symbol(&bw, data[i]);
+            ++i;
+        }
+    }
+    deflate_put_symbol(&bw, 256u);
+    bits_flush(&bw);
+    return bw.len;
+}
+
+static size_t deflate_bound(size_t n) {
+    // Worst case is all 9-bit literals plus the block header and end code.
+    return n + n / 8u + 16u;
+}
+
+static uint32_t g_crc_table[256];
+static bool g_crc_table_ready = false;  // built on first use or by image_scratch_reserve
+
+static void crc32_table_init(void) {
+    if (g_crc_table_ready) {
+        return;
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; ++k) {
+            c = (c & 1u) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        g_crc_table[i] = c;
+    }
+    g_crc_table_ready = true;
+}
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t n) {
+    crc32_table_init();
+    crc = ~crc;
+    for (size_t i = 0; i < n; ++i) {
+        crc = g_crc_table[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static uint32_t adler32(const uint8_t *data, size_t n) {
+    uint32_t a = 1;
+    uint32_t b = 0;
+    while (n > 0) {
+        size_t block = n < 5552u ? n : 5552u;
+        n -= block;
+        for (size_t i = 0; i < block; ++i) {
+            a += data[i];
+            b += a;
+        }
+        data += block;
+        a %= 65521u;
+        b %= 65521u;
+    }
+    return (b << 16) | a;
+}
+
+static void put_be32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static uint8_t paeth(uint8_t a, uint8_t b, uint8_t c) {
+    int p = (int)a + (int)b - (int)c;
+    int pa = abs(p - (int)a);
+    int pb = abs(p - (int)b);
+    int pc = abs(p - (int)c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+// Writes filter byte + filtered row into out; prev is NULL for the first row.
+static void png_filter_row(const uint8_t *row, const uint8_t *prev, size_t stride, uint8_t *scratch,
+                           uint8_t *out) {
+    const size_t bpp = 3;
+    uint8_t *cand[4] = {scratch, scratch + stride, scratch + stride * 2u, scratch + stride * 3u};
+    uint64_t best_cost = UINT64_MAX;
+    int best = 0;
+    for (int f = 0; f < 4; ++f) {
+        uint8_t *dst = cand[f];
+        uint64_t cost = 0;
+        for (size_t x = 0; x < stride; ++x) {
+            uint8_t left = x >= bpp ? row[x - bpp] : 0;
+            uint8_t up = prev ? prev[x] : 0;
+            uint8_t up_left = (prev && x >= bpp) ? prev[x - bpp] : 0;
+            uint8_t pred = 0;
+            switch (f) {
+                case 1: pred = left; break;
+                case 2: pred = up; break;
+                case 3: pred = paeth(left, up, up_left); break;
+                default: break;
+            }
+            uint8_t v = (uint8_t)(row[x] - pred);
+            dst[x] = v;
+            cost += (uint64_t)abs((int)(int8_t)v);
+        }
+        if (cost < best_cost) {
+            best_cost = cost;
+            best = f;
+        }
+    }
+    static const uint8_t kFilterType[4] = {0, 1, 2, 4};
+    out[0] = kFilterType[best];
+    memcpy(out + 1, cand[best], stride);
+}
+
+static void rgba_to_rgb(const uint8_t *rgba, size_t pixels, uint8_t *rgb) {
+    for (size_t i = 0; i < pixels; ++i) {
+        rgb[i * 3 + 0] = rgba[i * 4 + 0];
+        rgb[i * 3 + 1] = rgba[i * 4 + 1];
+        rgb[i * 3 + 2] = rgba[i * 4 + 2];
+    }
+}
+
+static bool image_scratch_fits(const ImageScratch *scratch, int width, int height) {
+    return scratch && width <= scratch->width && height <= scratch->height;
+}
+
+bool image_scratch_reserve(ImageScratch *scratch, int width, int height) {
+    if (!scratch || width <= 0 || height <= 0) {
+        LOG_ERROR("image: invalid scratch size %dx%d", width, height);
+        return false;
+    }
+    crc32_table_init();
+    if (image_scratch_fits(scratch, width, height)) {
+        return true;
+    }
+    int w = width > scratch->width ? width : scratch->width;
+    int h = height > scratch->height ? height : scratch->height;
+    const size_t stride = (size_t)w * 3u;
+    const size_t raw_size = (stride + 1u) * (size_t)h;
+    uint8_t *rgb = (uint8_t *)mem_realloc(ALLOC_TAG_IO, scratch->rgb, stride * (size_t)h);
+    if (rgb) {
+        scratch->rgb = rgb;
+    }
+    uint8_t *raw = (uint8_t *)mem_realloc(ALLOC_TAG_IO, scratch->raw, raw_size);
+    if (raw) {
+        scratch->raw = raw;
+    }
+    uint8_t *rows = (uint8_t *)mem_realloc(ALLOC_TAG_IO, scratch->rows, stride * 4u);
+    if (rows) {
+        scratch->rows = rows;
+    }
+    uint8_t *zlib = (uint8_t *)mem_realloc(ALLOC_TAG_IO, scratch->zlib, deflate_bound(raw_size) + 6u);
+    if (zlib) {
+        scratch->zlib = zlib;
+    }
+    if (!scratch->head) {
+        scratch->head = (int32_t *)mem_alloc(ALLOC_TAG_IO, sizeof(int32_t) << DEFLATE_HASH_BITS);
+    }
+    if (!rgb || !raw || !rows || !zlib || !scratch->head) {
+        LOG_ERROR("image: failed to allocate scratch for %dx%d (%zu raw bytes)", w, h, raw_size);
+        return false;
+    }
+    scratch->width = w;
+    scratch->height = h;
+    return true;
+}
+
+void image_scratch_free(ImageScratch *scratch) {
+    if (!scratch) {
+        return;
+    }
+    mem_free(ALLOC_TAG_IO, scratch->head);
+    mem_free(ALLOC_TAG_IO, scratch->zlib);
+    mem_free(ALLOC_TAG_IO, scratch->rows);
+    mem_free(ALLOC_TAG_IO, scratch->raw);
+    mem_free(ALLOC_TAG_IO, scratch->rgb);
+    memset(scratch, 0, sizeof(*scratch));
+}
+
+size_t image_scratch_bytes(const ImageScratch *scratch) {
+    if (!scratch || scratch->width <= 0 || scratch->height <= 0) {
+        return 0;
+    }
+    const size_t stride = (size_t)scratch->width * 3u;
+    const size_t raw_size = (stride + 1u) * (size_t)scratch->height;
+    return stride * (size_t)scratch->height + raw_size + stride * 4u + deflate_bound(raw_size) + 6u +
+           (sizeof(int32_t) << DEFLATE_HASH_BITS);
+}
+
+bool image_write_ppm_scratch(const char *path, const uint8_t *rgba, int width, int height,
+                             ImageScratch *scratch) {
+    if (!path || !rgba || width <= 0 || height <= 0 || !image_scratch_fits(scratch, width, height)) {
+        LOG_ERROR("image: invalid ppm arguments");
+        return false;
+    }
+    size_t pixels = (size_t)width * (size_t)height;
+    rgba_to_rgb(rgba, pixels, scratch->rgb);
+    char header[64];
+    int header_len = snprintf(header, sizeof header, "P6\n%d %d\n255\n", width, height);
+    FileSlice slices[2] = {
+        {header, (size_t)header_len},
+        {scratch->rgb, pixels * 3u},
+    };
+    bool ok = file_write_slices(path, slices, 2);
+    if (!ok) {
+        LOG_ERROR("image: failed to write '%s'", path);
+    }
+    return ok;
+}
+
+bool image_write_ppm(const char *path, const uint8_t *rgba, int width, int height) {
+    if (!path || !rgba || width <= 0 || height <= 0) {
+        LOG_ERROR("image: invalid ppm arguments");
+        return false;
+    }
+    ImageScratch scratch = {0};
+    bool ok = image_scratch_reserve(&scratch, width, height) &&
+              image_write_ppm_scratch(path, rgba, width, height, &scratch);
+    image_scratch_free(&scratch);
+    return ok;
+}
+
+static bool png_encode_write(const char *path, const uint8_t *rgb, int width, int height,
+                             uint8_t *raw, uint8_t *scratch, uint8_t *zlib, int32_t *head) {
+    const size_t stride = (size_t)width * 3u;
+    const size_t raw_size = (stride + 1u) * (size_t)height;
+    for (int y = 0; y < height; ++y) {
+        const uint8_t *row = rgb + (size_t)y * stride;
+        const uint8_t *prev = y > 0 ? row - stride : NULL;
+        png_filter_row(row, prev, stride, scratch, raw + (size_t)y * (stride + 1u));
+    }
+
+    zlib[0] = 0x78;  // deflate, 32 KiB window
+    zlib[1] = 0x01;  // fastest compression level, no dictionary
+    size_t zlib_len = 2u + deflate_fixed(raw, raw_size, zlib + 2, head);
+    put_be32(zlib + zlib_len, adler32(raw, raw_size));
+    zlib_len += 4u;
+
+    uint8_t header[8 + 25 + 8];
+    static const uint8_t kSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    memcpy(header, kSignature, 8);
+    uint8_t *ihdr = header + 8;
+    put_be32(ihdr, 13u);
+    memcpy(ihdr + 4, "IHDR", 4);
+    put_be32(ihdr + 8, (uint32_t)width);
+    put_be32(ihdr + 12, (uint32_t)height);
+    ihdr[16] = 8;  // bit depth
+    ihdr[17] = 2;  // truecolor
+    ihdr[18] = 0;
+    ihdr[19] = 0;
+    ihdr[20] = 0;
+    put_be32(ihdr + 21, crc32_update(0, ihdr + 4, 17));
+    uint8_t *idat = ihdr + 25;
+    put_be32(idat, (uint32_t)zlib_len);
+    memcpy(idat + 4, "IDAT", 4);
+
+    uint8_t trailer[4 + 12];
+    put_be32(trailer, crc32_update(crc32_update(0, idat + 4, 4), zlib, zlib_len));
+    put_be32(trailer + 4, 0u);
+    memcpy(trailer + 8, "IEND", 4);
+    put_be32(trailer + 12, crc32_update(0, trailer + 8, 4));
+
+    FileSlice slices[3] = {
+        {header, sizeof header},
+        {zlib, zlib_len},
+        {trailer, sizeof trailer},
+    };
+    return file_write_slices(path, slices, 3);
+}
+
+bool image_write_png_scratch(const char *path, const uint8_t *rgba, int width, int height,
+                             ImageScratch *scratch) {
+    if (!path || !rgba || width <= 0 || height <= 0 || !image_scratch_fits(scratch, width, height)) {
+        LOG_ERROR("image: invalid png arguments");
+        return false;
+    }
+    rgba_to_rgb(rgba, (size_t)width * (size_t)height, scratch->rgb);
+    bool ok = png_encode_write(path, scratch->rgb, width, height, scratch->raw, scratch->rows,
+                               scratch->zlib, scratch->head);
+    if (!ok) {
+        LOG_ERROR("image: failed to write '%s'", path);
+    }
+    return ok;
+}
+
+bool image_write_png(const char *path, const uint8_t *rgba, int width, int height) {
+    if (!path || !rgba || width <= 0 || height <= 0) {
+        LOG_ERROR("image: invalid png arguments");
+        return false;
+    }
+    ImageScratch scratch = {0};
+    bool ok = image_scratch_reserve(&scratch, width, height) &&
+              image_write_png_scratch(path, rgba, width, height, &scratch);
+    image_scratch_free(&scratch);
+    return ok;
+}
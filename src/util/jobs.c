@@ -0,0 +1,362 @@
+#include "util/jobs.h"
+
+#include <string.h>
+
+#include "util/alloc.h"
+#include "util/log.h"
+#include "util/thread.h"
+#include "util/trace.h"
+
+#define JOBS_CACHE_LINE 64
+#define JOBS_SPIN_ROUNDS 64
+#define JOBS_SPLITS_PER_THREAD 8
+
+typedef struct Job {
+    JobFn fn;
+    void *user;
+    size_t begin;
+    size_t end;
+    size_t grain;
+    JobCounter *counter;
+} Job;
+
+// top is written by thieves, bottom only by the owner; keep them on separate
+// cache lines so pushes do not bounce the line thieves are spinning on.
+typedef struct JobWorker {
+    volatile int64_t top;
+    char pad_top[JOBS_CACHE_LINE - sizeof(int64_t)];
+    volatile int64_t bottom;
+    char pad_bottom[JOBS_CACHE_LINE - sizeof(int64_t)];
+    JobPool *pool;
+    int index;
+    int trace_slot;
+    uint64_t rng;
+    uint64_t jobs_run;
+    uint64_t steals;
+    ThreadHandle thread;
+    bool started;
+    Job slots[JOBS_DEQUE_CAPACITY];
+} JobWorker;
+
+struct JobPool {
+    JobWorker *workers;
+    int thread_count;
+    bool pin_threads;
+    volatile int64_t stopping;
+    volatile int64_t work_epoch;
+    volatile int64_t sleepers;
+    ThreadMutex lock;
+    ThreadCond wake;
+};
+
+static THREAD_LOCAL JobWorker *t_job_worker = NULL;
+
+static const char *const g_job_trace_names[] = {
+    "job_worker_1", "job_worker_2", "job_worker_3", "job_worker_4", "job_worker_5",
+    "job_worker_6", "job_worker_7", "job_worker_8", "job_worker_9", "job_worker_10",
+    "job_worker_11", "job_worker_12", "job_worker_13", "job_worker_14", "job_worker_15",
+};
+
+static bool jobs_push(JobWorker *worker, const Job *job) {
+    int64_t b = atomic_load_relaxed_i64(&worker->bottom);
+    int64_t t = atomic_load_i64(&worker->top);
+    if (b - t >= JOBS_DEQUE_CAPACITY) {
+        return false;
+    }
+    worker->slots[b & (JOBS_DEQUE_CAPACITY - 1)] = *job;
+    atomic_store_i64(&worker->bottom, b + 1);
+    return true;
+}
+
+static bool jobs_pop(JobWorker *worker, Job *out_job) {
+    int64_t b = atomic_load_relaxed_i64(&worker->bottom) - 1;
+    atomic_store_relaxed_i64(&worker->bottom, b);
+    atomic_fence_seq_cst();
+    int64_t t = atomic_load_relaxed_i64(&worker->top);
+    if (t > b) {
+        atomic_store_relaxed_i64(&worker->bottom, b + 1);
+        return false;
+    }
+    *out_job = worker->slots[b & (JOBS_DEQUE_CAPACITY - 1)];
+    if (t == b) {
+        // Last item: race thieves for it through top.
+        bool won = atomic_cas_i64(&worker->top, t, t + 1);
+        atomic_store_relaxed_i64(&worker->bottom, b + 1);
+        return won;
+    }
+    return true;
+}
+
+static bool jobs_steal(JobWorker *victim, Job *out_job) {
+    int64_t t = atomic_load_i64(&victim->top);
+    atomic_fence_seq_cst();
+    int64_t b = atomic_load_i64(&victim->bottom);
+    if (t >= b) {
+        return false;
+    }
+    Job job = victim->slots[t & (JOBS_DEQUE_CAPACITY - 1)];
+    if (!atomic_cas_i64(&victim->top, t, t + 1)) {
+        return false;
+    }
+    *out_job = job;
+    return true;
+}
+
+static int64_t jobs_deque_size(JobWorker *worker) {
+    int64_t size = atomic_load_relaxed_i64(&worker->bottom) - atomic_load_relaxed_i64(&worker->top);
+    return size > 0 ? size : 0;
+}
+
+static void jobs_notify(JobPool *pool) {
+    atomic_fetch_add_i64(&pool->work_epoch, 1);
+    atomic_fence_seq_cst();
+    if (atomic_load_i64(&pool->sleepers) > 0) {
+        thread_mutex_lock(&pool->lock);
+        thread_cond_signal(&pool->wake);
+        thread_mutex_unlock(&pool->lock);
+    }
+}
+
+static void jobs_run(JobWorker *worker, Job *job) {
+    size_t begin = job->begin;
+    size_t end = job->end;
+    size_t grain = job->grain > 0 ? job->grain : 1;
+    size_t processed = 0;
+    TRACE_BEGIN("job");
+    while (begin < end) {
+        // Lazy binary splitting: hand off half the remaining range only when
+        // this worker has nothing queued for thieves to take.
+        if (worker && end - begin > grain * 2 && jobs_deque_size(worker) == 0) {
+            Job rest = *job;
+            rest.begin = begin + (end - begin) / 2;
+            rest.end = end;
+            if (jobs_push(worker, &rest)) {
+                end = rest.begin;
+                jobs_notify(worker->pool);
+                continue;
+            }
+        }
+        size_t chunk_end = (end - begin > grain) ? begin + grain : end;
+        job->fn(job->user, begin, chunk_end);
+        processed += chunk_end - begin;
+        begin = chunk_end;
+    }
+    TRACE_END("job");
+    if (worker) {
+        worker->jobs_run += 1;
+    }
+    if (job->counter) {
+        atomic_fetch_add_i64(&job->counter->pending, -(int64_t)processed);
+    }
+}
+
+static bool jobs_find(JobWorker *worker, Job *out_job) {
+    if (jobs_pop(worker, out_job)) {
+        return true;
+    }
+    JobPool *pool = worker->pool;
+    int count = pool->thread_count;
+    if (count <= 1) {
+        return false;
+    }
+    uint64_t x = worker->rng;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    worker->rng = x;
+    int start = (int)(x % (uint64_t)count);
+    for (int i = 0; i < count; ++i) {
+        int victim = (start + i) % count;
+        if (victim == worker->index) {
+            continue;
+        }
+        if (jobs_steal(&pool->workers[victim], out_job)) {
+            worker->steals += 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+static int jobs_worker_main(void *user) {
+    JobWorker *worker = (JobWorker *)user;
+    JobPool *pool = worker->pool;
+    t_job_worker = worker;
+    trace_bind_thread(worker->trace_slot);
+    if (pool->pin_threads && !thread_pin_current(worker->index % thread_cpu_count())) {
+        LOG_WARN("jobs: failed to pin worker %d", worker->index);
+    }
+
+    Job job;
+    while (atomic_load_i64(&pool->stopping) == 0) {
+        int64_t epoch = atomic_load_i64(&pool->work_epoch);
+        bool found = false;
+        for (int spin = 0; spin < JOBS_SPIN_ROUNDS && !found; ++spin) {
+            found = jobs_find(worker, &job);
+            if (!found) {
+                atomic_cpu_relax();
+            }
+        }
+        if (found) {
+            jobs_run(worker, &job);
+            continue;
+        }
+        // Sleep until a push bumps the epoch observed before the last search.
+        thread_mutex_lock(&pool->lock);
+        atomic_fetch_add_i64(&pool->sleepers, 1);
+        atomic_fence_seq_cst();
+        while (atomic_load_i64(&pool->stopping) == 0 &&
+               atomic_load_i64(&pool->work_epoch) == epoch) {
+            thread_cond_wait(&pool->wake, &pool->lock);
+        }
+        atomic_fetch_add_i64(&pool->sleepers, -1);
+        thread_mutex_unlock(&pool->lock);
+    }
+    t_job_worker = NULL;
+    return 0;
+}
+
+JobPool *jobs_create(int thread_count, bool pin_threads) {
+    if (thread_count <= 0) {
+        thread_count = thread_cpu_count();
+    }
+    if (thread_count > JOBS_MAX_THREADS) {
+        thread_count = JOBS_MAX_THREADS;
+    }
+
+    JobPool *pool = (JobPool *)mem_calloc(ALLOC_TAG_PLATFORM, 1, sizeof(JobPool));
+    if (!pool) {
+        LOG_ERROR("jobs: failed to allocate pool");
+        return NULL;
+    }
+    size_t worker_bytes = sizeof(JobWorker) * (size_t)thread_count;
+    pool->workers = (JobWorker *)mem_alloc_aligned(ALLOC_TAG_PLATFORM, worker_bytes, JOBS_CACHE_LINE);
+    if (!pool->workers) {
+        LOG_ERROR("jobs: failed to allocate %d workers", thread_count);
+        mem_free(ALLOC_TAG_PLATFORM, pool);
+        return NULL;
+    }
+    memset(pool->workers, 0, worker_bytes);
+    pool->thread_count = thread_count;
+    pool->pin_threads = pin_threads;
+    thread_mutex_init(&pool->lock);
+    thread_cond_init(&pool->wake);
+
+    const int trace_names = (int)(sizeof(g_job_trace_names) / sizeof(g_job_trace_names[0]));
+    for (int i = 0; i < thread_count; ++i) {
+        JobWorker *worker = &pool->workers[i];
+        worker->pool = pool;
+        worker->index = i;
+        worker->rng = UINT64_C(0x9E3779B97F4A7C15) * (uint64_t)(i + 1);
+        worker->trace_slot = (i > 0 && i <= trace_names) ? trace_reserve_thread(g_job_trace_names[i - 1])
+                                                         : -1;
+    }
+    t_job_worker = &pool->workers[0];
+
+    for (int i = 1; i < thread_count; ++i) {
+        JobWorker *worker = &pool->workers[i];
+        if (!thread_create(&worker->thread, jobs_worker_main, worker)) {
+            LOG_ERROR("jobs: failed to start worker %d", i);
+            jobs_destroy(pool);
+            return NULL;
+        }
+        worker->started = true;
+    }
+    LOG_INFO("jobs: %d threads deque=%d pinned=%d", thread_count, JOBS_DEQUE_CAPACITY,
+             pin_threads ? 1 : 0);
+    return pool;
+}
+
+void jobs_destroy(JobPool *pool) {
+    if (!pool) {
+        return;
+    }
+    atomic_store_i64(&pool->stopping, 1);
+    thread_mutex_lock(&pool->lock);
+    thread_cond_broadcast(&pool->wake);
+    thread_mutex_unlock(&pool->lock);
+
+    uint64_t jobs_run = 0;
+    uint64_t steals = 0;
+    for (int i = 0; i < pool->thread_count; ++i) {
+        JobWorker *worker = &pool->workers[i];
+        if (worker->started) {
+            thread_join(&worker->thread);
+            worker->started = false;
+        }
+        jobs_run += worker->jobs_run;
+        steals += worker->steals;
+    }
+    LOG_INFO("jobs: shutdown jobs=%llu steals=%llu",
+             (unsigned long long)jobs_run, (unsigned long long)steals);
+    if (t_job_worker && t_job_worker->pool == pool) {
+        t_job_worker = NULL;
+    }
+    thread_cond_destroy(&pool->wake);
+    thread_mutex_destroy(&pool->lock);
+    mem_free_aligned(ALLOC_TAG_PLATFORM, pool->workers);
+    mem_free(ALLOC_TAG_PLATFORM, pool);
+}
+
+int jobs_thread_count(const JobPool *pool) {
+    return pool ? pool->thread_count : 1;
+}
+
+int jobs_worker_index(void) {
+    return t_job_worker ? t_job_worker->index : 0;
+}
+
+static JobWorker *jobs_local_worker(JobPool *pool) {
+    JobWorker *worker = t_job_worker;
+    return (pool && worker && worker->pool == pool) ? worker : NULL;
+}
+
+void jobs_parallel_for(JobPool *pool, size_t count, size_t grain, JobFn fn, void *user,
+                       JobCounter *counter) {
+    if (count == 0 || !fn) {
+        return;
+    }
+    if (grain == 0) {
+        size_t splits = (size_t)jobs_thread_count(pool) * JOBS_SPLITS_PER_THREAD;
+        grain = count / splits;
+        if (grain == 0) {
+            grain = 1;
+        }
+    }
+    Job job = {fn, user, 0, count, grain, counter};
+    if (counter) {
+        atomic_fetch_add_i64(&counter->pending, (int64_t)count);
+    }
+    JobWorker *worker = jobs_local_worker(pool);
+    if (!worker || !jobs_push(worker, &job)) {
+        jobs_run(worker, &job);
+        return;
+    }
+    jobs_notify(pool);
+}
+
+void jobs_submit(JobPool *pool, JobFn fn, void *user, JobCounter *counter) {
+    jobs_parallel_for(pool, 1, 1, fn, user, counter);
+}
+
+void jobs_wait(JobPool *pool, JobCounter *counter) {
+    if (!counter) {
+        return;
+    }
+    JobWorker *worker = jobs_local_worker(pool);
+    unsigned idle_rounds = 0;
+    while (atomic_load_i64(&counter->pending) > 0) {
+        Job job;
+        if (worker && jobs_find(worker, &job)) {
+            jobs_run(worker, &job);
+            idle_rounds = 0;
+            continue;
+        }
+        // Remaining items are running elsewhere; back off gently.
+        if (++idle_rounds < JOBS_SPIN_ROUNDS) {
+            atomic_cpu_relax();
+        } else {
+            thread_yield();
+        }
+    }
+}
@@ -0,0 +1,113 @@
+#include "util/mem_report.h"
+
+#include <string.h>
+
+#include "util/log.h"
+
+void mem_report_reset(MemReport *report, size_t bee_count) {
+    if (!report) {
+        return;
+    }
+    report->count = 0;
+    report->bee_count = bee_count;
+}
+
+void mem_report_add(MemReport *report,
+                    const char *subsystem,
+                    const char *name,
+                    uint64_t bytes,
+                    MemRegion region,
+                    bool per_bee) {
+    if (!report || report->count >= MEM_REPORT_MAX_ENTRIES) {
+        return;
+    }
+    MemReportEntry *entry = &report->entries[report->count++];
+    entry->subsystem = subsystem;
+    entry->name = name;
+    entry->bytes = bytes;
+    entry->region = region;
+    entry->per_bee = per_bee;
+}
+
+uint64_t mem_report_total(const MemReport *report, const char *subsystem, MemRegion region) {
+    if (!report) {
+        return 0;
+    }
+    uint64_t total = 0;
+    for (size_t i = 0; i < report->count; ++i) {
+        const MemReportEntry *entry = &report->entries[i];
+        if (entry->region != region) {
+            continue;
+        }
+        if (subsystem && strcmp(entry->subsystem, subsystem) != 0) {
+            continue;
+        }
+        total += entry->bytes;
+    }
+    return total;
+}
+
+double mem_report_bytes_per_bee(const MemReport *report, bool per_bee_only) {
+    if (!report || report->bee_count == 0) {
+        return 0.0;
+    }
+    uint64_t total = 0;
+    for (size_t i = 0; i < report->count; ++i) {
+        if (per_bee_only && !report->entries[i].per_bee) {
+            continue;
+        }
+        total += report->entries[i].bytes;
+    }
+    return (double)total / (double)report->bee_count;
+}
+
+static double mem_report_mib(uint64_t bytes) {
+    return (double)bytes / (1024.0 * 1024.0);
+}
+
+void mem_report_log(const MemReport *report) {
+    if (!report) {
+        return;
+    }
+    double bees = report->bee_count > 0 ? (double)report->bee_count : 1.0;
+    for (size_t i = 0; i < report->count; ++i) {
+        const MemReportEntry *entry = &report->entries[i];
+        if (entry->per_bee) {
+            LOG_INFO("mem: %-8s %-20s %s %10.3f MiB  %6.2f B/bee",
+                     entry->subsystem, entry->name,
+                     entry->region == MEM_REGION_GPU ? "gpu" : "cpu",
+                     mem_report_mib(entry->bytes), (double)entry->bytes / bees);
+        } else {
+            LOG_INFO("mem: %-8s %-20s %s %10.3f MiB",
+                     entry->subsystem, entry->name,
+                     entry->region == MEM_REGION_GPU ? "gpu" : "cpu",
+                     mem_report_mib(entry->bytes));
+        }
+    }
+
+    // Subsystem totals, in first-seen order.
+    for (size_t i = 0; i < report->count; ++i) {
+        const char *subsystem = report->entries[i].subsystem;
+        bool seen = false;
+        for (size_t j = 0; j < i; ++j) {
+            if (strcmp(report->entries[j].subsystem, subsystem) == 0) {
+                seen = true;
+                break;
+            }
+        }
+        if (seen) {
+            continue;
+        }
+        LOG_INFO("mem: %-8s total cpu=%.3f MiB gpu=%.3f MiB",
+                 subsystem,
+                 mem_report_mib(mem_report_total(report, subsystem, MEM_REGION_CPU)),
+                 mem_report_mib(mem_report_total(report, subsystem, MEM_REGION_GPU)));
+    }
+
+    LOG_INFO("mem: bees=%zu cpu=%.3f MiB gpu=%.3f MiB bytes/bee=%.1f (marginal %.1f)",
+             report->bee_count,
+             mem_report_mib(mem_report_total(report, NULL, MEM_REGION_CPU)),
+             mem_report_mib(mem_report_total(report, NULL, MEM_REGION_GPU)),
+             mem_report_bytes_per_bee(report, false),
+             mem_report_bytes_per_bee(report, true));
+}
@@ -0,0 +1,253 @@
+#include "util/rng.h"
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+#include "util/atomic.h"
+
+#define RNG_BLOCK 256
+#define RNG_ZIG_LAYERS 128
+#define RNG_ZIG_R 3.442619855899
+
+typedef struct RngZigTables {
+    uint32_t kn[RNG_ZIG_LAYERS];
+    float wn[RNG_ZIG_LAYERS];
+    float fn[RNG_ZIG_LAYERS];
+} RngZigTables;
+
+static RngZigTables g_rng_zig;
+static volatile int64_t g_rng_zig_ready = 0;  // 0 = empty, 1 = building, 2 = ready
+
+static void rng_zig_build(RngZigTables *z) {
+    // Marsaglia & Tsang, "The Ziggurat Method for Generating Random Variables" (2000).
+    const double m1 = 2147483648.0;
+    const double vn = 9.91256303526217e-3;
+    double dn = RNG_ZIG_R;
+    double tn = dn;
+    double q = vn / exp(-0.5 * dn * dn);
+    z->kn[0] = (uint32_t)((dn / q) * m1);
+    z->kn[1] = 0;
+    z->wn[0] = (float)(q / m1);
+    z->wn[RNG_ZIG_LAYERS - 1] = (float)(dn / m1);
+    z->fn[0] = 1.0f;
+    z->fn[RNG_ZIG_LAYERS - 1] = (float)exp(-0.5 * dn * dn);
+    for (int i = RNG_ZIG_LAYERS - 2; i >= 1; --i) {
+        dn = sqrt(-2.0 * log(vn / dn + exp(-0.5 * dn * dn)));
+        z->kn[i + 1] = (uint32_t)((dn / tn) * m1);
+        tn = dn;
+        z->fn[i] = (float)exp(-0.5 * dn * dn);
+        z->wn[i] = (float)(dn / m1);
+    }
+}
+
+static void rng_zig_self_check(void);
+
+static const RngZigTables *rng_zig_tables(void) {
+    if (atomic_load_i64(&g_rng_zig_ready) == 2) {
+        return &g_rng_zig;
+    }
+    if (atomic_cas_i64(&g_rng_zig_ready, 0, 1)) {
+        rng_zig_build(&g_rng_zig);
+        atomic_store_i64(&g_rng_zig_ready, 2);
+        rng_zig_self_check();
+    } else {
+        while (atomic_load_i64(&g_rng_zig_ready) != 2) {
+            atomic_cpu_relax();
+        }
+    }
+    return &g_rng_zig;
+}
+
+static inline uint64_t rng_xorshift64(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+static inline float rng_open01(uint64_t *state) {
+    // (0, 1]: safe for log().
+    return (float)((rng_xorshift64(state) >> 40) + 1u) * (1.0f / 16777216.0f);
+}
+
+static float rng_zig_slow(const RngZigTables *z, int32_t hz, uint32_t iz, uint64_t *state) {
+    for (;;) {
+        float x = (float)hz * z->wn[iz];
+        if (iz == 0) {
+            // Base strip: sample the tail beyond R.
+            float y;
+            do {
+                x = -logf(rng_open01(state)) * (float)(1.0 / RNG_ZIG_R);
+                y = -logf(rng_open01(state));
+            } while (y + y < x * x);
+            return hz > 0 ? (float)RNG_ZIG_R + x : -(float)RNG_ZIG_R - x;
+        }
+        float u = rng_open01(state);
+        if (z->fn[iz] + u * (z->fn[iz - 1] - z->fn[iz]) < expf(-0.5f * x * x)) {
+            return x;
+        }
+        hz = (int32_t)(uint32_t)(rng_xorshift64(state) >> 32);
+        iz = (uint32_t)hz & (RNG_ZIG_LAYERS - 1);
+        uint32_t ahz = hz < 0 ? 0u - (uint32_t)hz : (uint32_t)hz;
+        if (ahz < z->kn[iz]) {
+            return (float)hz * z->wn[iz];
+        }
+    }
+}
+
+static inline float rng_zig_sample(const RngZigTables *z, uint32_t bits, uint64_t *slow_state) {
+    int32_t hz = (int32_t)bits;
+    uint32_t iz = bits & (RNG_ZIG_LAYERS - 1);
+    uint32_t ahz = hz < 0 ? 0u - (uint32_t)hz : (uint32_t)hz;
+    if (ahz < z->kn[iz]) {
+        return (float)hz * z->wn[iz];
+    }
+    return rng_zig_slow(z, hz, iz, slow_state);
+}
+
+static uint64_t rng_splitmix_next(uint64_t *z) {
+    *z += UINT64_C(0x9E3779B97F4A7C15);
+    uint64_t x = *z;
+    x = (x ^ (x >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+    x = (x ^ (x >> 27)) * UINT64_C(0x94D049BB133111EB);
+    return x ^ (x >> 31);
+}
+
+void rng_lanes_seed(RngLanes *rng, uint64_t seed) {
+    if (!rng) {
+        return;
+    }
+    uint64_t z = seed;
+    for (int l = 0; l < RNG_LANES; ++l) {
+        uint64_t x = rng_splitmix_next(&z);
+        rng->s[l] = x ? x : UINT64_C(0xBEE) + (uint64_t)l;
+    }
+    // Seeded, not derived from a lane: xorshift64 is linear, so any fixed
+    // transform of a lane state would replay that lane's sequence.
+    uint64_t x = rng_splitmix_next(&z);
+    rng->slow = x ? x : UINT64_C(0xBEE) + RNG_LANES;
+    (void)rng_zig_tables();
+}
+
+void rng_lanes_seed_stream(RngLanes *rng, uint64_t seed, uint64_t stream) {
+    // Scramble the stream index so consecutive streams do not share lanes.
+    uint64_t x = (stream + 1u) * UINT64_C(0xD1342543DE82EF95);
+    x ^= x >> 32;
+    rng_lanes_seed(rng, seed ^ x);
+}
+
+void rng_fill_u32(RngLanes *rng, uint32_t *out, size_t n) {
+    uint64_t s[RNG_LANES];
+    memcpy(s, rng->s, sizeof(s));
+    size_t i = 0;
+    for (; i + RNG_LANES <= n; i += RNG_LANES) {
+        for (int l = 0; l < RNG_LANES; ++l) {
+            uint64_t x = s[l];
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            s[l] = x;
+            out[i + (size_t)l] = (uint32_t)(x >> 32);
+        }
+    }
+    if (i < n) {
+        uint32_t tail[RNG_LANES];
+        for (int l = 0; l < RNG_LANES; ++l) {
+            uint64_t x = s[l];
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            s[l] = x;
+            tail[l] = (uint32_t)(x >> 32);
+        }
+        memcpy(out + i, tail, sizeof(uint32_t) * (n - i));
+    }
+    memcpy(rng->s, s, sizeof(s));
+}
+
+void rng_fill_range(RngLanes *rng, float *out, size_t n, float lo, float hi) {
+    uint64_t s[RNG_LANES];
+    memcpy(s, rng->s, sizeof(s));
+    const float scale = (hi - lo) * (1.0f / 16777216.0f);
+    size_t i = 0;
+    for (; i + RNG_LANES <= n; i += RNG_LANES) {
+        for (int l = 0; l < RNG_LANES; ++l) {
+            uint64_t x = s[l];
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            s[l] = x;
+            out[i + (size_t)l] = lo + (float)(int32_t)(x >> 40) * scale;
+        }
+    }
+    if (i < n) {
+        float tail[RNG_LANES];
+        for (int l = 0; l < RNG_LANES; ++l) {
+            uint64_t x = s[l];
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            s[l] = x;
+            tail[l] = lo + (float)(int32_t)(x >> 40) * scale;
+        }
+        memcpy(out + i, tail, sizeof(float) * (n - i));
+    }
+    memcpy(rng->s, s, sizeof(s));
+}
+
+void rng_fill_uniform01(RngLanes *rng, float *out, size_t n) {
+    rng_fill_range(rng, out, n, 0.0f, 1.0f);
+}
+
+void rng_fill_gaussian(RngLanes *rng, float *out, size_t n, float mean, float stddev) {
+    const RngZigTables *z = rng_zig_tables();
+    uint32_t bits[RNG_BLOCK];
+    uint64_t slow_state = rng->slow;
+    size_t done = 0;
+    while (done < n) {
+        size_t m = n - done < RNG_BLOCK ? n - done : RNG_BLOCK;
+        rng_fill_u32(rng, bits, m);
+        for (size_t i = 0; i < m; ++i) {
+            out[done + i] = mean + stddev * rng_zig_sample(z, bits[i], &slow_state);
+        }
+        done += m;
+    }
+    rng->slow = slow_state;
+}
+
+float rng_gaussian(uint64_t *state) {
+    const RngZigTables *z = rng_zig_tables();
+    return rng_zig_sample(z, (uint32_t)(rng_xorshift64(state) >> 32), state);
+}
+
+// Debug builds draw a fixed batch once, when the tables are built, and check
+// the moments and the share beyond R (P(|x| > R) = 5.8e-4) so a broken table
+// or tail sampler fails at startup instead of skewing a run.
+static void rng_zig_self_check(void) {
+#ifndef NDEBUG
+    enum { N = 1 << 16 };
+    static float samples[N];
+    RngLanes rng;
+    rng_lanes_seed(&rng, UINT64_C(0x5EED));
+    rng_fill_gaussian(&rng, samples, N, 0.0f, 1.0f);
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    size_t tail = 0;
+    for (size_t i = 0; i < N; ++i) {
+        sum += samples[i];
+        sum_sq += (double)samples[i] * samples[i];
+        tail += fabsf(samples[i]) > (float)RNG_ZIG_R;
+    }
+    double mean = sum / N;
+    double var = sum_sq / N - mean * mean;
+    assert(fabs(mean) < 0.02 && "ziggurat mean");
+    assert(fabs(var - 1.0) < 0.03 && "ziggurat variance");
+    assert(tail >= 10 && tail <= 80 && "ziggurat tail");
+    (void)mean;
+    (void)var;
+    (void)tail;
+#endif
+}
@@ -0,0 +1,141 @@
+#include "util/series.h"
+
+#include <math.h>
+#include <string.h>
+
+static void series_accum_reset(SeriesAccum *accum) {
+    accum->min = INFINITY;
+    accum->max = -INFINITY;
+    accum->sum = 0.0;
+    accum->count = 0;
+}
+
+static void series_accum_add(SeriesAccum *accum, float min, float max, float mean) {
+    if (min < accum->min) {
+        accum->min = min;
+    }
+    if (max > accum->max) {
+        accum->max = max;
+    }
+    accum->sum += (double)mean;
+    accum->count += 1;
+}
+
+void series_init(TimeSeries *series, double period_sec) {
+    if (!series) {
+        return;
+    }
+    memset(series, 0, sizeof(*series));
+    series->period_sec = period_sec > 0.0 ? period_sec : 1.0;
+    for (int level = 0; level < SERIES_LEVELS; ++level) {
+        series_accum_reset(&series->levels[level].pending);
+    }
+}
+
+// Closes the pending point of `level` and carries it upward while the next
+// level fills up.
+static void series_close(TimeSeries *series, int level) {
+    for (; level < SERIES_LEVELS; ++level) {
+        SeriesLevel *lv = &series->levels[level];
+        SeriesPoint point = {
+            lv->pending.min,
+            lv->pending.max,
+            (float)(lv->pending.sum / (double)lv->pending.count),
+        };
+        series_accum_reset(&lv->pending);
+        lv->points[lv->head] = point;
+        lv->head = (lv->head + 1u) % SERIES_CAPACITY;
+        if (lv->count < SERIES_CAPACITY) {
+            lv->count += 1;
+        }
+        if (level + 1 >= SERIES_LEVELS) {
+            return;
+        }
+        SeriesAccum *up = &series->levels[level + 1].pending;
+        series_accum_add(up, point.min, point.max, point.mean);
+        if (up->count < SERIES_FANOUT) {
+            return;
+        }
+    }
+}
+
+void series_add(TimeSeries *series, float value, double dt_sec) {
+    if (!series) {
+        return;
+    }
+    series_accum_add(&series->levels[0].pending, value, value, value);
+    series->last = value;
+    series->samples += 1;
+    series->pending_sec += dt_sec > 0.0 ? dt_sec : 0.0;
+    // The small slack keeps 60 steps of 1/60 s from missing a 1 s boundary.
+    if (series->pending_sec + 1e-9 >= series->period_sec) {
+        series->pending_sec -= series->period_sec;
+        if (series->pending_sec >= series->period_sec) {
+            // One sample spanning several periods closes a single point.
+            series->pending_sec = 0.0;
+        }
+        series_close(series, 0);
+    }
+}
+
+size_t series_decimate(const TimeSeries *series,
+                       double window_sec,
+                       SeriesPoint *out,
+                       size_t max_buckets,
+                       size_t *out_slots) {
+    if (out_slots) {
+        *out_slots = 0;
+    }
+    if (!series || !out || max_buckets == 0 || !(window_sec > 0.0)) {
+        return 0;
+    }
+    int level = 0;
+    double period = series->period_sec;
+    while (level + 1 < SERIES_LEVELS && period * SERIES_CAPACITY < window_sec) {
+        ++level;
+        period *= SERIES_FANOUT;
+    }
+    const SeriesLevel *lv = &series->levels[level];
+
+    // Point j of the window (0 = oldest) lands in slot j * slots / span; only
+    // the newest `avail` points exist.
+    size_t span = (size_t)ceil(window_sec / period);
+    if (span > SERIES_CAPACITY) {
+        span = SERIES_CAPACITY;
+    }
+    if (span == 0) {
+        span = 1;
+    }
+    size_t slots = span < max_buckets ? span : max_buckets;
+    size_t avail = lv->count < span ? lv->count : span;
+    if (out_slots) {
+        *out_slots = slots;
+    }
+    if (avail == 0) {
+        return 0;
+    }
+    size_t first_slot = (span - avail) * slots / span;
+    size_t filled = 0;
+    uint32_t merged = 0;
+    for (size_t j = span - avail; j < span; ++j) {
+        size_t back = span - 1 - j;  // 0 = newest closed point
+        const SeriesPoint *point = &lv->points[(lv->head + SERIES_CAPACITY - 1u - back) % SERIES_CAPACITY];
+        size_t bucket = j * slots / span - first_slot;
+        if (bucket == filled) {
+            out[bucket] = *point;
+            merged = 1;
+            filled += 1;
+            continue;
+        }
+        SeriesPoint *dst = &out[bucket];
+        if (point->min < dst->min) {
+            dst->min = point->min;
+        }
+        if (point->max > dst->max) {
+            dst->max = point->max;
+        }
+        merged += 1;
+        dst->mean += (point->mean - dst->mean) / (float)merged;
+    }
+    return filled;
+}
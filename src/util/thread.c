@@ -0,0 +1,213 @@
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE  // pthread_setaffinity_np
+#endif
+
+#include "util/thread.h"
+
+#include <stdlib.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+typedef struct ThreadStart {
+    ThreadFn fn;
+    void *user;
+} ThreadStart;
+
+static DWORD WINAPI thread_trampoline(LPVOID param) {
+    ThreadStart start = *(ThreadStart *)param;
+    free(param);
+    return (DWORD)start.fn(start.user);
+}
+
+bool thread_create(ThreadHandle *out_thread, ThreadFn fn, void *user) {
+    if (!out_thread || !fn) {
+        return false;
+    }
+    ThreadStart *start = (ThreadStart *)malloc(sizeof(ThreadStart));
+    if (!start) {
+        return false;
+    }
+    start->fn = fn;
+    start->user = user;
+    HANDLE handle = CreateThread(NULL, 0, thread_trampoline, start, 0, NULL);
+    if (!handle) {
+        free(start);
+        out_thread->handle = NULL;
+        return false;
+    }
+    out_thread->handle = handle;
+    return true;
+}
+
+void thread_join(ThreadHandle *thread) {
+    if (!thread || !thread->handle) {
+        return;
+    }
+    WaitForSingleObject((HANDLE)thread->handle, INFINITE);
+    CloseHandle((HANDLE)thread->handle);
+    thread->handle = NULL;
+}
+
+void thread_mutex_init(ThreadMutex *mutex) {
+    InitializeSRWLock((PSRWLOCK)&mutex->lock);
+}
+
+void thread_mutex_destroy(ThreadMutex *mutex) {
+    (void)mutex;
+}
+
+void thread_mutex_lock(ThreadMutex *mutex) {
+    AcquireSRWLockExclusive((PSRWLOCK)&mutex->lock);
+}
+
+void thread_mutex_unlock(ThreadMutex *mutex) {
+    ReleaseSRWLockExclusive((PSRWLOCK)&mutex->lock);
+}
+
+void thread_cond_init(ThreadCond *cond) {
+    InitializeConditionVariable((PCONDITION_VARIABLE)&cond->cond);
+}
+
+void thread_cond_destroy(ThreadCond *cond) {
+    (void)cond;
+}
+
+void thread_cond_wait(ThreadCond *cond, ThreadMutex *mutex) {
+    SleepConditionVariableSRW((PCONDITION_VARIABLE)&cond->cond, (PSRWLOCK)&mutex->lock, INFINITE, 0);
+}
+
+void thread_cond_signal(ThreadCond *cond) {
+    WakeConditionVariable((PCONDITION_VARIABLE)&cond->cond);
+}
+
+void thread_cond_broadcast(ThreadCond *cond) {
+    WakeAllConditionVariable((PCONDITION_VARIABLE)&cond->cond);
+}
+
+int thread_cpu_count(void) {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+}
+
+bool thread_pin_current(int cpu) {
+    if (cpu < 0 || cpu >= (int)(sizeof(DWORD_PTR) * 8)) {
+        return false;
+    }
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) != 0;
+}
+
+void thread_yield(void) {
+    SwitchToThread();
+}
+
+#else
+
+typedef struct ThreadStart {
+    ThreadFn fn;
+    void *user;
+} ThreadStart;
+
+static void *thread_trampoline(void *param) {
+    ThreadStart start = *(ThreadStart *)param;
+    free(param);
+    start.fn(start.user);
+    return NULL;
+}
+
+bool thread_create(ThreadHandle *out_thread, ThreadFn fn, void *user) {
+    if (!out_thread || !fn) {
+        return false;
+    }
+    out_thread->started = false;
+    ThreadStart *start = (ThreadStart *)malloc(sizeof(ThreadStart));
+    if (!start) {
+        return false;
+    }
+    start->fn = fn;
+    start->user = user;
+    if (pthread_create(&out_thread->handle, NULL, thread_trampoline, start) != 0) {
+        free(start);
+        return false;
+    }
+    out_thread->started = true;
+    return true;
+}
+
+void thread_join(ThreadHandle *thread) {
+    if (!thread || !thread->started) {
+        return;
+    }
+    pthread_join(thread->handle, NULL);
+    thread->started = false;
+}
+
+void thread_mutex_init(ThreadMutex *mutex) {
+    pthread_mutex_init(&mutex->lock, NULL);
+}
+
+void thread_mutex_destroy(ThreadMutex *mutex) {
+    pthread_mutex_destroy(&mutex->lock);
+}
+
+void thread_mutex_lock(ThreadMutex *mutex) {
+    pthread_mutex_lock(&mutex->lock);
+}
+
+void thread_mutex_unlock(ThreadMutex *mutex) {
+    pthread_mutex_unlock(&mutex->lock);
+}
+
+void thread_cond_init(ThreadCond *cond) {
+    pthread_cond_init(&cond->cond, NULL);
+}
+
+void thread_cond_destroy(ThreadCond *cond) {
+    pthread_cond_destroy(&cond->cond);
+}
+
+void thread_cond_wait(ThreadCond *cond, ThreadMutex *mutex) {
+    pthread_cond_wait(&cond->cond, &mutex->lock);
+}
+
+void thread_cond_signal(ThreadCond *cond) {
+    pthread_cond_signal(&cond->cond);
+}
+
+void thread_cond_broadcast(ThreadCond *cond) {
+    pthread_cond_broadcast(&cond->cond);
+}
+
+int thread_cpu_count(void) {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+}
+
+bool thread_pin_current(int cpu) {
+#if defined(__linux__)
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+void thread_yield(void) {
+    sched_yield();
+}
+
+#endif
@@ -0,0 +1,201 @@
+#include "util/trace.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "util/alloc.h"
+#include "util/clock.h"
+#include "util/log.h"
+#include "util/thread.h"
+
+typedef struct TraceEvent {
+    uint64_t ts_ns;
+    const char *name;
+    char phase;  // 'B' or 'E'
+} TraceEvent;
+
+typedef struct TraceBuffer {
+    TraceEvent *events;
+    size_t count;
+    size_t capacity;
+    size_t dropped;
+    size_t open;     // recorded 'B' events still awaiting their 'E'
+    size_t refused;  // open scopes whose 'B' was dropped; their 'E' is dropped too
+    const char *thread_name;
+} TraceBuffer;
+
+volatile bool g_trace_recording = false;
+
+static TraceBuffer g_trace_buffers[TRACE_MAX_THREADS];
+static int g_trace_thread_count = 0;
+static size_t g_trace_events_per_thread = 0;
+static uint64_t g_trace_origin_ns = 0;
+static THREAD_LOCAL TraceBuffer *t_trace_buffer = NULL;
+
+int trace_reserve_thread(const char *name) {
+    if (g_trace_events_per_thread == 0 || g_trace_thread_count >= TRACE_MAX_THREADS) {
+        return -1;
+    }
+    TraceBuffer *buffer = &g_trace_buffers[g_trace_thread_count];
+    buffer->events = (TraceEvent *)mem_alloc(ALLOC_TAG_IO, sizeof(TraceEvent) * g_trace_events_per_thread);
+    if (!buffer->events) {
+        LOG_WARN("trace: failed to allocate buffer for thread '%s'", name);
+        return -1;
+    }
+    buffer->capacity = g_trace_events_per_thread;
+    buffer->count = 0;
+    buffer->dropped = 0;
+    buffer->open = 0;
+    buffer->refused = 0;
+    buffer->thread_name = name;
+    return g_trace_thread_count++;
+}
+
+void trace_bind_thread(int slot) {
+    if (slot < 0 || slot >= g_trace_thread_count) {
+        t_trace_buffer = NULL;
+        return;
+    }
+    t_trace_buffer = &g_trace_buffers[slot];
+}
+
+bool trace_init(size_t events_per_thread) {
+    if (g_trace_events_per_thread != 0) {
+        return true;
+    }
+    g_trace_events_per_thread = events_per_thread > 0 ? events_per_thread
+                                                      : TRACE_DEFAULT_EVENTS_PER_THREAD;
+    int slot = trace_reserve_thread("main");
+    if (slot < 0) {
+        g_trace_events_per_thread = 0;
+        return false;
+    }
+    trace_bind_thread(slot);
+    g_trace_origin_ns = clock_now_ns();
+    return true;
+}
+
+void trace_shutdown(void) {
+    g_trace_recording = false;
+    for (int i = 0; i < g_trace_thread_count; ++i) {
+        mem_free(ALLOC_TAG_IO, g_trace_buffers[i].events);
+        memset(&g_trace_buffers[i], 0, sizeof(g_trace_buffers[i]));
+    }
+    g_trace_thread_count = 0;
+    g_trace_events_per_thread = 0;
+    t_trace_buffer = NULL;
+}
+
+void trace_start(void) {
+    if (g_trace_thread_count == 0) {
+        LOG_WARN("trace: trace_init has not been called");
+        return;
+    }
+    for (int i = 0; i < g_trace_thread_count; ++i) {
+        g_trace_buffers[i].count = 0;
+        g_trace_buffers[i].dropped = 0;
+        g_trace_buffers[i].open = 0;
+        g_trace_buffers[i].refused = 0;
+    }
+    g_trace_origin_ns = clock_now_ns();
+    g_trace_recording = true;
+    LOG_INFO("trace: recording started");
+}
+
+void trace_stop(void) {
+    g_trace_recording = false;
+}
+
+static void trace_push(TraceBuffer *buffer, const char *name, char phase) {
+    TraceEvent *event = &buffer->events[buffer->count];
+    event->ts_ns = clock_now_ns();
+    event->name = name;
+    event->phase = phase;
+    buffer->count += 1;
+}
+
+// A 'B' is only recorded when the buffer still has room for it plus an 'E'
+// for every open scope, so a full buffer stops opening slices but still
+// closes the ones it has (no "frame" running to the end of the trace).
+// Scopes are nested, so once a 'B' is refused every later one is too and
+// the first 'E's to arrive belong to refused scopes.
+void trace_begin(const char *name) {
+    TraceBuffer *buffer = t_trace_buffer;
+    if (!buffer) {
+        return;
+    }
+    if (buffer->refused > 0 || buffer->count + buffer->open + 2u > buffer->capacity) {
+        buffer->refused += 1;
+        buffer->dropped += 1;
+        return;
+    }
+    trace_push(buffer, name, 'B');
+    buffer->open += 1;
+}
+
+void trace_end(const char *name) {
+    TraceBuffer *buffer = t_trace_buffer;
+    if (!buffer) {
+        return;
+    }
+    if (buffer->refused > 0) {
+        buffer->refused -= 1;
+        buffer->dropped += 1;
+        return;
+    }
+    if (buffer->open > 0) {
+        buffer->open -= 1;
+    } else if (buffer->count >= buffer->capacity) {
+        // Closes a scope opened before trace_start; no slot was reserved.
+        buffer->dropped += 1;
+        return;
+    }
+    trace_push(buffer, name, 'E');
+}
+
+bool trace_dump_json(const char *path) {
+    trace_stop();
+    if (!path || !path[0]) {
+        LOG_ERROR("trace: no output path");
+        return false;
+    }
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        LOG_ERROR("trace: failed to open '%s' for writing", path);
+        return false;
+    }
+
+    size_t total = 0;
+    size_t dropped = 0;
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    for (int t = 0; t < g_trace_thread_count; ++t) {
+        const TraceBuffer *buffer = &g_trace_buffers[t];
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                      "\"args\":{\"name\":\"%s\"}}",
+                first ? "" : ",\n", t + 1, buffer->thread_name ? buffer->thread_name : "thread");
+        first = false;
+        for (size_t i = 0; i < buffer->count; ++i) {
+            const TraceEvent *event = &buffer->events[i];
+            double ts_us = event->ts_ns >= g_trace_origin_ns
+                               ? (double)(event->ts_ns - g_trace_origin_ns) * 1e-3
+                               : 0.0;
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%d}",
+                    event->name, event->phase, ts_us, t + 1);
+        }
+        total += buffer->count;
+        dropped += buffer->dropped;
+    }
+    fprintf(file, "\n]}\n");
+    bool ok = ferror(file) == 0;
+    if (fclose(file) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        LOG_ERROR("trace: write to '%s' failed", path);
+        return false;
+    }
+    LOG_INFO("trace: wrote '%s' events=%zu threads=%d dropped=%zu",
+             path, total, g_trace_thread_count, dropped);
+    return true;
+}
@@ -0,0 +1,141 @@
+#include "hex.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "util/alloc.h"
+#include "util/log.h"
+
+#define HEX_MAX_TILES (1u << 22)
+
+const HexAxial g_hex_directions[6] = {
+    {1, 0}, {1, -1}, {0, -1}, {-1, 0}, {-1, 1}, {0, 1},
+};
+
+void hex_layout_init(HexLayout *layout, float size) {
+    if (!layout) {
+        return;
+    }
+    layout->size = size;
+    layout->inv_size = size > 0.0f ? 1.0f / size : 0.0f;
+}
+
+void hex_axial_to_world(const HexLayout *layout, HexAxial hex, float *out_x, float *out_y) {
+    float q = (float)hex.q;
+    float r = (float)hex.r;
+    if (out_x) *out_x = layout->size * HEX_SQRT3 * (q + 0.5f * r);
+    if (out_y) *out_y = layout->size * 1.5f * r;
+}
+
+void hex_corners(const HexLayout *layout, HexAxial hex, float out_xy[12]) {
+    // Pointy-top corners sit at -30 - 60k degrees; with y growing downward
+    // that walks counter-clockwise on screen.
+    static const float kCornerX[6] = {0.8660254f, 0.0f, -0.8660254f, -0.8660254f, 0.0f, 0.8660254f};
+    static const float kCornerY[6] = {-0.5f, -1.0f, -0.5f, 0.5f, 1.0f, 0.5f};
+    float cx = 0.0f;
+    float cy = 0.0f;
+    hex_axial_to_world(layout, hex, &cx, &cy);
+    for (int k = 0; k < 6; ++k) {
+        out_xy[2 * k + 0] = cx + kCornerX[k] * layout->size;
+        out_xy[2 * k + 1] = cy + kCornerY[k] * layout->size;
+    }
+}
+
+int32_t hex_distance(HexAxial a, HexAxial b) {
+    int32_t dq = a.q - b.q;
+    int32_t dr = a.r - b.r;
+    int32_t ds = -dq - dr;
+    return (abs(dq) + abs(dr) + abs(ds)) / 2;
+}
+
+HexAxial hex_neighbor(HexAxial hex, int direction) {
+    const HexAxial d = g_hex_directions[((direction % 6) + 6) % 6];
+    HexAxial out = {hex.q + d.q, hex.r + d.r};
+    return out;
+}
+
+bool hex_grid_init(HexGrid *grid, float size, float world_w, float world_h) {
+    if (!grid || !(size > 0.0f) || !(world_w > 0.0f) || !(world_h > 0.0f)) {
+        LOG_ERROR("hex_grid: invalid size %.2f for world %.1f x %.1f", size, world_w, world_h);
+        return false;
+    }
+    memset(grid, 0, sizeof(*grid));
+
+    // Row r spans y in [1.5r - 1, 1.5r + 1] * size and even/odd rows are
+    // staggered by half a hex, so one extra row and column covers the border.
+    double rows = floor((double)world_h / (1.5 * (double)size)) + 2.0;
+    double cols = floor((double)world_w / ((double)HEX_SQRT3 * (double)size)) + 2.0;
+    if (rows * cols > (double)HEX_MAX_TILES) {
+        LOG_ERROR("hex_grid: %.0f x %.0f tiles exceeds the %u tile limit (size %.2f too small)",
+                  cols, rows, HEX_MAX_TILES, size);
+        return false;
+    }
+
+    size_t tile_count = (size_t)rows * (size_t)cols;
+    HexTile *tiles = (HexTile *)mem_calloc(ALLOC_TAG_SIM, tile_count, sizeof(HexTile));
+    if (!tiles) {
+        LOG_ERROR("hex_grid: failed to allocate %zu tiles", tile_count);
+        return false;
+    }
+    hex_layout_init(&grid->layout, size);
+    grid->rows = (int32_t)rows;
+    grid->cols = (int32_t)cols;
+    grid->tile_count = tile_count;
+    grid->tiles = tiles;
+    return true;
+}
+
+void hex_grid_shutdown(HexGrid *grid) {
+    if (!grid) {
+        return;
+    }
+    mem_free(ALLOC_TAG_SIM, grid->tiles);
+    memset(grid, 0, sizeof(*grid));
+}
+
+void hex_grid_clear(HexGrid *grid) {
+    if (!grid || !grid->tiles) {
+        return;
+    }
+    memset(grid->tiles, 0, sizeof(HexTile) * grid->tile_count);
+}
+
+void hex_grid_tally(HexGrid *grid,
+                    const int32_t *tile,
+                    const uint8_t *mode,
+                    const float *load_uL,
+                    size_t count) {
+    if (!grid || !grid->tiles || !tile || !mode || !load_uL) {
+        return;
+    }
+    for (size_t t = 0; t < grid->tile_count; ++t) {
+        HexTile *dst = &grid->tiles[t];
+        memset(dst->bees_by_mode, 0, sizeof(dst->bees_by_mode));
+        dst->nectar_fx = 0;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        HexTile *dst = &grid->tiles[tile[i]];
+        if (mode[i] < HEX_MODE_SLOTS) {
+            dst->bees_by_mode[mode[i]] += 1u;
+        }
+        dst->nectar_fx += hex_nectar_fixed(load_uL[i]);
+    }
+}
+
+uint32_t hex_tile_bee_count(const HexTile *tile) {
+    if (!tile) {
+        return 0;
+    }
+    uint32_t total = 0;
+    for (int m = 0; m < HEX_MODE_SLOTS; ++m) {
+        total += tile->bees_by_mode[m];
+    }
+    return total;
+}
+
+float hex_tile_nectar_uL(const HexTile *tile) {
+    if (!tile) {
+        return 0.0f;
+    }
+    return (float)tile->nectar_fx / (float)HEX_NECTAR_UNITS_PER_UL;
+}
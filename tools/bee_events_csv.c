@@ -0,0 +1,116 @@
+// Converts a binary colony event stream (see include/event_stream.h) to CSV.
+// Usage: bee_events_csv <events.bin> [out.csv]   (stdout when out is omitted)
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bee.h"
+#include "event_stream.h"
+
+#define CSV_READ_BATCH 4096u
+
+static const char *csv_mode_name(uint8_t mode) {
+    switch (mode) {
+        case BEE_MODE_IDLE: return "idle";
+        case BEE_MODE_OUTBOUND: return "outbound";
+        case BEE_MODE_FORAGING: return "foraging";
+        case BEE_MODE_RETURNING: return "returning";
+        case BEE_MODE_ENTERING: return "entering";
+        case BEE_MODE_UNLOADING: return "unloading";
+        default: return "unknown";
+    }
+}
+
+static const char *csv_role_name(uint8_t role) {
+    switch (role) {
+        case BEE_ROLE_QUEEN: return "queen";
+        case BEE_ROLE_NURSE: return "nurse";
+        case BEE_ROLE_HOUSEKEEPER: return "housekeeper";
+        case BEE_ROLE_STORAGE: return "storage";
+        case BEE_ROLE_FORAGER: return "forager";
+        case BEE_ROLE_SCOUT: return "scout";
+        case BEE_ROLE_GUARD: return "guard";
+        default: return "unknown";
+    }
+}
+
+static void csv_write_record(FILE *out, const BeeEventRecord *rec, double tick_dt_sec) {
+    const char *prev = "";
+    const char *next = "";
+    if (rec->type == BEE_EVENT_ROLE) {
+        prev = csv_role_name(rec->prev);
+        next = csv_role_name(rec->next);
+    } else {
+        prev = csv_mode_name(rec->prev);
+        next = csv_mode_name(rec->next);
+    }
+    fprintf(out, "%llu,%.6f,%u,%s,%s,%s,%s,%d,%.6g,%.3f,%.3f\n",
+            (unsigned long long)rec->tick,
+            (double)rec->tick * tick_dt_sec,
+            (unsigned)rec->bee,
+            bee_event_type_name(rec->type),
+            prev,
+            next,
+            csv_role_name(rec->role),
+            (int)rec->patch_id,
+            (double)rec->value,
+            (double)rec->x,
+            (double)rec->y);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "usage: %s <events.bin> [out.csv]\n", argv[0]);
+        return 2;
+    }
+
+    FILE *in = fopen(argv[1], "rb");
+    if (!in) {
+        fprintf(stderr, "bee_events_csv: cannot open '%s'\n", argv[1]);
+        return 1;
+    }
+
+    BeeEventFileHeader header;
+    if (fread(&header, sizeof(header), 1, in) != 1 ||
+        memcmp(header.magic, BEE_EVENT_MAGIC, sizeof(BEE_EVENT_MAGIC)) != 0) {
+        fprintf(stderr, "bee_events_csv: '%s' is not an event stream\n", argv[1]);
+        fclose(in);
+        return 1;
+    }
+    if (header.version != BEE_EVENT_VERSION || header.record_size != sizeof(BeeEventRecord)) {
+        fprintf(stderr, "bee_events_csv: unsupported version %u / record size %u\n",
+                header.version, header.record_size);
+        fclose(in);
+        return 1;
+    }
+
+    FILE *out = stdout;
+    if (argc == 3) {
+        out = fopen(argv[2], "w");
+        if (!out) {
+            fprintf(stderr, "bee_events_csv: cannot open '%s' for writing\n", argv[2]);
+            fclose(in);
+            return 1;
+        }
+    }
+
+    fprintf(out, "tick,time_s,bee,type,prev,next,role,patch_id,value,x,y\n");
+
+    static BeeEventRecord batch[CSV_READ_BATCH];
+    unsigned long long total = 0;
+    size_t got = 0;
+    while ((got = fread(batch, sizeof(BeeEventRecord), CSV_READ_BATCH, in)) > 0) {
+        for (size_t i = 0; i < got; ++i) {
+            csv_write_record(out, &batch[i], header.tick_dt_sec);
+        }
+        total += got;
+    }
+
+    fclose(in);
+    if (out != stdout) {
+        fclose(out);
+    }
+    fprintf(stderr, "bee_events_csv: %llu records (mask=0x%x seed=0x%llx)\n",
+            total, header.mask, (unsigned long long)header.seed);
+    return 0;
+}